@@ -144,7 +144,7 @@ static page_t* btr_page_alloc_for_ibuf(dict_tree_t* tree, mtr_t* mtr)
 }
 
 /*B-TREEϷҳռ*/
-page_t* btr_page_alloc(dict_index_t* tree, ulint hint_page_no, byte file_direction, ulint level, mtr_t* mtr)
+page_t* btr_page_alloc(dict_tree_t* tree, ulint hint_page_no, byte file_direction, ulint level, mtr_t* mtr)
 {
 	fseg_header_t*	seg_header;
 	page_t*		root;
@@ -91,7 +91,7 @@ byte*							btr_parse_page_reorganize(byte* ptr, byte* end_ptr, page_t* page, mt
 
 ulint							btr_get_size(dict_index_t* index, ulint flag);
 
-page_t*							btr_page_alloc(dict_index_t* tree, ulint hint_page_no, byte file_direction, ulint level, mtr_t* mtr);
+page_t*							btr_page_alloc(dict_tree_t* tree, ulint hint_page_no, byte file_direction, ulint level, mtr_t* mtr);
 
 void							btr_page_free(dict_index_t* tree, page_t* page, mtr_t* mtr);
 
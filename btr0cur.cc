@@ -130,7 +130,7 @@ void btr_cur_search_to_nth_level(dict_index_t* index, ulint level, dtuple_t* tup
 #endif
 
 	/*Ӧhashҵ˶Ӧļ¼*/
-	if (btr_search_latch.writer == RW_LOCK_NOT_LOCKED
+	if (rw_lock_get_writer(btr_search_get_latch(index)) == RW_LOCK_NOT_LOCKED
 		&& latch_mode <= BTR_MODIFY_LEAF && info->last_hash_succ
 		&& !estimate
 		&& btr_search_guess_on_hash(index, info, tuple, mode, latch_mode, cursor, has_search_latch, mtr)) {
@@ -146,7 +146,7 @@ void btr_cur_search_to_nth_level(dict_index_t* index, ulint level, dtuple_t* tup
 	btr_cur_n_sea ++;
 
 	if(has_search_latch)
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(btr_search_get_latch(index));
 
 	/*һmini transcationı㣬Աmtr rollback*/
 	savepoint = mtr_set_savepoint(mtr);
@@ -265,7 +265,7 @@ retry_page_get:
 	}
 
 	if(has_search_latch)
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(btr_search_get_latch(index));
 }
 
 /*btree cursorλindexΧĿʼĩβfrom_left = TRUEʾλǰ*/
@@ -836,7 +836,7 @@ ulint btr_cur_update_in_place(ulint flags, btr_cur_t* cursor, upd_t* update, uli
 		if (row_upd_changes_ord_field_binary(NULL, index, update)) 
 			btr_search_update_hash_on_delete(cursor);
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(btr_search_get_latch(index));
 	}
 
 	if(!(flags & BTR_KEEP_SYS_FLAG))
@@ -847,7 +847,7 @@ ulint btr_cur_update_in_place(ulint flags, btr_cur_t* cursor, upd_t* update, uli
 	row_upd_rec_in_place(rec, update);
 
 	if(block->is_hashed)
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(index));
 
 	btr_cur_update_in_place_log(flags, rec, index, update, trx, roll_ptr, mtr);
 
@@ -1278,18 +1278,18 @@ ulint btr_cur_del_mark_set_clust_rec(ulint flags, btr_cur_t* cursor, ibool val,
 	block = buf_block_align(rec);
 
 	if(block->is_hashed)
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(btr_search_get_latch(index));
 
 	/*Լ¼ɾʶ*/
 	rec_set_deleted_flag(rec, val);
 
 	trx = thr_get_trx(thr);
 	if(!(flags & BTR_KEEP_SYS_FLAG)){
-		row_upd_rec_sys_fields(&btr_search_latch);
+		row_upd_rec_sys_fields(rec, index, trx, roll_ptr);
 	}
 
 	if(block->is_hashed)
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(index));
 
 	/*¼redo log־*/
 	btr_cur_del_mark_set_clust_rec_log(flags, rec, index, val, trx, roll_ptr, mtr);
@@ -1363,12 +1363,12 @@ ulint btr_cur_del_mark_set_sec_rec(ulint flags, btr_cur_t* cursor, ibool val, qu
 	block = buf_block_align(rec);
 
 	if(block->is_hashed)
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(btr_search_get_latch(cursor->index));
 
 	rec_set_deleted_flag(rec, val);
 
 	if(block->is_hashed)
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(btr_search_get_latch(cursor->index));
 
 	btr_cur_del_mark_set_sec_rec_log(rec, val, mtr);
 
@@ -1647,6 +1647,7 @@ void btr_estimate_number_of_different_key_vals(dict_index_t* index)
 	btr_cur_t	cursor;
 	page_t*		page;
 	rec_t*		rec;
+	rec_t*		next_rec;
 	ulint		n_cols;
 	ulint		matched_fields;
 	ulint		matched_bytes;
@@ -1657,6 +1658,10 @@ void btr_estimate_number_of_different_key_vals(dict_index_t* index)
 	ulint		j;
 	ulint		add_on;
 	mtr_t		mtr;
+	mem_heap_t*	heap		= NULL;
+	ulint*		offsets_rec	= NULL;
+	ulint*		offsets_next_rec = NULL;
+	ulint*		offsets_tmp;
 
 	/*е*/
 	n_cols = dict_index_get_n_unique(index);
@@ -1673,20 +1678,31 @@ void btr_estimate_number_of_different_key_vals(dict_index_t* index)
 		rec = page_get_infimum_rec(page);
 		rec = page_rec_get_next(rec);
 
-		if(rec != page_get_supremum_rec(page))
+		if(rec != page_get_supremum_rec(page)){
 			not_empty_flag = 1;
+			/*ֻȽǰn_cols*/
+			offsets_rec = rec_get_offsets(rec, n_cols, offsets_rec, &heap);
+		}
 
 		while(rec != page_get_supremum_rec(page) && page_rec_get_next(rec) != page_get_supremum_rec(page)){
 			matched_fields = 0;
 			matched_bytes = 0;
 
-			cmp_rec_rec_with_match(rec, page_rec_get_next(rec), index, &matched_fields, &matched_bytes);
+			next_rec = page_rec_get_next(rec);
+			offsets_next_rec = rec_get_offsets(next_rec, n_cols, offsets_next_rec, &heap);
+
+			cmp_rec_rec_with_match(rec, next_rec, offsets_rec, offsets_next_rec, index, &matched_fields, &matched_bytes);
 			for (j = matched_fields + 1; j <= n_cols; j++)
 				n_diff[j]++;
 
 			total_external_size += btr_rec_get_externally_stored_len(rec);
 
-			rec = page_rec_get_next(rec);
+			/*next_recƫһΪrecƫ,ٽһ*/
+			offsets_tmp = offsets_rec;
+			offsets_rec = offsets_next_rec;
+			offsets_next_rec = offsets_tmp;
+
+			rec = next_rec;
 		}
 
 		total_external_size += btr_rec_get_externally_stored_len(rec);
@@ -1706,6 +1722,9 @@ void btr_estimate_number_of_different_key_vals(dict_index_t* index)
 	}
 
 	mem_free(n_diff);
+
+	if(heap != NULL)
+		mem_heap_free(heap);
 }
 
 /*recռõҳ*/
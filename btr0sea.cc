@@ -11,9 +11,9 @@
 ulint		btr_search_n_succ	= 0;
 ulint		btr_search_n_hash_fail	= 0;
 
-/*Ϊbtr_search_latch_tempbtr_search_sysƵã䣬ΪCPU cachebtr_search_latch_temp*/
+/*Ϊbtr_search_latchesbtr_search_sysƵã䣬ΪCPU cachebtr_search_latches*/
 byte		btr_sea_pad1[64];
-rw_lock_t*	btr_search_latch_temp;
+rw_lock_t*	btr_search_latches;
 
 /*䣬ΪCPU cachebtr_search_sys*/
 byte		btr_sea_pad2[64];
@@ -26,43 +26,76 @@ btr_search_sys_t*	btr_search_sys;
 
 static void btr_search_build_page_hash_index(page_t* page, ulint n_fields, ulint n_bytes, ulint side);
 
-/*tableheapǷппռ䣬ûдibufлȡµ*/
-static void btr_search_check_free_space_in_heap(void)
+/*tree_idڷhash tableheapǷппռ䣬ûдibufлȡµ*/
+static void btr_search_check_free_space_in_heap(dulint tree_id)
 {
 	buf_frame_t*	frame;
 	hash_table_t*	table;
 	mem_heap_t*		heap;
+	rw_lock_t*		latch;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED) && !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	latch = btr_search_get_latch_by_id(tree_id);
 
-	table = btr_search_sys->hash_index;
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED) && !rw_lock_own(latch, RW_LOCK_EX));
+
+	table = btr_search_get_hash_index(tree_id);
 	heap = table->heap;
 
 	if(heap->free_block == NULL){
 		frame = buf_frame_alloc(); /*֮free_block =пܻڴй¶*/
 
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 
 		if(heap->free_block == NULL)
 			heap->free_block = frame;
 		else /*buf_frame_allocrw_lock_x_lockпfree_blockֵı*/
 			buf_frame_free(frame);
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 }
 
-/*ȫֵӦhashĶ󣬰һrw_lockhash table*/
-void btr_search_sys_create(ulint hash_size)
+/*ȫֵӦhashĶ󣬰index idֳn_partsÿһrw_lockhash table*/
+void btr_search_sys_create(ulint hash_size, ulint n_parts)
 {
-	btr_search_latch_temp = mem_alloc(sizeof(rw_lock_t));
+	ulint i;
+
+	ut_a(n_parts > 0 && n_parts <= BTR_SEARCH_MAX_PARTS);
+
+	btr_search_latches = mem_alloc(n_parts * sizeof(rw_lock_t));
 
-	rw_lock_create(&btr_search_latch);
-	/*ӦHASH*/
 	btr_search_sys = mem_alloc(sizeof(btr_search_sys_t));
-	btr_search_sys->hash_index = ha_create(TRUE, hash_size, 0, 0);
+	btr_search_sys->n_parts = n_parts;
+	btr_search_sys->hash_index = mem_alloc(n_parts * sizeof(hash_table_t*));
+	btr_search_sys->n_hash_succ = mem_alloc(n_parts * sizeof(ulint));
+	btr_search_sys->n_hash_fail = mem_alloc(n_parts * sizeof(ulint));
+
+	for(i = 0; i < n_parts; i ++){
+		rw_lock_create(btr_search_latches + i);
+		rw_lock_set_level(btr_search_latches + i, SYNC_SEARCH_SYS);
+
+		/*ӦHASH,hashͰƽ䵽*/
+		btr_search_sys->hash_index[i] = ha_create(TRUE, hash_size / n_parts + 1, 0, 0);
+		btr_search_sys->n_hash_succ[i] = 0;
+		btr_search_sys->n_hash_fail[i] = 0;
+	}
+}
+
+/*зx-latch,validate밴ŵ˳,sync_thread_add_levelֻ˳ͬʱжlatch*/
+void btr_search_x_lock_all()
+{
+	ulint i;
 
-	rw_lock_set_level(&btr_search_latch, SYNC_SEARCH_SYS);
+	for(i = 0; i < btr_search_sys->n_parts; i ++)
+		rw_lock_x_lock(btr_search_latches + i);
+}
+
+void btr_search_x_unlock_all()
+{
+	ulint i;
+
+	for(i = 0; i < btr_search_sys->n_parts; i ++)
+		rw_lock_x_unlock(btr_search_latches + i);
 }
 
 /*ʼһbtr_search_t*/
@@ -103,9 +136,10 @@ static void btr_search_info_update_hash(btr_search_t* info, btr_cur_t* cursor)
 	ulint			n_unique;
 	int				cmp;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED) && !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
-
 	index = cursor->index;
+
+	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_SHARED) && !rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
+
 	if(index->type & DICT_IBUF)
 		return ;
 
@@ -173,7 +207,8 @@ set_new_recomm:
 /*ӦHASHɹ󣬸¶Ӧibuf blockе״̬Ϣ*/
 static ibool btr_search_update_block_hash_info(btr_search_t* info, buf_block_t* block, btr_cur_t* cursor)
 {
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED) && !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(btr_search_get_latch(cursor->index), RW_LOCK_SHARED)
+		&& !rw_lock_own(btr_search_get_latch(cursor->index), RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED) || rw_lock_own(&(block->lock), RW_LOCK_EX));
 	ut_ad(cursor);
 
@@ -214,7 +249,7 @@ static void btr_search_update_hash_ref(btr_search_t* info, buf_block_t* block, b
 	dulint	tree_id;
 
 	ut_ad(cursor->flag == BTR_CUR_HASH_FAIL);
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(rw_lock_own(btr_search_get_latch(cursor->index), RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED) || rw_lock_own(&(block->lock), RW_LOCK_EX));
 
 	/*жǷǿΪhashϢ*/
@@ -228,9 +263,8 @@ static void btr_search_update_hash_ref(btr_search_t* info, buf_block_t* block, b
 			tree_id = cursor->index->tree->id;
 
 			fold = rec_fold(rec, block->curr_n_fields, block->curr_n_bytes, tree_id);
-			ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_EX));
-			/*뵽hash*/
-			ha_insert_for_fold(btr_search_sys->hash_index, fold, rec);
+			/*뵽tree_idڷhash*/
+			ha_insert_for_fold(btr_search_get_hash_index(tree_id), fold, rec);
 	}
 }
 
@@ -239,8 +273,11 @@ void btr_search_info_update_slow(btr_search_t* info, btr_cur_t* cursor)
 {
 	buf_block_t*	block;
 	ibool			build_index;
+	rw_lock_t*		latch;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED) && !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	latch = btr_search_get_latch(cursor->index);
+
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED) && !rw_lock_own(latch, RW_LOCK_EX));
 
 	block = buf_block_align(btr_cur_get_rec(cursor));
 	/*btr_search_t״̬Ϣ*/
@@ -249,15 +286,15 @@ void btr_search_info_update_slow(btr_search_t* info, btr_cur_t* cursor)
 	/*жǷΪλõԭҪؽhash */
 	build_index = btr_search_update_block_hash_info(info, block, cursor);
 	if(build_index || cursor->flag == BTR_CUR_HASH_FAIL) /*Խhashڴռ*/
-		btr_search_check_free_space_in_heap();
+		btr_search_check_free_space_in_heap(cursor->index->tree->id);
 
 	if(cursor->flag == BTR_CUR_HASH_FAIL){
 		btr_search_n_hash_fail++;
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 		/*뵽hash*/
 		btr_search_update_hash_ref(info, block, cursor);
 
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 	}
 
 	if(build_index)
@@ -275,6 +312,12 @@ static ibool btr_search_check_guess(btr_cur_t* cursor, ibool can_only_compare_to
 	ulint	match;
 	ulint	bytes;
 	int		cmp;
+	ibool	success		= FALSE;
+	mem_heap_t*	heap	= NULL;
+	ulint	offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*	offsets		= offsets_;
+
+	rec_offs_init(offsets_);
 
 	n_unique = dict_index_get_n_unique_in_tree(cursor->index);
 
@@ -285,32 +328,35 @@ static ibool btr_search_check_guess(btr_cur_t* cursor, ibool can_only_compare_to
 
 	match = 0;
 	bytes = 0;
-	cmp = page_cmp_dtuple_rec_with_match(tuple, rec, &match, &bytes);
+	offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(tuple), offsets, &heap);
+	cmp = page_cmp_dtuple_rec_with_match(tuple, rec, offsets, &match, &bytes);
 	if(mode == PAGE_CUR_GE){ /*>=, rectupleߣȷ*/
 		if(cmp == 1)
-			return FALSE;
+			goto exit_func;
 
 		cursor->up_match = match;
-		if(match >= n_unique)
-			return TRUE;
+		if(match >= n_unique){
+			success = TRUE;
+			goto exit_func;
+		}
 	}
 	else if(mode == PAGE_CUR_LE){/*<=, rectupleұߣȷ*/
 		if(cmp == -1)
-			return FALSE;
+			goto exit_func;
 
 		cursor->low_match = match;
 	}
 	else if(mode == PAGE_CUR_G){
 		if(cmp != -1)
-			return FALSE;
+			goto exit_func;
 	}
 	else if(mode == PAGE_CUR_L){
 		if(cmp != 1)
-			return FALSE;
+			goto exit_func;
 	}
 
 	if (can_only_compare_to_cursor_rec)
-		return(FALSE);
+		goto exit_func;
 
 	match = 0;
 	bytes = 0;
@@ -319,24 +365,20 @@ static ibool btr_search_check_guess(btr_cur_t* cursor, ibool can_only_compare_to
 
 		prev_rec = page_rec_get_prev(rec);
 		if(prev_rec == page_get_infimum_rec(page)){ 
-			if(btr_page_get_prev(page, mtr) != FIL_NULL)/*btreeʼλ*/
-				return FALSE;
-
-			return TRUE;
+			/*btreeʼλ*/
+			success = (btr_page_get_prev(page, mtr) == FIL_NULL);
+			goto exit_func;
 		}
 
 		/*ǰһ¼бȽ,tupleСprev_rec,˵λûǲ*/
-		cmp = page_cmp_dtuple_rec_with_match(tuple, prev_rec, &match, &bytes);
-		if(mode == PAGE_CUR_GE){
-			if(cmp != 1)
-				return FALSE;
-		}
-		else{ 
-			if(cmp == -1)
-				return FALSE;
-		}
+		offsets = rec_get_offsets(prev_rec, dtuple_get_n_fields_cmp(tuple), offsets, &heap);
+		cmp = page_cmp_dtuple_rec_with_match(tuple, prev_rec, offsets, &match, &bytes);
+		if(mode == PAGE_CUR_GE)
+			success = (cmp == 1);
+		else
+			success = (cmp != -1);
 
-		return TRUE;
+		goto exit_func;
 	}
 
 	ut_ad(rec != page_get_supremum_rec(page));
@@ -345,24 +387,31 @@ static ibool btr_search_check_guess(btr_cur_t* cursor, ibool can_only_compare_to
 	if (next_rec == page_get_supremum_rec(page)) {
 		if (btr_page_get_next(page, mtr) == FIL_NULL) {
 			cursor->up_match = 0;
-			return(TRUE);
+			success = TRUE;
 		}
 
-		return(FALSE);
+		goto exit_func;
 	}
 
-	cmp = page_cmp_dtuple_rec_with_match(tuple, next_rec, &match, &bytes);
+	offsets = rec_get_offsets(next_rec, dtuple_get_n_fields_cmp(tuple), offsets, &heap);
+	cmp = page_cmp_dtuple_rec_with_match(tuple, next_rec, offsets, &match, &bytes);
 	if (mode == PAGE_CUR_LE) {
 		if (cmp != -1) 
-			return(FALSE);
+			goto exit_func;
 
 		cursor->up_match = match;
 	} else {
 		if (cmp == 1)
-			return(FALSE);
+			goto exit_func;
 	}
 
-	return TRUE;
+	success = TRUE;
+
+exit_func:
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return success;
 }
 
 /*ͨtupleϢhashвҶӦָļ¼btree cursorָҵļ¼*/
@@ -376,6 +425,8 @@ ibool btr_search_guess_on_hash(dict_index_t* index, btr_search_t* info, dtuple_t
 	ulint		fold;
 	ulint		tuple_n_fields;
 	dulint		tree_id;
+	ulint		part_no;
+	rw_lock_t*	latch;
 	ibool       can_only_compare_to_cursor_rec = TRUE;
 
 	ut_ad(index && info && tuple && cursor && mtr);
@@ -395,22 +446,24 @@ ibool btr_search_guess_on_hash(dict_index_t* index, btr_search_t* info, dtuple_t
 		return FALSE;
 
 	tree_id = index->tree->id;
+	part_no = btr_search_get_part_no(tree_id);
+	latch = btr_search_latches + part_no;
 	/*hash*/
 	fold = dtuple_fold(tuple, cursor->n_fields, cursor->n_bytes, tree_id);
 	cursor->fold = fold;
 	cursor->flag = BTR_CUR_HASH;
 
 	if(!has_search_latch)
-		rw_lock_s_lock(&btr_search_latch);
+		rw_lock_s_lock(latch);
 
-	ut_a(btr_search_latch.writer != RW_LOCK_EX);
-	ut_a(btr_search_latch.reader_count > 0);
+	ut_a(rw_lock_get_writer(latch) != RW_LOCK_EX);
+	ut_a(rw_lock_get_reader_count(latch) > 0);
 
-	/*hashͨȡӦļ¼ָ*/
-	rec = ha_search_and_get_data(btr_search_sys->hash_index, fold);
+	/*ӷhashͨȡӦļ¼ָ*/
+	rec = ha_search_and_get_data(btr_search_sys->hash_index[part_no], fold);
 	if (!rec) {
 		if (!has_search_latch)
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(latch);
 
 		goto failure;
 	}
@@ -418,7 +471,7 @@ ibool btr_search_guess_on_hash(dict_index_t* index, btr_search_t* info, dtuple_t
 	page = buf_frame_align(rec);
 	if(!has_search_latch){ /*¼У*/
 		success = buf_page_get_known_nowait(latch_mode, page, BUF_MAKE_YOUNG, __FILE__, __LINE__, mtr);
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 		if(!success)
 			goto failure;
 
@@ -465,12 +518,14 @@ ibool btr_search_guess_on_hash(dict_index_t* index, btr_search_t* info, dtuple_t
 	if (!has_search_latch && buf_block_peek_if_too_old(block))
 		buf_page_make_young(page);
 
-	buf_pool->n_page_gets ++;
-	
+	buf_pool_from_block(block)->n_page_gets ++;
+	btr_search_sys->n_hash_succ[part_no] ++;
+
 	return TRUE;
 
 failure:
 	info->n_hash_fail ++;
+	btr_search_sys->n_hash_fail[part_no] ++;
 	cursor->flag = BTR_CUR_HASH_FAIL;
 
 	return FALSE;
@@ -492,18 +547,23 @@ void btr_search_drop_page_hash_index(page_t* page)
 	ulint		n_recs;
 	ulint*		folds;
 	ulint		i;
+	rw_lock_t*	latch;
+
+	/*pageindexhashڵķ*/
+	tree_id = btr_page_get_index_id(page);
+	latch = btr_search_get_latch_by_id(tree_id);
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED) && !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_SHARED) && !rw_lock_own(latch, RW_LOCK_EX));
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 
 	block = buf_block_align(page);
 	if(!block->is_hashed){ /*blockûκhashӦϵ*/
-		rw_lock_s_unlock(&btr_search_latch);
-		return 0;
+		rw_lock_s_unlock(latch);
+		return;
 	}
 
-	table = btr_search_sys->hash_index;
+	table = btr_search_get_hash_index(tree_id);
 
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED) || rw_lock_own(&(block->lock), RW_LOCK_EX) || (block->buf_fix_count == 0));
 
@@ -512,7 +572,7 @@ void btr_search_drop_page_hash_index(page_t* page)
 
 	ut_a(n_fields + n_bytes > 0);
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 
 	n_recs = page_get_n_recs(page);
 
@@ -529,8 +589,6 @@ void btr_search_drop_page_hash_index(page_t* page)
 			ut_a(n_fields < rec_get_n_fields(rec));
 	}
 
-	tree_id = btr_page_get_index_id(page);
-
 	prev_fold = 0;
 	/*ÿ¼fold hash,folds*/
 	while(rec != sup){
@@ -547,13 +605,13 @@ next_rec:
 	}
 
 	/*foldsеhashֵδhashɾ*/
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 
 	for(i = 0; i < n_cached; i ++)
 		ha_remove_all_nodes_to_page(table, folds[i], page);
 	block->is_hashed = FALSE;
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 
 	/*ͷʱ洢folds*/
 	mem_free(folds);
@@ -598,24 +656,27 @@ static void btr_search_build_page_hash_index(page_t* page, ulint n_fields, ulint
 	ulint*		folds;
 	rec_t**		recs;
 	ulint		i;
+	rw_lock_t*	latch;
 
 	block = buf_block_align(page);
-	/*ȫֵhash*/
-	table = btr_search_sys->hash_index;
+	/*pageindexhash*/
+	tree_id = btr_page_get_index_id(page);
+	table = btr_search_get_hash_index(tree_id);
+	latch = btr_search_get_latch_by_id(tree_id);
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(latch, RW_LOCK_EX));
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_SHARED) || rw_lock_own(&(block->lock), RW_LOCK_EX));
 
-	rw_lock_s_lock(&btr_search_latch);
+	rw_lock_s_lock(latch);
 
 	/*¼вƥеhashҪpageм¼hashɾ*/
 	if (block->is_hashed && ((block->curr_n_fields != n_fields)
 		|| (block->curr_n_bytes != n_bytes) || (block->curr_side != side))){
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(latch);
 			btr_search_drop_page_hash_index(page);
 	}
 	else
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 
 	/*ҳûû¼*/
 	n_recs = page_get_n_recs(page);
@@ -631,8 +692,6 @@ static void btr_search_build_page_hash_index(page_t* page, ulint n_fields, ulint
 
 	n_cached = 0;
 
-	tree_id = btr_page_get_index_id(page);
-
 	sup = page_get_supremum_rec(page);
 
 	rec = page_get_infimum_rec(page);
@@ -687,12 +746,12 @@ static void btr_search_build_page_hash_index(page_t* page, ulint n_fields, ulint
 	}
 
 	/*hashҪڴռ*/
-	btr_search_check_free_space_in_heap();
+	btr_search_check_free_space_in_heap(tree_id);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(latch);
 	/*Ѿбеhashˣֻз*/
 	if(block->is_hashed && ((block->curr_n_fields != n_fields) || (block->curr_n_bytes != n_bytes) || (block->curr_side != side))){
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(latch);
 			mem_free(folds);
 			mem_free(recs);
 			return;
@@ -709,7 +768,7 @@ static void btr_search_build_page_hash_index(page_t* page, ulint n_fields, ulint
 	for(i = 0; i < n_cached; i ++)
 		ha_insert_for_fold(table, folds[i], recs[i]);
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(latch);
 
 	mem_free(folds);
 	mem_free(recs);
@@ -723,17 +782,21 @@ void btr_search_move_or_delete_hash_entries(page_t* new_page, page_t* page)
 	ulint			n_fields;
 	ulint			n_bytes;
 	ulint			side;
+	rw_lock_t*		latch;
 
 	block = buf_block_align(page);
 	new_block = buf_block_align(new_page);
 
 	ut_ad(rw_lock_own(&(block->lock), RW_LOCK_EX) && rw_lock_own(&(new_block->lock), RW_LOCK_EX));
 
-	rw_lock_s_lock(&btr_search_latch);
+	/*ҳͬһindex,ͬһ*/
+	latch = btr_search_get_latch_by_id(btr_page_get_index_id(page));
+
+	rw_lock_s_lock(latch);
 
 	/*ɾеhash*/
 	if(new_block->is_hashed){
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(latch);
 		btr_search_drop_page_hash_index(page);
 
 		return;
@@ -747,8 +810,8 @@ void btr_search_move_or_delete_hash_entries(page_t* new_page, page_t* page)
 		new_block->n_fields = block->curr_n_fields;
 		new_block->n_bytes = block->curr_n_bytes;
 		new_block->side = block->curr_side;
-		
-		rw_lock_s_unlock(&btr_search_latch);
+
+		rw_lock_s_unlock(latch);
 
 		ut_a(n_fields + n_bytes > 0);
 
@@ -762,7 +825,7 @@ void btr_search_move_or_delete_hash_entries(page_t* new_page, page_t* page)
 		return ;
 	}
 
-	rw_lock_s_unlock(&btr_search_latch);
+	rw_lock_s_unlock(latch);
 }
 
 /*¼ɾhash*/
@@ -785,16 +848,16 @@ void btr_search_update_hash_on_delete(btr_cur_t* cursor)
 
 	ut_a(block->curr_n_fields + block->curr_n_bytes > 0);
 
-	table = btr_search_sys->hash_index;
-	tree_id = cursor->index->tree_id;
+	tree_id = cursor->index->tree->id;
+	table = btr_search_get_hash_index(tree_id);
 
 	fold = rec_fold(rec, block->curr_n_fields, block->curr_n_bytes, tree_id);
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(btr_search_get_latch_by_id(tree_id));
 	/*hashɾ*/
 	found = ha_search_and_delete_if_found(table, fold, rec);
 
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(btr_search_get_latch_by_id(tree_id));
 }
 
 void btr_search_update_hash_node_on_insert(btr_cur_t* cursor)
@@ -802,6 +865,7 @@ void btr_search_update_hash_node_on_insert(btr_cur_t* cursor)
 	hash_table_t*	table;
 	buf_block_t*	block;
 	rec_t*			rec;
+	rw_lock_t*		latch;
 
 	rec = btr_cur_get_rec(cursor);
 	block = buf_block_align(rec);
@@ -810,17 +874,19 @@ void btr_search_update_hash_node_on_insert(btr_cur_t* cursor)
 	if(!block->is_hashed)
 		return ;
 
-	rw_lock_x_lock(&btr_search_latch);
+	latch = btr_search_get_latch(cursor->index);
+
+	rw_lock_x_lock(latch);
 	/**/
 	if((cursor->flag == BTR_CUR_HASH) && (cursor->n_fields == block->curr_n_fields)
 		&& (cursor->n_bytes == block->curr_n_bytes) && (block->curr_side == BTR_SEARCH_RIGHT_SIDE)){
-			table = btr_search_sys->hash_index;
+			table = btr_search_get_hash_index(cursor->index->tree->id);
 			/*滻¼ֵָͿ*/
 			ha_search_and_update_if_found(table, cursor->fold, rec, page_rec_get_next(rec));
-			rw_lock_x_unlock(&btr_search_latch);
+			rw_lock_x_unlock(latch);
 	}
 	else{
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 		/*һµhash*/
 		btr_search_update_hash_on_insert(cursor);
 	}
@@ -843,11 +909,15 @@ void btr_search_update_hash_on_insert(btr_cur_t* cursor)
 	ulint		n_bytes;
 	ulint		side;
 	ibool		locked	= FALSE;
+	rw_lock_t*	latch;
 
-	table = btr_search_sys->hash_index;
+	/*ֻҪindexڵķx-latch,ĶӰ*/
+	tree_id = cursor->index->tree->id;
+	table = btr_search_get_hash_index(tree_id);
+	latch = btr_search_get_latch_by_id(tree_id);
+
+	btr_search_check_free_space_in_heap(tree_id);
 
-	btr_search_check_free_space_in_heap();
-	
 	rec = btr_cur_get_rec(cursor);
 	block = buf_block_align(rec);
 
@@ -855,8 +925,6 @@ void btr_search_update_hash_on_insert(btr_cur_t* cursor)
 	if(!block->is_hashed)
 		return ;
 
-	tree_id = cursor->index->tree->id;
-
 	n_fields = block->curr_n_fields;
 	n_bytes = block->curr_n_bytes;
 	side = block->curr_side;
@@ -874,7 +942,7 @@ void btr_search_update_hash_on_insert(btr_cur_t* cursor)
 		fold = rec_fold(rec, n_fields, n_bytes, tree_id);
 	else{
 		if (side == BTR_SEARCH_LEFT_SIDE) {
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			locked = TRUE;
 			ha_insert_for_fold(table, ins_fold, ins_rec);
 		}
@@ -884,7 +952,7 @@ void btr_search_update_hash_on_insert(btr_cur_t* cursor)
 
 	if(fold != ins_fold){
 		if(!locked){
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			locked = TRUE;
 		}
 
@@ -898,7 +966,7 @@ check_next_rec:
 	if (next_rec == page_get_supremum_rec(page)) {
 		if (side == BTR_SEARCH_RIGHT_SIDE) {
 			if (!locked) {
-				rw_lock_x_lock(&btr_search_latch);
+				rw_lock_x_lock(latch);
 				locked = TRUE;
 			}
 
@@ -910,7 +978,7 @@ check_next_rec:
 
 	if(ins_fold != next_fold){
 		if(!locked){
-			rw_lock_x_lock(&btr_search_latch);
+			rw_lock_x_lock(latch);
 			locked = TRUE;
 		}
 		/*ڴ˸»߲¼hash*/
@@ -922,16 +990,33 @@ check_next_rec:
 
 function_exit:
 	if(locked)
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 }
 
-void btr_search_print_info(void)
+/*ӦhashϢhashСhashҳɹʧܵĴ*/
+void btr_search_print_info(char* buf, char* buf_end)
 {
-	printf("SEARCH SYSTEM INFO\n");
+	hash_table_t*	table;
+	ulint			i;
+
+	if(buf_end - buf < 100)
+		return;
+
+	buf += sprintf(buf, "Adaptive hash index partitions %lu\n", btr_search_sys->n_parts);
+
+	for(i = 0; i < btr_search_sys->n_parts; i ++){
+		if(buf_end - buf < 200)
+			return;
 
-	rw_lock_x_lock(&btr_search_latch);
-	/*	ha_print_info(btr_search_sys->hash_index); */
-	rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_s_lock(btr_search_latches + i);
+
+		table = btr_search_sys->hash_index[i];
+		buf += sprintf(buf, "Partition %lu: hash table size %lu, node heap has %lu buffer(s), hash succ %lu, fail %lu\n",
+			i, hash_get_n_cells(table), UT_LIST_GET_LEN(table->heap->base) - 1 + (table->heap->free_block ? 1 : 0),
+			btr_search_sys->n_hash_succ[i], btr_search_sys->n_hash_fail[i]);
+
+		rw_lock_s_unlock(btr_search_latches + i);
+	}
 }
 
 void btr_search_index_print_info(dict_index_t* index)
@@ -940,7 +1025,7 @@ void btr_search_index_print_info(dict_index_t* index)
 
 	printf("INDEX SEARCH INFO\n");
 
-	rw_lock_x_lock(&btr_search_latch);
+	rw_lock_x_lock(btr_search_get_latch(index));
 
 	info = btr_search_get_info(index);
 
@@ -949,7 +1034,7 @@ void btr_search_index_print_info(dict_index_t* index)
 		info->n_patt_succ);
 
 	printf("Total of page cur short succ for all indexes %lu\n", page_cur_short_succ);
-	rw_lock_x_unlock(&btr_search_latch);
+	rw_lock_x_unlock(btr_search_get_latch(index));
 }
 
 void btr_search_table_print_info(char*	name)
@@ -981,12 +1066,17 @@ ibool btr_search_validate(void)
 	ulint		n_page_dumps	= 0;
 	ibool		ok		= TRUE;
 	ulint		i;
+	ulint		j;
+	hash_table_t*	table;
 	char		rec_str[500];
 
-	rw_lock_x_lock(&btr_search_latch);
+	btr_search_x_lock_all();
+
+	for (j = 0; j < btr_search_sys->n_parts; j++) {
+	table = btr_search_sys->hash_index[j];
 
-	for (i = 0; i < hash_get_n_cells(btr_search_sys->hash_index); i++) {
-		node = hash_get_nth_cell(btr_search_sys->hash_index, i)->node;
+	for (i = 0; i < hash_get_n_cells(table); i++) {
+		node = hash_get_nth_cell(table, i)->node;
 
 		while (node != NULL) {
 			block = buf_block_align(node->data);
@@ -1034,12 +1124,13 @@ ibool btr_search_validate(void)
 		}
 	}
 
-	if (!ha_validate(btr_search_sys->hash_index)) {
+	if (!ha_validate(table)) {
 
 		ok = FALSE;
 	}
+	}
 
-	rw_lock_x_unlock(&btr_search_latch);
+	btr_search_x_unlock_all();
 
 	return(ok);
 }
@@ -34,6 +34,9 @@
 
 #define BTR_SEA_TIMEOUT			10000
 
+/*Ӧhash*/
+#define BTR_SEARCH_MAX_PARTS	512
+
 struct btr_search_struct
 {
 	ulint						magic_n;			/*btr_search magic*/
@@ -57,24 +60,39 @@ struct btr_search_struct
 	ulint						n_searches;
 };
 
+/*Ӧhashindex idֳn_partsÿжhashlatch*/
 typedef struct btr_search_sys_struct
 {
-	hash_table_t*				hash_index;
+	ulint						n_parts;			/**/
+	hash_table_t**				hash_index;			/*ÿhash*/
+	ulint*						n_hash_succ;		/*ÿhashҳɹĴ*/
+	ulint*						n_hash_fail;		/*ÿhashʧܵĴ*/
 }btr_search_sys_t;
 
 /*Ӧhashȫֶ*/
 extern btr_search_sys_t*		btr_search_sys;
 
-/*latch*/
-extern rw_lock_t*				btr_search_latch_temp;
-#define btr_search_latch		(*btr_search_latch_temp)
+/*ÿĻlatch鳤Ϊbtr_search_sys->n_parts*/
+extern rw_lock_t*				btr_search_latches;
 /*ͳϢ*/
 extern ulint					btr_search_n_succ;
 extern ulint					btr_search_n_hash_fail;
 
 /***************************function***********************/
 
-void							btr_search_sys_create(ulint hash_size);
+void							btr_search_sys_create(ulint hash_size, ulint n_parts);
+
+UNIV_INLINE ulint				btr_search_get_part_no(dulint tree_id);
+
+UNIV_INLINE rw_lock_t*			btr_search_get_latch_by_id(dulint tree_id);
+
+UNIV_INLINE rw_lock_t*			btr_search_get_latch(dict_index_t* index);
+
+UNIV_INLINE hash_table_t*		btr_search_get_hash_index(dulint tree_id);
+
+void							btr_search_x_lock_all();
+
+void							btr_search_x_unlock_all();
 
 UNIV_INLINE btr_search_t*		btr_search_get_info(dict_index_t* index);
 
@@ -100,7 +118,7 @@ void							btr_search_update_hash_on_insert(btr_cur_t* cursor);
 
 void							btr_search_update_hash_on_delete(btr_cur_t* cursor);
 
-void							btr_search_print_info(void);
+void							btr_search_print_info(char* buf, char* buf_end);
 
 void							btr_search_index_print_info(dict_index_t* index);
 
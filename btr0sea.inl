@@ -4,6 +4,32 @@
 
 void btr_search_info_update_slow(btr_search_t* info, btr_cur_t* cursor);
 
+/*index id(tree id)ڵӦhash*/
+UNIV_INLINE ulint btr_search_get_part_no(dulint tree_id)
+{
+	return ut_dulint_get_low(tree_id) % btr_search_sys->n_parts;
+}
+
+/*tree idڷlatch*/
+UNIV_INLINE rw_lock_t* btr_search_get_latch_by_id(dulint tree_id)
+{
+	return btr_search_latches + btr_search_get_part_no(tree_id);
+}
+
+/*indexڷlatch*/
+UNIV_INLINE rw_lock_t* btr_search_get_latch(dict_index_t* index)
+{
+	ut_ad(index);
+
+	return btr_search_get_latch_by_id(index->tree->id);
+}
+
+/*tree idڷhash*/
+UNIV_INLINE hash_table_t* btr_search_get_hash_index(dulint tree_id)
+{
+	return btr_search_sys->hash_index[btr_search_get_part_no(tree_id)];
+}
+
 /*indexsearch info*/
 UNIV_INLINE btr_search_t* btr_search_get_info(dict_index_t* index)
 {
@@ -17,7 +43,7 @@ UNIV_INLINE void btr_search_info_update(dict_index_t* index, btr_cur_t* cursor)
 {
 	btr_search_t* info;
 
-	ut_ad(!rw_lock_own(&btr_search_latch, RW_LOCK_SHARED) && !rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!rw_lock_own(btr_search_get_latch(index), RW_LOCK_SHARED) && !rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
 
 	info = btr_search_get_info(index);
 	
@@ -9,8 +9,10 @@
 #include "log0recv.h"
 #include "trx0undo.h"
 #include "srv0srv.h"
+#include "ul0crc32.h"
 
-buf_pool_t* buf_pool		= NULL;
+buf_pool_t* buf_pool_ptr		= NULL;
+ulint buf_pool_instances	= 1;
 ulint buf_dbg_counter		= 0;
 ibool buf_debug_prints		= FALSE;
 
@@ -25,16 +27,70 @@ ulint buf_calc_page_checksum(byte* page)
 	return checksum;
 }
 
+/*CRC32Cpagechecksumֵ,ǵķΧbuf_calc_page_checksumͬ*/
+ulint buf_calc_page_crc32(byte* page)
+{
+	ulint checksum;
+
+	checksum = ut_crc32(page, FIL_PAGE_FILE_FLUSH_LSN) ^ ut_crc32(page + FIL_PAGE_DATA, UNIV_PAGE_SIZE - FIL_PAGE_DATA - FIL_PAGE_END_LSN);
+	checksum = checksum & 0xFFFFFFFF;
+
+	return checksum;
+}
+
+/*srv_checksum_algorithmˢʱҪдҳβchecksumֵ*/
+ulint buf_calc_page_checksum_for_write(byte* page)
+{
+	switch(srv_checksum_algorithm){
+	case BUF_CHECKSUM_ALGORITHM_CRC32:
+		return buf_calc_page_crc32(page);
+
+	case BUF_CHECKSUM_ALGORITHM_NONE:
+		return BUF_NO_CHECKSUM_MAGIC;
+	}
+
+	return buf_calc_page_checksum(page);
+}
+
+/*Уҳβŵchecksum,㷨дҳԱʶȰǰõ㷨У,
+ҳֻҪһchecksum*/
+static ibool buf_page_checksum_is_ok(byte* read_buf, ulint stored)
+{
+	if(srv_checksum_algorithm == BUF_CHECKSUM_ALGORITHM_NONE) /*У*/
+		return TRUE;
+
+	if(stored == BUF_NO_CHECKSUM_MAGIC)
+		return TRUE;
+
+	if(srv_checksum_algorithm == BUF_CHECKSUM_ALGORITHM_CRC32){
+		if(stored == buf_calc_page_crc32(read_buf))
+			return TRUE;
+
+		return stored == buf_calc_page_checksum(read_buf);
+	}
+
+	if(stored == buf_calc_page_checksum(read_buf))
+		return TRUE;
+
+	return stored == buf_calc_page_crc32(read_buf);
+}
+
 /*жpageǷ,һǴӴ̽page뻺ʱҪж*/
 ibool buf_page_is_corrupted(byte* read_buf)
 {
-	ulint checksum;
+	ulint stored;
 
-	checksum = buf_calc_page_checksum(read_buf);
-	/*УpageLSNchecksum*/
-	if((mach_read_from_4(read_buf + FIL_PAGE_LSN + 4) != mach_read_from_4(read_buf + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN + 4))
-		|| (checksum != mach_read_from_4(read_buf + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN)
-		&& mach_read_from_4(read_buf + FIL_PAGE_LSN) != mach_read_from_4(read_buf + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN)))
+	/*УpageLSN*/
+	if(mach_read_from_4(read_buf + FIL_PAGE_LSN + 4) != mach_read_from_4(read_buf + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN + 4))
+		return TRUE;
+
+	stored = mach_read_from_4(read_buf + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN);
+	/*ϰ汾дҳchecksumֶδŵLSNĸ4ֽ*/
+	if(stored == mach_read_from_4(read_buf + FIL_PAGE_LSN))
+		return FALSE;
+
+	/*Уpagechecksum*/
+	if(!buf_page_checksum_is_ok(read_buf, stored))
 		return TRUE;
 
 	return FALSE;
@@ -60,8 +116,8 @@ void buf_page_print(byte* read_buf)
 	checksum = buf_calc_page_checksum(read_buf);
 
 	ut_print_timestamp(stderr);
-	fprintf(stderr, "  InnoDB: Page checksum %lu stored checksum %lu\n",
-		checksum, mach_read_from_4(read_buf+ UNIV_PAGE_SIZE - FIL_PAGE_END_LSN)); 
+	fprintf(stderr, "  InnoDB: Page checksum %lu crc32 checksum %lu stored checksum %lu\n",
+		checksum, buf_calc_page_crc32(read_buf), mach_read_from_4(read_buf+ UNIV_PAGE_SIZE - FIL_PAGE_END_LSN)); 
 
 	fprintf(stderr, "InnoDB: Page lsn %lu %lu, low 4 bytes of lsn at page end %lu\n",
 		mach_read_from_4(read_buf + FIL_PAGE_LSN),
@@ -87,11 +143,12 @@ void buf_page_print(byte* read_buf)
 }
 
 /*ʼһbuf_block*/
-static void buf_block_init(buf_block_t* block, byte* frame)
+static void buf_block_init(buf_pool_t* buf_pool, buf_block_t* block, byte* frame)
 {
 	/*ʼ״̬Ϣ*/
 	block->state = BUF_BLOCK_NOT_USED;
 	block->frame = frame;
+	block->buf_pool_index = buf_pool->instance_no;
 	block->modify_clock = ut_dulint_zero;
 	block->file_page_was_freed = FALSE;
 
@@ -106,8 +163,8 @@ static void buf_block_init(buf_block_t* block, byte* frame)
 	rw_lock_set_level(&(block->debug_latch), SYNC_NO_ORDER_CHECK);
 }
 
-/*buf_poot_t*/
-static buf_pool_t* buf_pool_create(ulint max_size, ulint curr_size)
+/*ʼһbuf_pool_tʵ*/
+static buf_pool_t* buf_pool_init_instance(buf_pool_t* buf_pool, ulint instance_no, ulint max_size, ulint curr_size)
 {
 	byte*			frame;
 	ulint			i;
@@ -115,13 +172,13 @@ static buf_pool_t* buf_pool_create(ulint max_size, ulint curr_size)
 
 	ut_a(max_size == curr_size);
 
-	buf_pool = mem_alloc(sizeof(buf_pool_t));
-
 	/*ʼ*/
+	buf_pool->instance_no = instance_no;
+
 	mutex_create(&(buf_pool->mutex));
 	mutex_set_level(&(buf_pool->mutex), SYNC_BUF_POOL);
 
-	mutex_enter(&(uf_pool->mutex));
+	mutex_enter(&(buf_pool->mutex));
 
 	/*һmax_sizepage sizeСڴΪ,+1ΪUNIV_PAGE_SIZE*/
 	buf_pool->frame_mem = ut_malloc(UNIV_PAGE_SIZE * (max_size + 1));
@@ -144,7 +201,7 @@ static buf_pool_t* buf_pool_create(ulint max_size, ulint curr_size)
 	/*blockгʼframe֮Ĺϵ*/
 	for(i = 0; i < max_size; i ++){
 		block = buf_pool_get_nth_block(buf_pool, i);
-		buf_block_init(block, frame);
+		buf_block_init(buf_pool, block, frame);
 		frame = frame + UNIV_PAGE_SIZE;
 	}
 
@@ -162,8 +219,14 @@ static buf_pool_t* buf_pool_create(ulint max_size, ulint curr_size)
 	buf_pool->n_pages_written_old = 0;
 	buf_pool->n_pages_created_old = 0;
 
+	buf_pool->n_ra_pages_read = 0;
+	buf_pool->n_ra_pages_evicted = 0;
+	buf_pool->n_ra_pages_read_old = 0;
+	buf_pool->n_ra_pages_evicted_old = 0;
+
 	/*flush listʼ*/
 	UT_LIST_INIT(buf_pool->flush_list);
+	buf_pool->flush_rbt = NULL;
 	for(i = BUF_FLUSH_LRU; i <= BUF_FLUSH_LIST; i ++){
 		buf_pool->n_flush[i] = 0;
 		buf_pool->init_flush[i] =  FALSE;
@@ -188,31 +251,58 @@ static buf_pool_t* buf_pool_create(ulint max_size, ulint curr_size)
 	}
 
 	mutex_exit(&(buf_pool->mutex));
-	/*ӦHASH,ԻpageΪhashͰ*/
-	btr_search_sys_create(curr_size * UNIV_PAGE_SIZE / sizeof(void*) / 64);
 
 	return buf_pool;
 }
 
 /*ʼأһMYSQLʱ*/
-void buf_pool_init(ulint max_size, ulint curr_size)
+void buf_pool_init(ulint max_size, ulint curr_size, ulint n_instances)
 {
-	ut_a(buf_pool == NULL);
+	ulint	size;
+	ulint	i;
+
+	ut_a(buf_pool_ptr == NULL);
+	ut_a(n_instances > 0 && n_instances <= MAX_BUFFER_POOLS);
+
+	/*ÿʵƽֻصpage*/
+	size = curr_size / n_instances;
+	ut_a(size >= 2 * BUF_LRU_OLD_MIN_LEN);
 
-	buf_pool_create(max_size, curr_size);
+	buf_pool_ptr = mem_alloc(n_instances * sizeof(buf_pool_t));
+	buf_pool_instances = n_instances;
+
+	for(i = 0; i < n_instances; i ++){
+		if(buf_pool_init_instance(buf_pool_from_array(i), i, size, size) == NULL){
+			fprintf(stderr, "InnoDB: Fatal error: cannot allocate memory for buffer pool instance %lu\n", i);
+			ut_a(0);
+		}
+	}
+
+	/*ӦHASH,ԻpageΪhashͰ*/
+	btr_search_sys_create(size * n_instances * UNIV_PAGE_SIZE / sizeof(void*) / 64, srv_adaptive_hash_index_parts);
 
 	ut_ad(buf_validate());
 }
 
 /*һbuf block*/
-UNIV_INLINE buf_block_t* buf_block_alloc()
+UNIV_INLINE buf_block_t* buf_block_alloc(buf_pool_t* buf_pool)
 {
-	return buf_LRU_get_free_block();
+	static ulint	buf_pool_index = 0;
+
+	/*ûָʵӸʵз,ҪȷԲü*/
+	if(buf_pool == NULL){
+		buf_pool = buf_pool_from_array(buf_pool_index % buf_pool_instances);
+		buf_pool_index ++;
+	}
+
+	return buf_LRU_get_free_block(buf_pool);
 }
 
 /*blockold LRU LISTƵyoungУLRU ListĿʼλ*/
 UNIV_INLINE void buf_block_make_young(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	if(buf_pool->freed_page_clock >= block->freed_page_clock + 1 + (buf_pool->curr_size / 1024))
 		buf_LRU_make_block_young(block);
 }
@@ -220,6 +310,8 @@ UNIV_INLINE void buf_block_make_young(buf_block_t* block)
 /*ͷһblock*/
 UNIV_INLINE void buf_block_free(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(block->state != BUF_BLOCK_FILE_PAGE);
 
 	mutex_enter(&(buf_pool->mutex));
@@ -230,7 +322,7 @@ UNIV_INLINE void buf_block_free(buf_block_t* block)
 /*һbuffer frame*/
 buf_frame_t* buf_frame_alloc()
 {
-	return buf_block_alloc()->frame;
+	return buf_block_alloc(NULL)->frame;
 }
 /*ͷһbuffer frame*/
 void buf_frame_free(buf_frame_t* frame)
@@ -241,22 +333,26 @@ void buf_frame_free(buf_frame_t* frame)
 /*ͨspace idpage noλӦbuf_block*/
 buf_block_t* buf_page_peek_block(ulint space, ulint offset)
 {
+	buf_pool_t*	 buf_pool = buf_pool_get(space, offset);
 	buf_block_t* block;
 
 	mutex_enter_fast(&(buf_pool->mutex));
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	mutex_exit(&(buf_pool->mutex));
+
+	return block;
 }
 
 /*ͨspace idpage noҶӦpageǷӦϣ*/
 ibool buf_page_peek_if_search_hashed(ulint space, ulint offset)
 {
+	buf_pool_t*	 buf_pool = buf_pool_get(space, offset);
 	buf_block_t* block;
 	ibool is_hashed;
 
 	mutex_enter_fast(&(buf_pool->mutex));
 	
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	if(block != NULL)
 		is_hashed = FALSE;
 	else
@@ -278,11 +374,12 @@ ibool buf_page_peek(ulint space, ulint offset)
 /*block->file_page_was_freedΪTRUE*/
 buf_block_t* buf_page_set_file_page_was_freed(ulint space, ulint offset)
 {
+	buf_pool_t*	 buf_pool = buf_pool_get(space, offset);
 	buf_block_t* block;
 
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	if(block)
 		block->file_page_was_freed = TRUE;
 
@@ -293,11 +390,12 @@ buf_block_t* buf_page_set_file_page_was_freed(ulint space, ulint offset)
 /*block->file_page_was_freedΪFALSE*/
 buf_block_t* buf_page_reset_file_page_was_freed(ulint space, ulint offset)
 {
+	buf_pool_t*		buf_pool = buf_pool_get(space, offset);
 	buf_block_t*	block;
 
 	mutex_enter_fast(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	if (block) 
 		block->file_page_was_freed = FALSE;
 
@@ -309,6 +407,7 @@ buf_block_t* buf_page_reset_file_page_was_freed(ulint space, ulint offset)
 /*ͨspace idpage noöӦpagebuf_poolеframeַһܻ̿ᴥpageӴ̵뵽buf_pool*/
 buf_frame_t* buf_page_get_gen(ulint space, ulint offset, ulint rw_latch, buf_frame_t* guess, ulint mode, char* file, ulint line, mtr_t* mtr)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ibool		accessed;
 	ulint		fix_type;
@@ -320,6 +419,8 @@ buf_frame_t* buf_page_get_gen(ulint space, ulint offset, ulint rw_latch, buf_fra
 	ut_ad((mode != BUF_GET_NO_LATCH) || (rw_latch == RW_NO_LATCH));
 	ut_ad((mode == BUF_GET) || (mode == BUF_GET_IF_IN_POOL) || (mode == BUF_GET_NO_LATCH) || (mode == BUF_GET_NOWAIT));
 
+	/*ֻҪ(space, offset)ʵmutex*/
+	buf_pool = buf_pool_get(space, offset);
 	buf_pool->n_page_gets ++;
 
 loop:
@@ -329,13 +430,13 @@ loop:
 	if(guess){
 		block = buf_block_align(guess);
 		/*blockͶӦspace idpage noƥ*/
-		if(offset != block->offset || space != block->space || block->state != BUF_BLOCK_FILE_PAGE)
+		if(buf_pool_from_block(block) != buf_pool || offset != block->offset || space != block->space || block->state != BUF_BLOCK_FILE_PAGE)
 			block = NULL;
 	}
 
 	/*buf_pool->hash_table*/
 	if(block == NULL)
-		block = buf_page_hash_get(space, offset);
+		block = buf_page_hash_get(buf_pool, space, offset);
 
 	/*page ڻ*/
 	if(block == NULL){
@@ -419,6 +520,7 @@ loop:
 /*жǷֹ۷ʽ(ǰpageӴ̶ȡ)һpage*/
 ibool buf_page_optimistic_get_func(ulint rw_latch, buf_frame_t* guess, dulint modify_clock, char* file, ulint line, mtr_t* mtr)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ibool		accessed;
 	ibool		success;
@@ -427,9 +529,10 @@ ibool buf_page_optimistic_get_func(ulint rw_latch, buf_frame_t* guess, dulint mo
 	ut_ad(mtr && guess);
 	ut_ad((rw_latch == RW_S_LATCH) || (rw_latch == RW_X_LATCH));
 
-	buf_pool->n_page_gets ++;
-
 	block = buf_block_align(guess);
+	buf_pool = buf_pool_from_block(block);
+
+	buf_pool->n_page_gets ++;
 	
 	mutex_enter(&(buf_pool->mutex));
 
@@ -496,6 +599,7 @@ ibool buf_page_optimistic_get_func(ulint rw_latch, buf_frame_t* guess, dulint mo
 /*жǷnowaitʽһ֪page*/
 ibool buf_page_get_known_nowait(ulint rw_latch, buf_frame_t* guess, ulint mode, char* file, ulint line, mtr_t* mtr)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ibool		success;
 	ulint		fix_type;
@@ -503,8 +607,10 @@ ibool buf_page_get_known_nowait(ulint rw_latch, buf_frame_t* guess, ulint mode,
 	ut_ad(mtr);
 	ut_ad((rw_latch == RW_S_LATCH) || (rw_latch == RW_X_LATCH));
 
-	buf_pool->n_page_gets ++;
 	block = buf_block_align(guess);
+	buf_pool = buf_pool_from_block(block);
+
+	buf_pool->n_page_gets ++;
 
 	mutex_enter(&(buf_pool->mutex));
 	
@@ -566,6 +672,7 @@ void buf_page_init_for_backup_restore(ulint space, ulint offset, buf_block_t* bl
 	block->oldest_modification = ut_dulint_zero;
 
 	block->accessed		= FALSE;
+	block->read_ahead	= FALSE;
 	block->buf_fix_count 	= 0;
 	block->io_fix		= 0;
 
@@ -581,6 +688,10 @@ void buf_page_init_for_backup_restore(ulint space, ulint offset, buf_block_t* bl
 /*ʼһbuffer pool page*/
 static void buf_page_init(ulint space, ulint offset, buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
+	/*blockǴ(space, offset)ʵз*/
+	ut_ad(buf_pool == buf_pool_get(space, offset));
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_READY_FOR_USE);
 
@@ -602,6 +713,7 @@ static void buf_page_init(ulint space, ulint offset, buf_block_t* block)
 	block->oldest_modification = ut_dulint_zero;
 
 	block->accessed		= FALSE;
+	block->read_ahead	= FALSE;
 	block->buf_fix_count 	= 0;
 	block->io_fix		= 0;
 
@@ -625,6 +737,7 @@ a block (the other is buf_page_create).
 **************************************************************************/ 
 buf_block_t* buf_page_init_for_read(ulint mode, ulint space, ulint offset)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	mtr_t			mtr;
 
@@ -643,12 +756,13 @@ buf_block_t* buf_page_init_for_read(ulint mode, ulint space, ulint offset)
 		ut_ad(mode == BUF_READ_ANY_PAGE);
 
 	/*buf poolϷһblock*/
-	block = buf_block_alloc();
+	buf_pool = buf_pool_get(space, offset);
+	block = buf_block_alloc(buf_pool);
 	ut_ad(block);
 
 	mutex_enter(&(buf_pool->mutex));
 	/*ӦhashѾͬһblock,˵pageѾڻ,ֱͷŷ*/
-	if(NULL != buf_page_hash_get(space, offset)){
+	if(NULL != buf_page_hash_get(buf_pool, space, offset)){
 		mutex_exit(&(buf_pool->mutex));
 		buf_block_free(block);
 
@@ -666,7 +780,7 @@ buf_block_t* buf_page_init_for_read(ulint mode, ulint space, ulint offset)
 	buf_LRU_add_block(block, TRUE); 
 
 	block->io_fix = BUF_IO_READ;
-	block->n_pend_reads ++;
+	buf_pool->n_pend_reads ++;
 
 	/*buf_page_io_completeʱὫlockread_lockͷ*/
 	rw_lock_x_lock_gen(&(block->lock), BUF_IO_READ);
@@ -684,13 +798,15 @@ buf_block_t* buf_page_init_for_read(ulint mode, ulint space, ulint offset)
 һǽblock stateNO_USED-->FILE_PAGE,пдҪµpage*/
 buf_frame_t* buf_page_create(ulint space, ulint offset, mtr_t* mtr)
 {
+	buf_pool_t*		buf_pool;
 	buf_frame_t*	frame;
 	buf_block_t*	block;
 	buf_block_t*	free_block	= NULL;
 
 	ut_ad(mtr);
 
-	free_block = buf_LRU_get_free_block();
+	buf_pool = buf_pool_get(space, offset);
+	free_block = buf_LRU_get_free_block(buf_pool);
 
 	/*ibufݼ¼ɾ,ֻǸʼ̣һӴ̵ҳݵĹ
 	Delete possible entries for the page from the insert buffer:
@@ -699,7 +815,7 @@ buf_frame_t* buf_page_create(ulint space, ulint offset, mtr_t* mtr)
 
 	mutex_enter(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	if(block != NULL){
 		block->file_page_was_freed = FALSE;
 		
@@ -738,6 +854,7 @@ buf_frame_t* buf_page_create(ulint space, ulint offset, mtr_t* mtr)
 /*Ӵ϶дһҳ*/
 void buf_page_io_complete(buf_block_t* block)
 {
+	buf_pool_t*		buf_pool;
 	dict_index_t*	index;
 	dulint		id;
 	ulint		io_type;
@@ -745,10 +862,11 @@ void buf_page_io_complete(buf_block_t* block)
 
 	ut_ad(block);
 
+	buf_pool = buf_pool_from_block(block);
 	io_type = block->io_fix;
 	if(io_type == BUF_IO_READ){
 		read_page_no = mach_read_from_4(block->frame + FIL_PAGE_OFFSET);
-		if(read_page_no != 0 && trx_doublewrite_age_inside(read_page_no) && read_page_no != block->offset){
+		if(read_page_no != 0 && !trx_doublewrite_page_inside(read_page_no) && read_page_no != block->offset){
 			fprintf(stderr,"InnoDB: Error: page n:o stored in the page read in is %lu, should be %lu!\n",
 			read_page_no, block->offset);
 		}
@@ -840,22 +958,29 @@ void buf_page_io_complete(buf_block_t* block)
 
 void buf_pool_invalidate(void)
 {
-	ibool	freed;
+	buf_pool_t*	buf_pool;
+	ibool		freed;
+	ulint		i;
 
 	ut_ad(buf_all_freed());
 
-	freed = TRUE;
-	while (freed)
-		freed = buf_LRU_search_and_free_block(0);
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
 
-	mutex_enter(&(buf_pool->mutex));
+		freed = TRUE;
+		while (freed)
+			freed = buf_LRU_search_and_free_block(buf_pool, 0);
 
-	ut_ad(UT_LIST_GET_LEN(buf_pool->LRU) == 0);
+		mutex_enter(&(buf_pool->mutex));
 
-	mutex_exit(&(buf_pool->mutex));
+		ut_ad(UT_LIST_GET_LEN(buf_pool->LRU) == 0);
+
+		mutex_exit(&(buf_pool->mutex));
+	}
 }
 
-ibool buf_validate(void)
+/*һbuffer poolʵĺϷ*/
+static ibool buf_pool_validate_instance(buf_pool_t* buf_pool)
 {
 	buf_block_t*	block;
 	ulint		i;
@@ -876,7 +1001,7 @@ ibool buf_validate(void)
 		block = buf_pool_get_nth_block(buf_pool, i);
 
 		if (block->state == BUF_BLOCK_FILE_PAGE) {
-			ut_a(buf_page_hash_get(block->space, block->offset) == block);
+			ut_a(buf_page_hash_get(buf_pool, block->space, block->offset) == block);
 			n_page++;
 
 			if (block->io_fix == BUF_IO_WRITE) {
@@ -922,13 +1047,23 @@ ibool buf_validate(void)
 
 	mutex_exit(&(buf_pool->mutex));
 
+	return(TRUE);
+}
+
+ibool buf_validate(void)
+{
+	ulint i;
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		ut_a(buf_pool_validate_instance(buf_pool_from_array(i)));
+
 	ut_a(buf_LRU_validate());
 	ut_a(buf_flush_validate());
 
 	return(TRUE);
 }	
 
-void buf_print(void)
+static void buf_print_instance(buf_pool_t* buf_pool)
 {
 	dulint*		index_ids;
 	ulint*		counts;
@@ -942,14 +1077,14 @@ void buf_print(void)
 
 	ut_ad(buf_pool);
 
-	size = buf_pool_get_curr_size() / UNIV_PAGE_SIZE;
+	size = buf_pool->curr_size;
 
 	index_ids = mem_alloc(sizeof(dulint) * size);
 	counts = mem_alloc(sizeof(ulint) * size);
 
 	mutex_enter(&(buf_pool->mutex));
 
-	printf("buf_pool size %lu \n", size);
+	printf("buf_pool instance %lu size %lu \n", buf_pool->instance_no, size);
 	printf("database pages %lu \n", UT_LIST_GET_LEN(buf_pool->LRU));
 	printf("free pages %lu \n", UT_LIST_GET_LEN(buf_pool->free));
 	printf("modified database pages %lu \n", UT_LIST_GET_LEN(buf_pool->flush_list));
@@ -1010,95 +1145,188 @@ void buf_print(void)
 
 	mem_free(index_ids);
 	mem_free(counts);
+}
+
+void buf_print(void)
+{
+	ulint i;
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		buf_print_instance(buf_pool_from_array(i));
 
 	ut_a(buf_validate());
 }
 
 ulint buf_get_n_pending_ios(void)
 {
-	return(buf_pool->n_pend_reads + buf_pool->n_flush[BUF_FLUSH_LRU]
-	+ buf_pool->n_flush[BUF_FLUSH_LIST] + buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]);
+	buf_pool_t*	buf_pool;
+	ulint		n_pending = 0;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+		n_pending += buf_pool->n_pend_reads + buf_pool->n_flush[BUF_FLUSH_LRU]
+			+ buf_pool->n_flush[BUF_FLUSH_LIST] + buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE];
+	}
+
+	return n_pending;
+}
+
+/*ʵܹдpage*/
+ulint buf_pool_get_n_pages_io(void)
+{
+	buf_pool_t*	buf_pool;
+	ulint		n_pages = 0;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+		n_pages += buf_pool->n_pages_read + buf_pool->n_pages_written;
+	}
+
+	return n_pages;
 }
 
 void buf_print_io(char*	buf, char*	buf_end)
 {
+	buf_pool_t*	buf_pool;
 	time_t	current_time;
 	double	time_elapsed;
 	ulint	size;
+	ulint	i;
+	ulint	n_free = 0, n_lru = 0, n_modified = 0, n_pend_reads = 0;
+	ulint	n_flush[BUF_FLUSH_LIST + 1];
+	ulint	n_pages_read = 0, n_pages_created = 0, n_pages_written = 0, n_page_gets = 0;
+	ulint	n_pages_read_old = 0, n_pages_created_old = 0, n_pages_written_old = 0, n_page_gets_old = 0;
+	ulint	n_ra_pages_read = 0, n_ra_pages_evicted = 0, n_ra_pages_read_old = 0, n_ra_pages_evicted_old = 0;
 	
-	ut_ad(buf_pool);
+	ut_ad(buf_pool_ptr);
 
-	if (buf_end - buf < 400)
+	if (buf_end - buf < 500)
 		return;
 
 	size = buf_pool_get_curr_size() / UNIV_PAGE_SIZE;
 
-	mutex_enter(&(buf_pool->mutex));
+	n_flush[BUF_FLUSH_LRU] = n_flush[BUF_FLUSH_SINGLE_PAGE] = n_flush[BUF_FLUSH_LIST] = 0;
+
+	current_time = time(NULL);
+	time_elapsed = 0.001 + difftime(current_time, buf_pool_from_array(0)->last_printout_time);
+
+	/*ʵͳϢ,Ҹλÿʵold*/
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+
+		mutex_enter(&(buf_pool->mutex));
+
+		n_free += UT_LIST_GET_LEN(buf_pool->free);
+		n_lru += UT_LIST_GET_LEN(buf_pool->LRU);
+		n_modified += UT_LIST_GET_LEN(buf_pool->flush_list);
+		n_pend_reads += buf_pool->n_pend_reads;
+
+		n_flush[BUF_FLUSH_LRU] += buf_pool->n_flush[BUF_FLUSH_LRU];
+		n_flush[BUF_FLUSH_LIST] += buf_pool->n_flush[BUF_FLUSH_LIST];
+		n_flush[BUF_FLUSH_SINGLE_PAGE] += buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE];
+
+		n_pages_read += buf_pool->n_pages_read;
+		n_pages_created += buf_pool->n_pages_created;
+		n_pages_written += buf_pool->n_pages_written;
+		n_page_gets += buf_pool->n_page_gets;
+
+		n_pages_read_old += buf_pool->n_pages_read_old;
+		n_pages_created_old += buf_pool->n_pages_created_old;
+		n_pages_written_old += buf_pool->n_pages_written_old;
+		n_page_gets_old += buf_pool->n_page_gets_old;
+
+		n_ra_pages_read += buf_pool->n_ra_pages_read;
+		n_ra_pages_evicted += buf_pool->n_ra_pages_evicted;
+		n_ra_pages_read_old += buf_pool->n_ra_pages_read_old;
+		n_ra_pages_evicted_old += buf_pool->n_ra_pages_evicted_old;
+
+		buf_pool->last_printout_time = current_time;
+		buf_pool->n_page_gets_old = buf_pool->n_page_gets;
+		buf_pool->n_pages_read_old = buf_pool->n_pages_read;
+		buf_pool->n_pages_created_old = buf_pool->n_pages_created;
+		buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+		buf_pool->n_ra_pages_read_old = buf_pool->n_ra_pages_read;
+		buf_pool->n_ra_pages_evicted_old = buf_pool->n_ra_pages_evicted;
+
+		mutex_exit(&(buf_pool->mutex));
+	}
 	
 	buf += sprintf(buf,"Buffer pool size   %lu\n", size);
-	buf += sprintf(buf,"Free buffers       %lu\n", UT_LIST_GET_LEN(buf_pool->free));
-	buf += sprintf(buf,"Database pages     %lu\n", UT_LIST_GET_LEN(buf_pool->LRU));
-	buf += sprintf(buf,"Modified db pages  %lu\n", UT_LIST_GET_LEN(buf_pool->flush_list));
-	buf += sprintf(buf, "Pending reads %lu \n", buf_pool->n_pend_reads);
+	buf += sprintf(buf,"Buffer pool instances %lu\n", buf_pool_instances);
+	buf += sprintf(buf,"Free buffers       %lu\n", n_free);
+	buf += sprintf(buf,"Database pages     %lu\n", n_lru);
+	buf += sprintf(buf,"Modified db pages  %lu\n", n_modified);
+	buf += sprintf(buf, "Pending reads %lu \n", n_pend_reads);
 	buf += sprintf(buf,"Pending writes: LRU %lu, flush list %lu, single page %lu\n",
-		buf_pool->n_flush[BUF_FLUSH_LRU],buf_pool->n_flush[BUF_FLUSH_LIST],buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE]);
-
-	current_time = time(NULL);
-	time_elapsed = 0.001 + difftime(current_time, buf_pool->last_printout_time);
-	buf_pool->last_printout_time = current_time;
+		n_flush[BUF_FLUSH_LRU], n_flush[BUF_FLUSH_LIST], n_flush[BUF_FLUSH_SINGLE_PAGE]);
 
 	buf += sprintf(buf, "Pages read %lu, created %lu, written %lu\n",
-			buf_pool->n_pages_read, buf_pool->n_pages_created, buf_pool->n_pages_written);
+			n_pages_read, n_pages_created, n_pages_written);
 
 	buf += sprintf(buf, "%.2f reads/s, %.2f creates/s, %.2f writes/s\n",
-		(buf_pool->n_pages_read - buf_pool->n_pages_read_old) / time_elapsed,
-		(buf_pool->n_pages_created - buf_pool->n_pages_created_old)/ time_elapsed,
-		(buf_pool->n_pages_written - buf_pool->n_pages_written_old)/ time_elapsed);
+		(n_pages_read - n_pages_read_old) / time_elapsed,
+		(n_pages_created - n_pages_created_old)/ time_elapsed,
+		(n_pages_written - n_pages_written_old)/ time_elapsed);
 
-	if (buf_pool->n_page_gets > buf_pool->n_page_gets_old) {
+	/*ԤЧԤpageлûбʾͱ̭page*/
+	buf += sprintf(buf, "Pages read ahead %.2f/s, evicted without access %.2f/s\n",
+		(n_ra_pages_read - n_ra_pages_read_old) / time_elapsed,
+		(n_ra_pages_evicted - n_ra_pages_evicted_old) / time_elapsed);
+
+	if (n_page_gets > n_page_gets_old) {
 		buf += sprintf(buf, "Buffer pool hit rate %lu / 1000\n",
-		1000 - ((1000 * (buf_pool->n_pages_read - buf_pool->n_pages_read_old)) / (buf_pool->n_page_gets - buf_pool->n_page_gets_old)));
+		1000 - ((1000 * (n_pages_read - n_pages_read_old)) / (n_page_gets - n_page_gets_old)));
 	} 
 	else
 		buf += sprintf(buf, "No buffer pool activity since the last printout\n");
-
-	buf_pool->n_page_gets_old = buf_pool->n_page_gets;
-	buf_pool->n_pages_read_old = buf_pool->n_pages_read;
-	buf_pool->n_pages_created_old = buf_pool->n_pages_created;
-	buf_pool->n_pages_written_old = buf_pool->n_pages_written;
-
-	mutex_exit(&(buf_pool->mutex));
 }
 
 void buf_refresh_io_stats(void)
 {
-	buf_pool->last_printout_time = time(NULL);
-	buf_pool->n_page_gets_old = buf_pool->n_page_gets;
-	buf_pool->n_pages_read_old = buf_pool->n_pages_read;
-	buf_pool->n_pages_created_old = buf_pool->n_pages_created;
-	buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+	buf_pool_t*	buf_pool;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+
+		buf_pool->last_printout_time = time(NULL);
+		buf_pool->n_page_gets_old = buf_pool->n_page_gets;
+		buf_pool->n_pages_read_old = buf_pool->n_pages_read;
+		buf_pool->n_pages_created_old = buf_pool->n_pages_created;
+		buf_pool->n_pages_written_old = buf_pool->n_pages_written;
+		buf_pool->n_ra_pages_read_old = buf_pool->n_ra_pages_read;
+		buf_pool->n_ra_pages_evicted_old = buf_pool->n_ra_pages_evicted;
+	}
 }
 
 /*жbuf_poolеĿܷͷ*/
 ibool buf_all_freed(void)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ulint		i;
+	ulint		j;
 	
-	ut_ad(buf_pool);
+	ut_ad(buf_pool_ptr);
 
-	mutex_enter(&(buf_pool->mutex));
+	for (j = 0; j < buf_pool_instances; j++) {
+		buf_pool = buf_pool_from_array(j);
 
-	for (i = 0; i < buf_pool->curr_size; i++) {
-		block = buf_pool_get_nth_block(buf_pool, i);
+		mutex_enter(&(buf_pool->mutex));
 
-		if (block->state == BUF_BLOCK_FILE_PAGE) {
-			if (!buf_flush_ready_for_replace(block))
-			    	ut_error;
+		for (i = 0; i < buf_pool->curr_size; i++) {
+			block = buf_pool_get_nth_block(buf_pool, i);
+
+			if (block->state == BUF_BLOCK_FILE_PAGE) {
+				if (!buf_flush_ready_for_replace(block))
+					ut_error;
+			}
 		}
- 	}
 
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return(TRUE);
 }
@@ -1106,18 +1334,21 @@ ibool buf_all_freed(void)
 /* out: TRUE if there is no pending i/o,ǷIO(̵Ķд)ִ*/
 ibool buf_pool_check_no_pending_io(void)
 {
-	ibool	ret;
+	buf_pool_t*	buf_pool;
+	ibool		ret = TRUE;
+	ulint		i;
 
-	mutex_enter(&(buf_pool->mutex));
+	for (i = 0; i < buf_pool_instances && ret; i++) {
+		buf_pool = buf_pool_from_array(i);
 
-	if (buf_pool->n_pend_reads + buf_pool->n_flush[BUF_FLUSH_LRU] + buf_pool->n_flush[BUF_FLUSH_LIST]
-	+ buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE] > 0)
-		ret = FALSE;
-	else
-		ret = TRUE;
-	}
+		mutex_enter(&(buf_pool->mutex));
 
-	mutex_exit(&(buf_pool->mutex));
+		if (buf_pool->n_pend_reads + buf_pool->n_flush[BUF_FLUSH_LRU] + buf_pool->n_flush[BUF_FLUSH_LIST]
+		+ buf_pool->n_flush[BUF_FLUSH_SINGLE_PAGE] > 0)
+			ret = FALSE;
+
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return ret;
 }
@@ -1125,13 +1356,19 @@ ibool buf_pool_check_no_pending_io(void)
 /*ȡеblocksĸ*/
 ulint buf_get_free_list_len()
 {
-	ulint len;
-	
-	mutex_enter(&(buf_pool->mutex));
+	buf_pool_t*	buf_pool;
+	ulint		len = 0;
+	ulint		i;
 
-	len = UT_LIST_GET_LEN(buf_pool->free);
+	for (i = 0; i < buf_pool_instances; i++) {
+		buf_pool = buf_pool_from_array(i);
+
+		mutex_enter(&(buf_pool->mutex));
+
+		len += UT_LIST_GET_LEN(buf_pool->free);
 	
-	mutex_exit(&(buf_pool->mutex));
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return len;
 }
@@ -8,6 +8,7 @@
 #include "hash0hash.h"
 #include "ut0byte.h"
 #include "mtr0types.h"
+#include "ut0rbt.h"
 
 /*Flags for flush types*/
 #define	BUF_FLUSH_LRU			1
@@ -21,6 +22,16 @@
 #define BUF_MAKE_YOUNG			51
 #define BUF_KEEP_OLD			52
 
+/*buffer poolʵ*/
+#define MAX_BUFFER_POOLS		64
+
+/*ҳchecksum㷨,srv_checksum_algorithmѡ,дҳβchecksumֶ*/
+#define BUF_CHECKSUM_ALGORITHM_INNODB	0	/*ɵut_fold_binary㷨*/
+#define BUF_CHECKSUM_ALGORITHM_CRC32	1	/*CRC32C,CPU֧SSE4.2ʱӲָ*/
+#define BUF_CHECKSUM_ALGORITHM_NONE		2	/*checksum,дBUF_NO_CHECKSUM_MAGIC*/
+
+#define BUF_NO_CHECKSUM_MAGIC			0xDEADBEEFUL
+
 /*control block state*/
 #define BUF_BLOCK_NOT_USED		211
 #define BUF_BLOCK_READY_FOR_USE	212
@@ -44,6 +55,7 @@ struct buf_block_struct
 	byte*						frame;				/*һСUNIV_PAGE_SIZEڴ*/
 	ulint						space;				/*space id*/
 	ulint						offset;				/*page number*/
+	ulint						buf_pool_index;		/*blockbuffer poolʵ*/
 	ulint						lock_hash_val;		
 	mutex_t*					lock_mutex;
 	rw_lock_t					lock;
@@ -63,6 +75,7 @@ struct buf_block_struct
 	ulint						freed_page_clock;
 	ibool						old;
 	ibool						accessed;		/*blockǷbuffer poolûaccessed = FALSE*/
+	ibool						read_ahead;		/*pageԤ,̭ʱaccessedһжԤǷЧ*/
 	ulint						buf_fix_count;  /*ӦpageڱⲿõĶļ*/
 	ulint						io_fix;			/*ǷIOڶblockӦpage*/
 
@@ -83,10 +96,11 @@ struct buf_block_struct
 	ibool						file_page_was_freed;
 };
 
-/*buf_pool_t*/
+/*buf_pool_t,һbuf_pool_tһĻʵ,ӵԼmutexpage_hashLRUfreeflush_list*/
 typedef struct buf_pool_t
 {
 	mutex_t						mutex;
+	ulint						instance_no;	/*ʵ,buf_pool_ptrе±*/
 	byte*						frame_mem;
 	byte*						frame_zero;		/*һblock frameַָ*/
 	byte*						high_end;
@@ -106,9 +120,14 @@ typedef struct buf_pool_t
 	ulint						n_pages_read_old;
 	ulint						n_pages_written_old;
 	ulint						n_pages_created_old;
+	ulint						n_ra_pages_read;		/*Ԥpage*/
+	ulint						n_ra_pages_evicted;		/*Ԥ뵫ûбʾͱLRṶpage*/
+	ulint						n_ra_pages_read_old;
+	ulint						n_ra_pages_evicted_old;
 
 	/*Page flush*/
 	UT_LIST_BASE_NODE_T(buf_block_t) flush_list;
+	ib_rbt_t*					flush_rbt;		/*ֻredo logָڼ,flush_listͬĺ,ʹO(log n)*/
 	ibool						init_flush[BUF_FLUSH_LIST + 1];
 	ulint						n_flush[BUF_FLUSH_LIST + 1];
 	os_event_t					no_flush[BUF_FLUSH_LIST + 1];
@@ -154,7 +173,12 @@ RW_X_LATCH are allowed as LA! */
 	LA, G, MC, __FILE__, __LINE__, MTR)
 
 /******************************************************************************/
-void							buf_pool_init(ulint max_size, ulint curr_size);
+void							buf_pool_init(ulint max_size, ulint curr_size, ulint n_instances);
+
+UNIV_INLINE buf_pool_t*			buf_pool_from_array(ulint index);
+UNIV_INLINE buf_pool_t*			buf_pool_get(ulint space, ulint offset);
+UNIV_INLINE buf_pool_t*			buf_pool_from_block(buf_block_t* block);
+UNIV_INLINE buf_pool_t*			buf_pool_from_frame(byte* ptr);
 
 UNIV_INLINE ulint				buf_pool_get_curr_size();
 UNIV_INLINE ulint				buf_pool_get_max_size();
@@ -185,6 +209,8 @@ UNIV_INLINE dulint				buf_frame_modify_clock_inc(buf_frame_t* frame);
 UNIV_INLINE dulint				buf_frame_get_modify_clock(buf_frame_t* frame);
 
 ulint							buf_calc_page_checksum(byte* page);
+ulint							buf_calc_page_crc32(byte* page);
+ulint							buf_calc_page_checksum_for_write(byte* page);
 ibool							buf_page_is_corrupted(byte* read_buf);
 UNIV_INLINE ulint				buf_frame_get_page_no(byte* ptr);
 UNIV_INLINE ulint				buf_frame_get_space_id(byte* ptr);
@@ -199,6 +225,7 @@ void							buf_page_print(byte* read_buf);
 void							buf_print();
 
 ulint							buf_get_n_pending_ios();
+ulint							buf_pool_get_n_pages_io();
 void							buf_print_io(char* buf, char* buf_end);
 void							buf_refresh_io_stats();
 ibool							buf_all_freed();
@@ -216,13 +243,14 @@ UNIV_INLINE buf_block_t*		buf_pool_get_nth_block(buf_pool_t* pool, ulint i);
 buf_block_t*					buf_page_init_for_read(ulint mode, ulint space, ulint offset);
 void							buf_page_io_complete(buf_block_t* block);
 UNIV_INLINE ulint				buf_page_address_fold(ulint space, ulint offset);
-UNIV_INLINE buf_block_t*		buf_page_hash_get(ulint space, ulint offset);
+UNIV_INLINE buf_block_t*		buf_page_hash_get(buf_pool_t* buf_pool, ulint space, ulint offset);
 
-UNIV_INLINE ulint				buf_pool_clock_tic();
+UNIV_INLINE ulint				buf_pool_clock_tic(buf_pool_t* buf_pool);
 ulint							buf_get_free_list_len();
 
-/*ȫֻض*/
-extern buf_pool_t*				buf_pool;
+/*ȫֻʵ,Ϊbuf_pool_instances*/
+extern buf_pool_t*				buf_pool_ptr;
+extern ulint					buf_pool_instances;
 extern ibool					buf_debug_prints;
 
 #include "buf0buf.inl"
@@ -5,41 +5,104 @@
 
 extern ulint buf_dbg_counter;
 
+/*õindexbuffer poolʵ*/
+UNIV_INLINE buf_pool_t* buf_pool_from_array(ulint index)
+{
+	ut_ad(index < buf_pool_instances);
+	ut_ad(buf_pool_ptr);
+
+	return buf_pool_ptr + index;
+}
+
+/*ͨ(space, offset)ȷpagebuffer poolʵͬһԤ(64page)ڵpageһͬһʵϣ
+ԤҳˢֻҪһʵmutex*/
+UNIV_INLINE buf_pool_t* buf_pool_get(ulint space, ulint offset)
+{
+	ulint fold;
+
+	fold = buf_page_address_fold(space, offset >> 6);
+
+	return buf_pool_from_array(fold % buf_pool_instances);
+}
+
+/*blockbuffer poolʵ*/
+UNIV_INLINE buf_pool_t* buf_pool_from_block(buf_block_t* block)
+{
+	ut_ad(block->buf_pool_index < buf_pool_instances);
+
+	return buf_pool_from_array(block->buf_pool_index);
+}
+
+/*ptrָframeڵbuffer poolʵ,ptrκʵframeڴУNULL*/
+UNIV_INLINE buf_pool_t* buf_pool_from_frame(byte* ptr)
+{
+	buf_pool_t*	buf_pool;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+		if(ptr >= buf_pool->frame_zero && ptr < buf_pool->high_end)
+			return buf_pool;
+	}
+
+	return NULL;
+}
+
 /*жblockǷԷyounger list*/
 UNIV_INLINE ibool buf_block_peek_if_too_old(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	if(buf_pool->freed_page_clock >= block->freed_page_clock + 1 + (buf_pool->curr_size / 1024))
 		return TRUE;
 
 	return FALSE;
 }
 
-/*õǰʹÿռС*/
+/*õǰʹÿռС,ʵ֮*/
 UNIV_INLINE ulint buf_pool_get_curr_size()
 {
-	return buf_pool->curr_size * UNIV_PAGE_SIZE;
+	ulint	size = 0;
+	ulint	i;
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		size += buf_pool_from_array(i)->curr_size;
+
+	return size * UNIV_PAGE_SIZE;
 }
 
-/*ûռСmysqlļΪbuffer_pool_size*/
+/*ûռСmysqlļΪbuffer_pool_size,ʵ֮*/
 UNIV_INLINE ulint buf_pool_get_max_size()
 {
-	return buf_pool->max_size * UNIV_PAGE_SIZE;
+	ulint	size = 0;
+	ulint	i;
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		size += buf_pool_from_array(i)->max_size;
+
+	return size * UNIV_PAGE_SIZE;
 }
 
 /*buffer poolеĵiblock*/
 UNIV_INLINE buf_block_t* buf_pool_get_nth_block(buf_pool_t* pool, ulint i)
 {
-	ut_ad(buf_pool);
-	ut_ad(i < buf_pool->max_size);
+	ut_ad(pool);
+	ut_ad(i < pool->max_size);
 
-	return i + buf_pool->blocks;
+	return i + pool->blocks;
 }
 
 /*ptrǷbuffer pool blocksеָ*/
 UNIV_INLINE ibool buf_pool_is_block(void* ptr)
 {
-	if(buf_pool->blocks <= (buf_block_t*)ptr && (buf_block_t*)ptr < buf_pool->blocks + buf_pool->max_size)
-		return TRUE;
+	buf_pool_t*	buf_pool;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+		if(buf_pool->blocks <= (buf_block_t*)ptr && (buf_block_t*)ptr < buf_pool->blocks + buf_pool->max_size)
+			return TRUE;
+	}
 
 	return FALSE;
 }
@@ -47,24 +110,35 @@ UNIV_INLINE ibool buf_pool_is_block(void* ptr)
 /*lru޸ĵblockĶӦlsn*/
 UNIV_INLINE dulint buf_pool_get_oldest_modification(void)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	dulint			lsn;
+	dulint			oldest_lsn = ut_dulint_zero;
+	ulint			i;
 
-	mutex_enter(&(buf_pool->mutex));
+	/*ȡʵflush listĩβСķ0 lsn*/
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
 
-	block = UT_LIST_GET_LAST(buf_pool->flush_list);
-	if(block == NULL)
-		lsn = ut_dulint_zero;
-	else
-		lsn = block->oldest_modification;
+		mutex_enter(&(buf_pool->mutex));
 
-	mutex_exit(&(buf_pool->mutex));
+		block = UT_LIST_GET_LAST(buf_pool->flush_list);
+		if(block == NULL)
+			lsn = ut_dulint_zero;
+		else
+			lsn = block->oldest_modification;
 
-	return lsn;
+		mutex_exit(&(buf_pool->mutex));
+
+		if(!ut_dulint_is_zero(lsn) && (ut_dulint_is_zero(oldest_lsn) || ut_dulint_cmp(lsn, oldest_lsn) < 0))
+			oldest_lsn = lsn;
+	}
+
+	return oldest_lsn;
 }
 
 /*pool clock Լ1*/
-UNIV_INLINE ulint buf_pool_clock_tic()
+UNIV_INLINE ulint buf_pool_clock_tic(buf_pool_t* buf_pool)
 {
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
@@ -77,8 +151,8 @@ UNIV_INLINE ulint buf_pool_clock_tic()
 UNIV_INLINE buf_frame_t* buf_block_get_frame(buf_block_t* block)
 {
 	ut_ad(block);
-	ut_ad(block >= buf_pool->blocks);
-	ut_ad(block < buf_pool->blocks + buf_pool->max_size);
+	ut_ad(block >= buf_pool_from_block(block)->blocks);
+	ut_ad(block < buf_pool_from_block(block)->blocks + buf_pool_from_block(block)->max_size);
 	ut_ad(block->state != BUF_BLOCK_NOT_USED); 
 	ut_ad((block->state != BUF_BLOCK_FILE_PAGE) || (block->buf_fix_count > 0));
 
@@ -89,8 +163,8 @@ UNIV_INLINE buf_frame_t* buf_block_get_frame(buf_block_t* block)
 UNIV_INLINE ulint buf_block_get_space(buf_block_t* block)
 {
 	ut_ad(block);
-	ut_ad(block >= buf_pool->blocks);
-	ut_ad(block < buf_pool->blocks + buf_pool->max_size);
+	ut_ad(block >= buf_pool_from_block(block)->blocks);
+	ut_ad(block < buf_pool_from_block(block)->blocks + buf_pool_from_block(block)->max_size);
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 	ut_ad(block->buf_fix_count > 0);
 
@@ -101,8 +175,8 @@ UNIV_INLINE ulint buf_block_get_space(buf_block_t* block)
 UNIV_INLINE ulint buf_block_get_page_no(buf_block_t* block)
 {
 	ut_ad(block);
-	ut_ad(block >= buf_pool->blocks);
-	ut_ad(block < buf_pool->blocks + buf_pool->max_size);
+	ut_ad(block >= buf_pool_from_block(block)->blocks);
+	ut_ad(block < buf_pool_from_block(block)->blocks + buf_pool_from_block(block)->max_size);
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 	ut_ad(block->buf_fix_count > 0);
 
@@ -112,50 +186,57 @@ UNIV_INLINE ulint buf_block_get_page_no(buf_block_t* block)
 /*ptrڵblockַָ*/
 UNIV_INLINE buf_block_t* buf_block_align(byte* ptr)
 {
+	buf_pool_t*  buf_pool;
 	buf_block_t* block;
 	buf_frame_t* frame_zero;
 
 	ut_ad(ptr);
 
-	frame_zero = buf_pool->frame_zero;
-	ut_ad((ulint)ptr >= (ulint)frame_zero);
-
-	block = buf_pool_get_nth_block(buf_pool, ((ulint)(ptr - frame_zero)) >> UNIV_PAGE_SIZE_SHIFT);
-	/*blockbuf poolblocksַΧУ쳣*/
-	if(block < buf_pool->blocks || block >= buf_pool->blocks + buf_pool->max_size){
+	/*ptrκһbuffer poolʵframeַΧУ쳣*/
+	buf_pool = buf_pool_from_frame(ptr);
+	if(buf_pool == NULL){
+		buf_pool = buf_pool_from_array(0);
 		fprintf(stderr,
 			"InnoDB: Error: trying to access a stray pointer %lx\n"
 			"InnoDB: buf pool start is at %lx, number of pages %lu\n", (ulint)ptr,
-			(ulint)frame_zero, buf_pool->max_size);
+			(ulint)(buf_pool->frame_zero), buf_pool->max_size);
 
 		ut_a(0);
 	}
 
+	frame_zero = buf_pool->frame_zero;
+	ut_ad((ulint)ptr >= (ulint)frame_zero);
+
+	block = buf_pool_get_nth_block(buf_pool, ((ulint)(ptr - frame_zero)) >> UNIV_PAGE_SIZE_SHIFT);
+
 	return block;
 }
 
 /*buf_block_alignͬ*/
 UNIV_INLINE buf_block_t* buf_block_align_low(byte* ptr)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	buf_frame_t*	frame_zero;
 
 	ut_ad(ptr);
 
-	frame_zero = buf_pool->frame_zero;
-
-	ut_ad((ulint)ptr >= (ulint)frame_zero);
-
-	block = buf_pool_get_nth_block(buf_pool, ((ulint)(ptr - frame_zero)) >> UNIV_PAGE_SIZE_SHIFT);
-	if (block < buf_pool->blocks || block >= buf_pool->blocks + buf_pool->max_size) {
-
+	buf_pool = buf_pool_from_frame(ptr);
+	if (buf_pool == NULL) {
+			buf_pool = buf_pool_from_array(0);
 			fprintf(stderr,
 				"InnoDB: Error: trying to access a stray pointer %lx\n"
 				"InnoDB: buf pool start is at %lx, number of pages %lu\n", (ulint)ptr,
-				(ulint)frame_zero, buf_pool->max_size);
+				(ulint)(buf_pool->frame_zero), buf_pool->max_size);
 			ut_a(0);
 	}
 
+	frame_zero = buf_pool->frame_zero;
+
+	ut_ad((ulint)ptr >= (ulint)frame_zero);
+
+	block = buf_pool_get_nth_block(buf_pool, ((ulint)(ptr - frame_zero)) >> UNIV_PAGE_SIZE_SHIFT);
+
 	return block;
 }
 
@@ -168,12 +249,11 @@ UNIV_INLINE buf_frame_t* buf_frame_align(byte* ptr)
 
 	frame = ut_align_down(ptr, UNIV_PAGE_SIZE);
 
-	if ((void *)frame < (void*)(buf_pool->frame_zero)
-		|| (void *)frame > (void *)(buf_pool_get_nth_block(buf_pool, buf_pool->max_size - 1)->frame)){
+	if (buf_pool_from_frame(frame) == NULL){
 			fprintf(stderr,
 				"InnoDB: Error: trying to access a stray pointer %lx\n"
 				"InnoDB: buf pool start is at %lx, number of pages %lu\n", (ulint)ptr,
-				(ulint)(buf_pool->frame_zero), buf_pool->max_size);
+				(ulint)(buf_pool_from_array(0)->frame_zero), buf_pool_from_array(0)->max_size);
 			ut_a(0);
 	}
 
@@ -236,6 +316,8 @@ UNIV_INLINE ulint buf_page_address_fold(ulint space, ulint offset)
 /*жһioǷblockӦpage*/
 UNIV_INLINE ibool buf_page_io_query(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	mutex_enter(&(buf_pool->mutex));
 
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
@@ -254,12 +336,14 @@ UNIV_INLINE ibool buf_page_io_query(buf_block_t* block)
 /*frameӦblocknewest modificationLSN*/
 UNIV_INLINE dulint buf_frame_get_newest_modification(buf_frame_t* frame)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	dulint			lsn;
 
 	ut_ad(frame);
 
 	block = buf_block_align(frame);
+	buf_pool = buf_pool_from_block(block);
 
 	mutex_enter(&(buf_pool->mutex));
 
@@ -281,7 +365,7 @@ UNIV_INLINE dulint buf_frame_modify_clock_inc(buf_frame_t* frame)
 	ut_ad(frame);
 
 	block = buf_block_align_low(frame);
-	ut_ad((mutex_own(&(buf_pool->mutex)) && (block->buf_fix_count == 0)) || rw_lock_own(&(block->lock), RW_LOCK_EXCLUSIVE));
+	ut_ad((mutex_own(&(buf_pool_from_block(block)->mutex)) && (block->buf_fix_count == 0)) || rw_lock_own(&(block->lock), RW_LOCK_EXCLUSIVE));
 
 	UT_DULINT_INC(block->modify_clock);
 
@@ -318,12 +402,13 @@ UNIV_INLINE void buf_block_buf_fix_inc(buf_block_t* block)
 }
 
 /*space idpage nobuf poolҶӦblock,ûбػĻΪNULL*/
-UNIV_INLINE buf_block_t* buf_page_hash_get(ulint space, ulint offset)
+UNIV_INLINE buf_block_t* buf_page_hash_get(buf_pool_t* buf_pool, ulint space, ulint offset)
 {
 	buf_block_t*	block;
 	ulint			fold;
 
 	ut_ad(buf_pool);
+	ut_ad(buf_pool == buf_pool_get(space, offset));
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
 	fold = buf_page_address_fold(space, offset);
@@ -353,10 +438,13 @@ UNIV_INLINE buf_frame_t* buf_page_get_release_on_io(ulint space, ulint offset, b
 /*blockbuf_fix_countԼrelease ָrw_latchblock->lock*/
 UNIV_INLINE void buf_page_release(buf_block_t* block, ulint rw_latch, mtr_t* mtr)
 {
-	ulint	buf_fix_count;
+	buf_pool_t*	buf_pool;
+	ulint		buf_fix_count;
 
 	ut_ad(block);
 
+	buf_pool = buf_pool_from_block(block);
+
 	mutex_enter_fast(&(buf_pool->mutex));
 
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
@@ -10,40 +10,153 @@
 #include "log0log.h"
 #include "os0file.h"
 #include "trx0sys.h"
+#include "srv0srv.h"
+#include "srv0start.h"
+#include "os0thread.h"
 
 /*flushˢ̵ҳ*/
-#define BUF_FLUSH_AREA		ut_min(BUF_READ_AHEAD_AREA, buf_pool->curr_size / 16)
+#define BUF_FLUSH_AREA(b)	ut_min(BUF_READ_AHEAD_AREA(b), (b)->curr_size / 16)
 
 /*жflush listĺϷ*/
-static ibool buf_flush_validate_low();
+static ibool buf_flush_validate_low(buf_pool_t* buf_pool);
+
+/*Ӧˢͳredoٶȵ*/
+#define BUF_FLUSH_STAT_N_INTERVAL	20
+
+/*BUF_FLUSH_STAT_N_INTERVALÿredoֽ,,ֻpage cleaner̷߳*/
+static ulint	buf_flush_stat_arr[BUF_FLUSH_STAT_N_INTERVAL];
+static ulint	buf_flush_stat_arr_ind	= 0;
+static ulint	buf_flush_stat_sum		= 0;
+static dulint	buf_flush_stat_last_lsn;
+static time_t	buf_flush_stat_last_time = 0;
+
+os_event_t		buf_flush_page_cleaner_event = NULL;
+ibool			buf_page_cleaner_is_active = FALSE;
+
+/*flush_rbtıȽϺp1p2ָbuf_block_t*ָ롣oldest_modificationɴС򣬺flush_list
+˳ͬoldest_modificationͬʱ(space, offset)֣֤ûظļ*/
+static int buf_flush_block_cmp(const void* p1, const void* p2)
+{
+	const buf_block_t*	b1 = *(const buf_block_t**)p1;
+	const buf_block_t*	b2 = *(const buf_block_t**)p2;
+	int					ret;
+
+	ut_ad(b1 != NULL);
+	ut_ad(b2 != NULL);
+
+	ret = ut_dulint_cmp(b2->oldest_modification, b1->oldest_modification);
+	if(ret != 0)
+		return ret;
+
+	if(b1->space != b2->space)
+		return b2->space > b1->space ? 1 : -1;
+
+	if(b1->offset != b2->offset)
+		return b2->offset > b1->offset ? 1 : -1;
+
+	return 0;
+}
+
+/*redo logָʼʱΪÿbuffer poolʵflush_rbt*/
+void buf_flush_init_flush_rbt()
+{
+	buf_pool_t*	buf_pool;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+
+		mutex_enter(&(buf_pool->mutex));
+
+		/*ָʼ֮ǰflush_listǿյ*/
+		ut_a(UT_LIST_GET_LEN(buf_pool->flush_list) == 0);
+		if(buf_pool->flush_rbt == NULL)
+			buf_pool->flush_rbt = rbt_create(sizeof(buf_block_t*), buf_flush_block_cmp);
+
+		mutex_exit(&(buf_pool->mutex));
+	}
+}
+
+/*redo logָʱͷflush_rbt֮ҳǰLSN˳뵽flush_listͷ*/
+void buf_flush_free_flush_rbt()
+{
+	buf_pool_t*	buf_pool;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+
+		mutex_enter(&(buf_pool->mutex));
+
+		if(buf_pool->flush_rbt != NULL){
+			ut_ad(buf_flush_validate_low(buf_pool));
+			rbt_free(buf_pool->flush_rbt);
+			buf_pool->flush_rbt = NULL;
+		}
+
+		mutex_exit(&(buf_pool->mutex));
+	}
+}
+
+/*block뵽flush_rbtУflush_listӦblockǰblock,ûзNULL*/
+static buf_block_t* buf_flush_insert_in_flush_rbt(buf_block_t* block)
+{
+	buf_pool_t*				buf_pool = buf_pool_from_block(block);
+	const ib_rbt_node_t*	c_node;
+	const ib_rbt_node_t*	p_node;
+
+	ut_ad(mutex_own(&(buf_pool->mutex)));
+
+	c_node = rbt_insert(buf_pool->flush_rbt, &block, &block);
+	ut_a(c_node != NULL);
+
+	p_node = rbt_prev(buf_pool->flush_rbt, c_node);
+	if(p_node == NULL)
+		return NULL;
+
+	return *rbt_value(buf_block_t*, p_node);
+}
 
 /*һҳӦblock뵽flush list*/
 void buf_flush_insert_into_flush_list(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
+	/*ָڼflush_listһǰLSN˳ģ*/
+	if(buf_pool->flush_rbt != NULL){
+		buf_flush_insert_sorted_into_flush_list(block);
+		return;
+	}
+
 	ut_ad((UT_LIST_GET_FIRST(buf_pool->flush_list) == NULL)
 		|| (ut_dulint_cmp((UT_LIST_GET_FIRST(buf_pool->flush_list))->oldest_modification, block->oldest_modification) <= 0));
 
 	UT_LIST_ADD_FIRST(flush_list, buf_pool->flush_list, block);
 
-	ut_ad(buf_flush_validate_low());
+	ut_ad(buf_flush_validate_low(buf_pool));
 }
 
 /*start_lsnɴС˳block뵽flush listУֻredo logݵĹ̲Żô˺*/
 void buf_flush_insert_sorted_into_flush_list(buf_block_t* block)
 {
+	buf_pool_t*		buf_pool = buf_pool_from_block(block);
 	buf_block_t*	prev_b;
 	buf_block_t*	b;
 
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 
 	prev_b = NULL;
-	b = UT_LIST_GET_FIRST(buf_pool->flush_list);
-	/*ҵLSNɴСλãΪˢǰLSNСˢ̣flush listĩβʼˢ*/
-	while(b && ut_ulint_cmp(b->oldest_modification, block->oldest_modification) > 0){
-		prev_b = b;
-		b = UT_LIST_GET_NEXT(flush_list, b);
+	if(buf_pool->flush_rbt != NULL) /*úO(log n)ҵλ*/
+		prev_b = buf_flush_insert_in_flush_rbt(block);
+	else{
+		b = UT_LIST_GET_FIRST(buf_pool->flush_list);
+		/*ҵLSNɴСλãΪˢǰLSNСˢ̣flush listĩβʼˢ*/
+		while(b && ut_dulint_cmp(b->oldest_modification, block->oldest_modification) > 0){
+			prev_b = b;
+			b = UT_LIST_GET_NEXT(flush_list, b);
+		}
 	}
 
 	/*prev_b == NULL,˵block->start_lsnȶκblockҪԲ뵽flush listͷ*/
@@ -52,12 +165,14 @@ void buf_flush_insert_sorted_into_flush_list(buf_block_t* block)
 	else
 		UT_LIST_INSERT_AFTER(flush_list, buf_pool->flush_list, prev_b, block);
 
-	ut_ad(buf_flush_validate_low());
+	ut_ad(buf_flush_validate_low(buf_pool));
 }
 
 /*blockǷԽṷ̂IOfix latchڡѾ޸Ĺûˢ̣ܽû*/
 ibool buf_flush_ready_for_replace(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 
@@ -71,6 +186,8 @@ ibool buf_flush_ready_for_replace(buf_block_t* block)
 /*blockӦpageҳҿԽflush*/
 UNIV_INLINE ibool buf_flush_ready_for_flush(buf_block_t* block, ulint flush_type)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 
@@ -87,8 +204,19 @@ UNIV_INLINE ibool buf_flush_ready_for_flush(buf_block_t* block, ulint flush_type
 /*һflushźŵʱ޸ĶӦ״̬Ϣ*/
 void buf_flush_write_complete(buf_block_t* block)
 {
+	buf_pool_t*				buf_pool;
+	trx_doublewrite_slot_t*	slot;
+	ulint					n_pending;
+
 	ut_ad(block);
+
+	buf_pool = buf_pool_from_block(block);
 	ut_ad(mutex_own(&(buf_pool->mutex)));
+
+	/*flush_rbtoldest_modification򣬱֮ǰɾ*/
+	if(buf_pool->flush_rbt != NULL)
+		ut_a(rbt_delete(buf_pool->flush_rbt, &block));
+
 	/*start_lsnΪ0ʾѾҳˢ*/
 	block->oldest_modification = ut_dulint_zero;
 	/*blockflush listɾ*/
@@ -106,50 +234,50 @@ void buf_flush_write_complete(buf_block_t* block)
 	/*flushǷɣɣһFLUSHź*/
 	if(buf_pool->n_flush[block->flush_type] == 0 && buf_pool->init_flush[block->flush_type] == FALSE)
 		os_event_set(buf_pool->no_flush[block->flush_type]);
+
+	/*doublewriteʱ,֮ǰύдcheckpointʱѾȫ,ҳһǾdoublewrite slotд*/
+	if(trx_doublewrite != NULL){
+		slot = trx_doublewrite_get_slot(block->flush_type);
+#ifdef HAVE_ATOMIC_BUILTINS
+		n_pending = os_atomic_decrement_ulint(&(slot->n_pending), 1);
+#else
+		/*slot->mutexڵȴwrite_doneʱ,n_pending*/
+		mutex_enter(&(slot->pending_mutex));
+		n_pending = -- slot->n_pending;
+		mutex_exit(&(slot->pending_mutex));
+#endif
+		if(n_pending == 0)
+			os_event_set(slot->write_done);
+	}
 }
 
-/*doublewriteڴеݺͶӦҳˢdiskһaio߳,ҳˢͨ첽ʽˢ*/
-static void buf_flush_buffered_writes()
+/*һdoublewrite slotеݺͶӦҳˢdiskһaio߳,ҳˢͨ첽ʽˢ*/
+static void buf_flush_buffered_writes_slot(trx_doublewrite_slot_t* slot)
 {
 	buf_block_t*	block;
-	ulint			len;
 	ulint			i;
 
-	if(trx_doublewrite == NULL){
-		os_aio_simulated_wake_handler_threads();
-		return ;
-	}
+	/*latchʱܱȽϳΪ漰ͬIO,ֻʹͬһslotbatch*/
+	mutex_enter(&(slot->mutex));
 
-	/*latchʱܱȽϳΪ漰ͬIO*/
-	mutex_enter(&(trx_doublewrite->mutex));
-	
-	if(trx_doublewrite->first_free == 0){
-		mutex_exit(&(trx_doublewrite->mutex));
+	if(slot->first_free == 0){
+		mutex_exit(&(slot->mutex));
 		return;
 	}
 
-	/*ȷˢݵĳ*/
-	if (trx_doublewrite->first_free > TRX_SYS_DOUBLEWRITE_BLOCK_SIZE)
-		len = TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE;
-	else
-		len = trx_doublewrite->first_free * UNIV_PAGE_SIZE;
-	/*ˢһdoublewriteݿ飬ͬˢ룬ΪdoublewriteΪ˱֤ɲʧƵģ첽IOˢ*/
-	fil_io(OS_FILE_WRITE, TRUE, TRX_SYS_SPACE,
-		trx_doublewrite->block1, 0, len, (void*)trx_doublewrite->write_buf, NULL);
-
-	/*ˢڶdoublewriteݿ*/
-	if (trx_doublewrite->first_free > TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-		len = (trx_doublewrite->first_free - TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) * UNIV_PAGE_SIZE;
-
-		fil_io(OS_FILE_WRITE, TRUE, TRX_SYS_SPACE, trx_doublewrite->block2, 0, len,
-			(void*)(trx_doublewrite->write_buf + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE), NULL);
-	}
+	/*ˢslotӦdoublewriteݿ飬ͬˢ룬ΪdoublewriteΪ˱֤ɲʧƵģ첽IOˢ*/
+	fil_io(OS_FILE_WRITE, TRUE, TRX_SYS_SPACE, slot->page_no, 0, slot->first_free * UNIV_PAGE_SIZE,
+		(void*)slot->write_buf, NULL);
 
 	fil_flush(TRX_SYS_SPACE);
 
+	/*ύ첽д֮ǰü,buf_flush_write_completeÿһҳ1*/
+	os_event_reset(slot->write_done);
+	slot->n_pending = slot->first_free;
+
 	/*Ӧҳˢ*/
-	for (i = 0; i < trx_doublewrite->first_free; i++) {
-		block = trx_doublewrite->buf_block_arr[i];
+	for (i = 0; i < slot->first_free; i++) {
+		block = slot->buf_block_arr[i];
 		/*첽pageˢ*/
 		fil_io(OS_FILE_WRITE | OS_AIO_SIMULATED_WAKE_LATER, FALSE, block->space, block->offset, 0, UNIV_PAGE_SIZE,
 			(void*)block->frame, (void*)block);
@@ -157,43 +285,61 @@ static void buf_flush_buffered_writes()
 
 	os_aio_simulated_wake_handler_threads();
 
-	/*ȴaioźΪ,Ҳǵȴеwriteȫ*/
-	os_aio_wait_until_no_pending_writes();
+	/*ֻȴslotύҳд,slotϲbatchҪȴ*/
+	os_event_wait(slot->write_done);
 
 	fil_flush_file_spaces(FIL_TABLESPACE);
 
 	/*֤doublewrite memoryеȫˢ*/
-	trx_doublewrite->first_free = 0;
+	slot->first_free = 0;
 
-	mutex_exit(&(trx_doublewrite->mutex));
+	mutex_exit(&(slot->mutex));
 }
 
-/*blockӦpageдdoublewrite*/
+/*doublewrite slotеˢ*/
+static void buf_flush_buffered_writes()
+{
+	ulint i;
+
+	if(trx_doublewrite == NULL){
+		os_aio_simulated_wake_handler_threads();
+		return ;
+	}
+
+	for(i = 0; i < TRX_DOUBLEWRITE_N_SLOTS; i ++)
+		buf_flush_buffered_writes_slot(&(trx_doublewrite->slots[i]));
+}
+
+/*blockӦpageдflush typeӦdoublewrite slot*/
 static void buf_flush_post_to_doublewrite_buf(buf_block_t* block)
 {
+	trx_doublewrite_slot_t* slot;
+
+	slot = trx_doublewrite_get_slot(block->flush_type);
+
 try_again:
-	mutex_enter(&(trx_doublewrite->mutex));
-	/*doublewrite ̫࣬Ҫǿˢ*/
-	if (trx_doublewrite->first_free >= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-			mutex_exit(&(trx_doublewrite->mutex));
-			buf_flush_buffered_writes();
+	mutex_enter(&(slot->mutex));
+	/*slot ̫࣬Ҫǿˢ*/
+	if (slot->first_free >= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+			mutex_exit(&(slot->mutex));
+			buf_flush_buffered_writes_slot(slot);
 
 			goto try_again;
 	}
 	/*blockӦpageд뵽doublewriteڴУԱ㱣*/
-	ut_memcpy(trx_doublewrite->write_buf + UNIV_PAGE_SIZE * trx_doublewrite->first_free, block->frame, UNIV_PAGE_SIZE);
+	ut_memcpy(slot->write_buf + UNIV_PAGE_SIZE * slot->first_free, block->frame, UNIV_PAGE_SIZE);
 
-	trx_doublewrite->buf_block_arr[trx_doublewrite->first_free] = block;
-	trx_doublewrite->first_free ++;
+	slot->buf_block_arr[slot->first_free] = block;
+	slot->first_free ++;
 
-	if (trx_doublewrite->first_free >= 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
-			mutex_exit(&(trx_doublewrite->mutex));
-			buf_flush_buffered_writes();
+	if (slot->first_free >= TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) {
+			mutex_exit(&(slot->mutex));
+			buf_flush_buffered_writes_slot(slot);
 
 			return;
 	}
 
-	mutex_exit(&(trx_doublewrite->mutex));
+	mutex_exit(&(slot->mutex));
 }
 
 /*pageLSNspace page_noϢдpage header/tailer*/
@@ -206,8 +352,8 @@ void buf_flush_init_for_writing(byte* page, dulint newest_lsn, ulint space, ulin
 	mach_write_to_4(page + FIL_PAGE_SPACE, space);
 	mach_write_to_4(page + FIL_PAGE_OFFSET, page_no);
 
-	/*ҳchecksumдҳβ*/
-	mach_write_to_4(page + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN, buf_calc_page_checksum(page));
+	/*õ㷨ҳchecksumдҳβ*/
+	mach_write_to_4(page + UNIV_PAGE_SIZE - FIL_PAGE_END_LSN, buf_calc_page_checksum_for_write(page));
 }
 
 /*blockӦpageredo logˢ*/
@@ -230,20 +376,23 @@ static void buf_flush_write_block_low(buf_block_t* block)
 
 static ulint buf_flush_try_page(ulint space, ulint offset, ulint flush_type)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ibool		locked;
 
 	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST || flush_type == BUF_FLUSH_SINGLE_PAGE);
 
+	buf_pool = buf_pool_get(space, offset);
+
 	mutex_enter(&(buf_pool->mutex));
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	/*flush listеblockˢ*/
-	if(flush_type == BUF_FLUSH_LIST && block != NULL && buf_flush_ready_for_flush(block)){
+	if(flush_type == BUF_FLUSH_LIST && block != NULL && buf_flush_ready_for_flush(block, flush_type)){
 		block->io_fix = BUF_IO_WRITE;
 		block->flush_type = flush_type;
 
-		if(buf_pool->no_flush[flush_type] == 0)
+		if(buf_pool->n_flush[flush_type] == 0)
 			os_event_reset(buf_pool->no_flush[flush_type]);
 
 		(buf_pool->n_flush[flush_type])++;
@@ -317,6 +466,7 @@ static ulint buf_flush_try_page(ulint space, ulint offset, ulint flush_type)
 /*(space, offset)ӦҳλΧҳȫˢ*/
 static ulint buf_flush_try_neighbors(ulint space, ulint offset, ulint flush_type)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ulint		low, high;
 	ulint		count		= 0;
@@ -324,8 +474,11 @@ static ulint buf_flush_try_neighbors(ulint space, ulint offset, ulint flush_type
 
 	ut_ad(flush_type == BUF_FLUSH_LRU || flush_type == BUF_FLUSH_LIST);
 
-	low = (offset / BUF_FLUSH_AREA) * BUF_FLUSH_AREA;
-	high = (offset / BUF_FLUSH_AREA + 1) * BUF_FLUSH_AREA;
+	/*BUF_FLUSH_AREAᳬ64[low, high)ڵҳͬһʵ*/
+	buf_pool = buf_pool_get(space, offset);
+
+	low = (offset / BUF_FLUSH_AREA(buf_pool)) * BUF_FLUSH_AREA(buf_pool);
+	high = (offset / BUF_FLUSH_AREA(buf_pool) + 1) * BUF_FLUSH_AREA(buf_pool);
 
 	if(UT_LIST_GET_LEN(buf_pool->LRU) < BUF_LRU_OLD_MIN_LEN){
 		low = offset;
@@ -342,7 +495,9 @@ static ulint buf_flush_try_neighbors(ulint space, ulint offset, ulint flush_type
 	mutex_enter(&(buf_pool->mutex));
 
 	for(i = low; i < high; i ++){
-		block = buf_page_hash_get(space, i);
+		ut_ad(buf_pool_get(space, i) == buf_pool);
+
+		block = buf_page_hash_get(buf_pool, space, i);
 		if(block && flush_type == BUF_FLUSH_LRU && i != offset && !block->old)
 			continue;
 
@@ -360,7 +515,7 @@ static ulint buf_flush_try_neighbors(ulint space, ulint offset, ulint flush_type
 }
 
 /*ҳˢ*/
-ulint buf_flush_batch(ulint flush_type, ulint min_n, dulint lsn_limit)
+ulint buf_flush_batch(buf_pool_t* buf_pool, ulint flush_type, ulint min_n, dulint lsn_limit)
 {
 	buf_block_t*	block;
 	ulint		page_count 	= 0;
@@ -391,7 +546,7 @@ ulint buf_flush_batch(ulint flush_type, ulint min_n, dulint lsn_limit)
 			ut_ad(flush_type == BUF_FLUSH_LIST);
 			block = UT_LIST_GET_LAST(buf_pool->flush_list);
 
-			if(block != NULL || ut_dulint_cmp(block->oldest_modification, lsn_limit) >= 0)
+			if(block == NULL || ut_dulint_cmp(block->oldest_modification, lsn_limit) >= 0)
 				break;
 		}
 
@@ -413,7 +568,7 @@ ulint buf_flush_batch(ulint flush_type, ulint min_n, dulint lsn_limit)
 				block = UT_LIST_GET_PREV(LRU, block);
 			else {
 				ut_ad(flush_type == BUF_FLUSH_LIST);
-				block = UT_LIST_GET_PREV(flush_type, block);
+				block = UT_LIST_GET_PREV(flush_list, block);
 			}
 		}
 
@@ -428,8 +583,12 @@ ulint buf_flush_batch(ulint flush_type, ulint min_n, dulint lsn_limit)
 	}
 
 	mutex_exit(&(buf_pool->mutex));
-	
-	buf_flush_buffered_writes();
+
+	/*ֻˢbatchʹõslot,һ͵batchͬʱ*/
+	if(trx_doublewrite != NULL)
+		buf_flush_buffered_writes_slot(trx_doublewrite_get_slot(flush_type));
+	else
+		os_aio_simulated_wake_handler_threads();
 
 	if (buf_debug_prints && page_count > 0) {
 		if (flush_type == BUF_FLUSH_LRU)
@@ -444,15 +603,93 @@ ulint buf_flush_batch(ulint flush_type, ulint min_n, dulint lsn_limit)
 	return page_count;
 }
 
-/*һpages batch flushȴ*/
-void buf_flush_wait_batch_end(ulint type)
+/*ʵflush listˢ,min_nƽ䵽ʵϡʵͬ͵ˢ̣ULINT_UNDEFINED*/
+ulint buf_flush_list(ulint min_n, dulint lsn_limit)
+{
+	ulint	i;
+	ulint	page_count;
+	ulint	total_page_count = 0;
+	ibool	skipped = FALSE;
+
+	if(min_n != ULINT_MAX)
+		min_n = (min_n + buf_pool_instances - 1) / buf_pool_instances;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		page_count = buf_flush_batch(buf_pool_from_array(i), BUF_FLUSH_LIST, min_n, lsn_limit);
+		if(page_count == ULINT_UNDEFINED)
+			skipped = TRUE;
+		else
+			total_page_count += page_count;
+	}
+
+	if(skipped)
+		return ULINT_UNDEFINED;
+
+	return total_page_count;
+}
+
+/*spacepage_nosָҳд̲ȴд,ڲдredo޸ĵҳ(bulk loadҳ)ύ֮ǰ,
+Ҫbuffer poolcheckpointҳBUF_FLUSH_LISTд,page cleanerflush list batchdoublewrite slot*/
+void buf_flush_pages(ulint space, ulint* page_nos, ulint n_pages)
 {
+	buf_pool_t*		buf_pool;
+	buf_block_t*	block;
+	ulint			n_dirty;
+	ulint			i;
+
+	for(;;){
+		for(i = 0; i < n_pages; i ++)
+			buf_flush_try_page(space, page_nos[i], BUF_FLUSH_LIST);
+
+		if(trx_doublewrite != NULL)
+			buf_flush_buffered_writes_slot(trx_doublewrite_get_slot(BUF_FLUSH_LIST));
+		else
+			os_aio_simulated_wake_handler_threads();
+
+		/*߳ύslotпܻЩҳ,ȴʵflush listд*/
+		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
+
+		/*io fixҳ,ǿLRU batchsingle page flushд,
+		ֱеҳд(oldest_modification)fsync*/
+		n_dirty = 0;
+		for(i = 0; i < n_pages; i ++){
+			buf_pool = buf_pool_get(space, page_nos[i]);
+
+			mutex_enter(&(buf_pool->mutex));
+			block = buf_page_hash_get(buf_pool, space, page_nos[i]);
+			if(block != NULL && ut_dulint_cmp(block->oldest_modification, ut_dulint_zero) > 0)
+				n_dirty ++;
+			mutex_exit(&(buf_pool->mutex));
+		}
+
+		if(n_dirty == 0)
+			break;
+
+		os_thread_sleep(10000);
+	}
+
+	fil_flush(space);
+}
+
+/*һpages batch flushȴ,buf_pool == NULLʱȴʵ*/
+void buf_flush_wait_batch_end(buf_pool_t* buf_pool, ulint type)
+{
+	ulint i;
+
 	ut_ad((type == BUF_FLUSH_LRU) || (type == BUF_FLUSH_LIST));
-	os_event_wait(buf_pool->no_flush[type]);
+
+	if(buf_pool != NULL){
+		os_event_wait(buf_pool->no_flush[type]);
+		return;
+	}
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		os_event_wait(buf_pool_from_array(i)->no_flush[type]);
 }
 
-/*ͬʱˢ̵LRUеpageĸ*/
-static ulint buf_flush_LRU_recommendation()
+/*LRUβҪˢ̵page:free listLRUβscan_lenblockпֱûblockn_lowʱ,
+䵽n_high*/
+static ulint buf_flush_LRU_recommendation(buf_pool_t* buf_pool, ulint n_low, ulint n_high, ulint scan_len)
 {
 	buf_block_t*	block;
 	ulint		n_replaceable;
@@ -463,8 +700,7 @@ static ulint buf_flush_LRU_recommendation()
 	n_replaceable = UT_LIST_GET_LEN(buf_pool->free);
 	block = UT_LIST_GET_LAST(buf_pool->LRU);
 
-	while(block != NULL && n_replaceable < BUF_FLUSH_FREE_BLOCK_MARGIN + BUF_FLUSH_EXTRA_MARGIN
-		&& distance < BUF_LRU_FREE_SEARCH_LEN){
+	while(block != NULL && n_replaceable < n_high && distance < scan_len){
 			if(buf_flush_ready_for_replace(block))
 				n_replaceable ++;
 
@@ -474,21 +710,181 @@ static ulint buf_flush_LRU_recommendation()
 
 	mutex_exit(&(buf_pool->mutex));
 
-	if(n_replaceable >= BUF_FLUSH_FREE_BLOCK_MARGIN)
+	if(n_replaceable >= n_low)
 		return 0;
 
-	return (BUF_FLUSH_FREE_BLOCK_MARGIN + BUF_FLUSH_EXTRA_MARGIN - n_replaceable);
+	return n_high - n_replaceable;
 }
 
-void buf_flush_free_margin()
+/*û̷߳free blockʱápage cleanerʱֻ,ں̨LRUˢ;
+ͻָ׶page cleanerûн,ɵԼLRU batch*/
+void buf_flush_free_margin(buf_pool_t* buf_pool)
 {
-	ulint n_to_flush = buf_flush_LRU_recommendation();
+	ulint n_to_flush;
+
+	if(buf_page_cleaner_is_active){
+		os_event_set(buf_flush_page_cleaner_event);
+		return;
+	}
+
+	n_to_flush = buf_flush_LRU_recommendation(buf_pool, BUF_FLUSH_FREE_BLOCK_MARGIN(buf_pool),
+		BUF_FLUSH_FREE_BLOCK_MARGIN(buf_pool) + BUF_FLUSH_EXTRA_MARGIN(buf_pool), BUF_LRU_FREE_SEARCH_LEN(buf_pool));
 	if(n_to_flush > 0)
-		buf_flush_batch(BUF_FLUSH_LRU, n_to_flush, ut_dulint_zero);
+		buf_flush_batch(buf_pool, BUF_FLUSH_LRU, n_to_flush, ut_dulint_zero);
+}
+
+/*page cleanerʵLRUβˢ,ʹÿʵfree listLRUβֱûblocksrv_LRU_scan_depth,
+Щbatchɺˢɾblockfree list,û߳buf_LRU_get_free_blockпֱõfree block*/
+static ulint buf_flush_LRU_tail()
+{
+	buf_pool_t*	buf_pool;
+	ulint		n_target;
+	ulint		n_to_flush;
+	ulint		n_flushed;
+	ulint		total = 0;
+	ulint		i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+
+		n_target = ut_min(srv_LRU_scan_depth, buf_pool->curr_size / 4);
+		n_to_flush = buf_flush_LRU_recommendation(buf_pool, n_target, n_target, n_target);
+		if(n_to_flush == 0)
+			continue;
+
+		n_flushed = buf_flush_batch(buf_pool, BUF_FLUSH_LRU, n_to_flush, ut_dulint_zero);
+		if(n_flushed != ULINT_UNDEFINED)
+			total += n_flushed;
+	}
+
+	if(total > 0){
+		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LRU);
+		buf_LRU_try_free_flushed_blocks(NULL);
+	}
+
+	return total;
+}
+
+/*page cleaner߳:û̻߳ѻÿ1һLRUβˢ,ÿ밴redoٶһflush listˢ*/
+void* buf_flush_page_cleaner_thread(void* arg)
+{
+	time_t	last_time = 0;
+	time_t	now;
+	ulint	n_flush;
+
+	UT_NOT_USED(arg);
+
+	buf_page_cleaner_is_active = TRUE;
+
+	while(srv_shutdown_state < SRV_SHUTDOWN_CLEANUP){
+		os_event_wait_time(buf_flush_page_cleaner_event, 1000000);
+		/*ˢ֮ǰreset,ˢڼĻѻһʼ*/
+		os_event_reset(buf_flush_page_cleaner_event);
+
+		buf_flush_LRU_tail();
+
+		now = time(NULL);
+		if(now == last_time || srv_force_recovery >= SRV_FORCE_NO_BACKGROUND)
+			continue;
+
+		last_time = now;
+
+		/*redoٶȺcheckpoint ageƽˢҳ,ageֵͬˢ*/
+		buf_flush_stat_update();
+		if(srv_adaptive_flushing){
+			n_flush = buf_flush_get_desired_flush_rate();
+			if(n_flush > 0)
+				buf_flush_list(n_flush, ut_dulint_max);
+		}
+	}
+
+	/*shutdownʱû߳ԼˢLRU*/
+	buf_page_cleaner_is_active = FALSE;
+
+	os_thread_exit(0);
+
+	return NULL;
+}
+
+/*page cleanerÿһ,¼ϴεƽÿredo*/
+void buf_flush_stat_update()
+{
+	dulint	lsn;
+	time_t	now;
+	ulint	elapsed;
+	ulint	redo;
+
+	lsn = log_get_lsn();
+	now = time(NULL);
+
+	if(buf_flush_stat_last_time == 0){ /*һε*/
+		buf_flush_stat_last_lsn = lsn;
+		buf_flush_stat_last_time = now;
+		return;
+	}
+
+	/*page cleanerܱˢһʱ,ƽ*/
+	elapsed = (ulint)difftime(now, buf_flush_stat_last_time);
+	if(elapsed == 0)
+		return;
+
+	redo = ut_dulint_minus(lsn, buf_flush_stat_last_lsn) / elapsed;
+	buf_flush_stat_last_lsn = lsn;
+	buf_flush_stat_last_time = now;
+
+	buf_flush_stat_sum -= buf_flush_stat_arr[buf_flush_stat_arr_ind];
+	buf_flush_stat_arr[buf_flush_stat_arr_ind] = redo;
+	buf_flush_stat_sum += redo;
+
+	buf_flush_stat_arr_ind = (buf_flush_stat_arr_ind + 1) % BUF_FLUSH_STAT_N_INTERVAL;
+}
+
+/*һӦôflush listˢȥҳ,srv_io_capacity
+ҳҪredoдmax_modified_age_async֮ǰˢ,checkpoint ageֵһԺٰ*/
+ulint buf_flush_get_desired_flush_rate()
+{
+	buf_pool_t*		buf_pool;
+	ib_uint64_t		rate;
+	dulint			lsn;
+	dulint			oldest_lsn;
+	ulint			n_dirty = 0;
+	ulint			redo_avg;
+	ulint			age;
+	ulint			low_age;
+	ulint			i;
+
+	for(i = 0; i < buf_pool_instances; i ++){
+		buf_pool = buf_pool_from_array(i);
+
+		mutex_enter(&(buf_pool->mutex));
+		n_dirty += UT_LIST_GET_LEN(buf_pool->flush_list);
+		mutex_exit(&(buf_pool->mutex));
+	}
+
+	if(n_dirty == 0)
+		return 0;
+
+	lsn = log_get_lsn();
+	oldest_lsn = buf_pool_get_oldest_modification();
+	age = ut_dulint_is_zero(oldest_lsn) ? 0 : ut_dulint_minus(lsn, oldest_lsn);
+	low_age = log_sys->max_modified_age_async / 2;
+
+	/*redoٶˢ*/
+	redo_avg = buf_flush_stat_sum / BUF_FLUSH_STAT_N_INTERVAL;
+	rate = (ib_uint64_t)n_dirty * redo_avg / log_sys->max_modified_age_async;
+
+	/*checkpoint ageԽӽ첽ˢ̵ֵ,ˢԽ*/
+	if(age > low_age)
+		rate += (ib_uint64_t)srv_io_capacity * (age - low_age) / low_age;
+
+	if(rate > srv_io_capacity)
+		rate = srv_io_capacity;
+
+	return ut_min((ulint)rate, n_dirty);
 }
 
 /*blockstart_lsn˳*/
-static ibool buf_flush_validate_low(void)
+static ibool buf_flush_validate_low(buf_pool_t* buf_pool)
 {
 	buf_block_t*	block;
 	dulint		om;
@@ -513,13 +909,19 @@ static ibool buf_flush_validate_low(void)
 
 ibool buf_flush_validate()
 {
-	ibool	ret;
+	buf_pool_t*	buf_pool;
+	ibool		ret = TRUE;
+	ulint		i;
 
-	mutex_enter(&(buf_pool->mutex));
+	for(i = 0; i < buf_pool_instances && ret; i ++){
+		buf_pool = buf_pool_from_array(i);
 
-	ret = buf_flush_validate_low();
+		mutex_enter(&(buf_pool->mutex));
 
-	mutex_exit(&(buf_pool->mutex));
+		ret = buf_flush_validate_low(buf_pool);
+
+		mutex_exit(&(buf_pool->mutex));
+	}
 
 	return(ret);
 }
@@ -1,25 +1,48 @@
 #ifndef __buf0flu_h_
 #define __buf0flu_h_
 
-#include "unvi.h"
+#include "univ.h"
 #include "buf0types.h"
 #include "ut0byte.h"
 #include "mtr0types.h"
+#include "os0sync.h"
 
-#define BUF_FLUSH_FREE_BLOCK_MARGIN 	(5 + BUF_READ_AHEAD_AREA)
-#define BUF_FLUSH_EXTRA_MARGIN 			(BUF_FLUSH_FREE_BLOCK_MARGIN / 4 + 100)
+#define BUF_FLUSH_FREE_BLOCK_MARGIN(b) 	(5 + BUF_READ_AHEAD_AREA(b))
+#define BUF_FLUSH_EXTRA_MARGIN(b) 		(BUF_FLUSH_FREE_BLOCK_MARGIN(b) / 4 + 100)
 
+/*page cleaner̵߳¼*/
+extern os_event_t						buf_flush_page_cleaner_event;
+/*page cleaner߳Ƿ*/
+extern ibool							buf_page_cleaner_is_active;
+
+void									buf_flush_insert_into_flush_list(buf_block_t* block);
+
+void									buf_flush_insert_sorted_into_flush_list(buf_block_t* block);
+
+void									buf_flush_init_flush_rbt();
+
+void									buf_flush_free_flush_rbt();
 
 
 void									buf_flush_write_complete(buf_block_t* block);
 
-void									buf_flush_free_margin();
+void									buf_flush_free_margin(buf_pool_t* buf_pool);
 
 void									buf_flush_init_for_writing(byte* page, dulint newest_lsn, ulint space, ulint page_no);
 
-ulint									buf_flush_batch(ulint flush_type, ulint min_n, dulint lsn_limit);
+ulint									buf_flush_batch(buf_pool_t* buf_pool, ulint flush_type, ulint min_n, dulint lsn_limit);
+
+ulint									buf_flush_list(ulint min_n, dulint lsn_limit);
+
+void									buf_flush_pages(ulint space, ulint* page_nos, ulint n_pages);
+
+void									buf_flush_wait_batch_end(buf_pool_t* buf_pool, ulint type);
+
+void									buf_flush_stat_update();
+
+ulint									buf_flush_get_desired_flush_rate();
 
-void									buf_flush_wait_batch_end(ulint type);
+void*									buf_flush_page_cleaner_thread(void* arg);
 
 UNIV_INLINE void						buf_flush_note_modification(buf_block_t* block, mtr_t* mtr);
 
@@ -29,7 +52,7 @@ ibool									buf_flush_ready_for_replace(buf_block_t* block);
 
 ibool									buf_flush_validate();
 
-#include "buf0flu.h"
+#include "buf0flu.inl"
 
 #endif
 
@@ -9,6 +9,8 @@ void buf_flush_insert_sorted_into_flush_list(buf_block_t* block);
 /*ҳˢǰãҳstart_lsnend_lsn*/
 UNIV_INLINE void buf_flush_note_modification(buf_block_t* block, mtr_t* mtr)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(block);
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 	ut_ad(block->buf_fix_count > 0);
@@ -35,6 +37,8 @@ UNIV_INLINE void buf_flush_note_modification(buf_block_t* block, mtr_t* mtr)
 /*redo logʱҳstart_lsnend_lsn*/
 UNIV_INLINE void buf_flush_recv_note_modification(buf_block_t* block, dulint start_lsn, dulint end_lsn)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(block);
 	ut_ad(block->state == BUF_BLOCK_FILE_PAGE);
 	ut_ad(block->buf_fix_count > 0);
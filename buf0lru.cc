@@ -26,7 +26,7 @@ static void	buf_LRU_block_remove_hashed_page(buf_block_t* block);
 static void buf_LRU_block_free_hashed_page(buf_block_t* block);
 
 /*µblock->LRU_position - len / 8*/
-ulint buf_LRU_recent_limit()
+ulint buf_LRU_get_recent_limit(buf_pool_t* buf_pool)
 {
 	buf_block_t*	block;
 	ulint			len;
@@ -44,14 +44,18 @@ ulint buf_LRU_recent_limit()
 	limit = block->LRU_position - len / BUF_LRU_INITIAL_RATIO;
 
 	mutex_exit(&(buf_pool->mutex));
+
+	return limit;
 }
 
 /*ǷпԱûbuf_block,free buf_blockӦpage*/
-ibool buf_LRU_search_and_free_block(ulint n_iterations)
+ibool buf_LRU_search_and_free_block(buf_pool_t* buf_pool, ulint n_iterations)
 {
 	buf_block_t*	block;
 	ibool			freed;
 
+	mutex_enter(&(buf_pool->mutex));
+
 	freed = FALSE;
 	/*Ӻ濪ʼ,ΪLRUblockoldesṱoldest,ٿ̭new*/
 	block = UT_LIST_GET_LAST(buf_pool->LRU);
@@ -94,20 +98,30 @@ ibool buf_LRU_search_and_free_block(ulint n_iterations)
 }
 
 /*ԴLRU lisṱһЩbuf_block*/
-void buf_LRU_try_free_flushed_blocks()
+void buf_LRU_try_free_flushed_blocks(buf_pool_t* buf_pool)
 {
+	ulint i;
+
+	/*buf_pool == NULLʾеʵг*/
+	if(buf_pool == NULL){
+		for(i = 0; i < buf_pool_instances; i ++)
+			buf_LRU_try_free_flushed_blocks(buf_pool_from_array(i));
+
+		return;
+	}
+
 	mutex_enter(&(buf_pool->mutex));
 
 	while(buf_pool->LRU_flush_ended > 0){
 		mutex_exit(&(buf_pool->mutex));
-		buf_LRU_search_and_free_block(0);
+		buf_LRU_search_and_free_block(buf_pool, 0);
 		mutex_enter(&(buf_pool->mutex));
 	}
 
 	mutex_exit(&(buf_pool->mutex));
 }
 
-buf_block_t* buf_LRU_get_free_block()
+buf_block_t* buf_LRU_get_free_block(buf_pool_t* buf_pool)
 {
 	buf_block_t*	block		= NULL;
 	ibool		freed;
@@ -144,8 +158,8 @@ loop:
 	/*пûbuf_block,Ƚڴlruɾ*/
 	if(buf_pool->LRU_flush_ended > 0){
 		mutex_exit(&(buf_pool->mutex));
-		buf_LRU_try_free_flushed_blocks();
-		mutex_exit(&(buf_pool->mutex));
+		buf_LRU_try_free_flushed_blocks(buf_pool);
+		mutex_enter(&(buf_pool->mutex));
 	}
 	
 	/*buf_pool->free buf_block,ֱӴfree listлȡһbuf_block*/
@@ -165,7 +179,7 @@ loop:
 	mutex_exit(&(buf_pool->mutex));
 
 	/*ԽLRUпûblockͷ*/
-	freed = buf_LRU_search_and_free_block(n_iterations);
+	freed = buf_LRU_search_and_free_block(buf_pool, n_iterations);
 	if(freed)
 		goto loop;
 
@@ -199,9 +213,12 @@ loop:
 		srv_print_innodb_monitor = TRUE;
 	}
 
-	buf_flush_free_margin();
+	/*page cleanerʱֻǻ,LRU batchɺ*/
+	buf_flush_free_margin(buf_pool);
 	/*еIO߳*/
 	os_aio_simulated_wake_handler_threads();
+	if(buf_page_cleaner_is_active)
+		buf_flush_wait_batch_end(buf_pool, BUF_FLUSH_LRU);
 	if(n_iterations > 10)
 		os_thread_sleep(500000);
 
@@ -211,7 +228,7 @@ loop:
 }
 
 /*ȷold/new listķֽ*/
-UNIV_INLINE void buf_LRU_old_adjust_len()
+UNIV_INLINE void buf_LRU_old_adjust_len(buf_pool_t* buf_pool)
 {
 	ulint old_len;
 	ulint new_len;
@@ -242,7 +259,7 @@ UNIV_INLINE void buf_LRU_old_adjust_len()
 	}
 }
 
-static void buf_LRU_old_init()
+static void buf_LRU_old_init(buf_pool_t* buf_pool)
 {
 	buf_block_t* block;
 
@@ -259,11 +276,13 @@ static void buf_LRU_old_init()
 	buf_pool->LRU_old_len = UT_LIST_GET_LEN(buf_pool->LRU);
 
 	/*old listnew listָȷ*/
-	buf_LRU_old_adjust_len();
+	buf_LRU_old_adjust_len(buf_pool);
 }
 
 UNIV_INLINE void buf_LRU_remove_block(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(buf_pool);
 	ut_ad(block);
 	ut_ad(mutex_own(&(buf_pool->mutex)));
@@ -288,12 +307,14 @@ UNIV_INLINE void buf_LRU_remove_block(buf_block_t* block)
 	if(block->old) /*blockold listУ޸old_len*/
 		buf_pool->LRU_old_len --;
 
-	buf_LRU_old_adjust_len();
+	buf_LRU_old_adjust_len(buf_pool);
 }
 
 /*LRU listĩβһbuf_block*/
 UNIV_INLINE void buf_LRU_add_block_to_end_low(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	buf_block_t* last_block;
 
 	ut_ad(buf_pool);
@@ -307,7 +328,7 @@ UNIV_INLINE void buf_LRU_add_block_to_end_low(buf_block_t* block)
 	if(last_block != NULL)/*ȷLRU_position*/
 		block->LRU_position = last_block->LRU_position;
 	else
-		block->LRU_position = buf_pool_clock_tic();
+		block->LRU_position = buf_pool_clock_tic(buf_pool);
 
 	/*block뵽LRUĩβ*/
 	UT_LIST_ADD_LAST(LRU, buf_pool->LRU, block);
@@ -317,15 +338,16 @@ UNIV_INLINE void buf_LRU_add_block_to_end_low(buf_block_t* block)
 	/*newoldָȷ*/
 	if(UT_LIST_GET_LEN(buf_pool->LRU) > BUF_LRU_OLD_MIN_LEN){ /*ѾBUF_LRU_OLD_MIN_LENȷָ*/
 		ut_ad(buf_pool->LRU_old);
-		buf_LRU_old_adjust_len();
+		buf_LRU_old_adjust_len(buf_pool);
 	}
 	else if(UT_LIST_GET_LEN(buf_pool->LRU) == BUF_LRU_OLD_MIN_LEN) /*ոմﵽold list̵СȣԽȷnew listold listķָ*/
-		buf_LRU_old_init();
+		buf_LRU_old_init(buf_pool);
 }
 
 UNIV_INLINE void buf_LRU_add_block_low(buf_block_t* block, ibool old)
 {
-	ulint	cl;
+	buf_pool_t*	buf_pool = buf_pool_from_block(block);
+	ulint		cl;
 
 	ut_ad(buf_pool);
 	ut_ad(block);
@@ -333,7 +355,7 @@ UNIV_INLINE void buf_LRU_add_block_low(buf_block_t* block, ibool old)
 
 	/*ȷblockλú*/
 	block->old = old;
-	cl = buf_pool_clock_tic();
+	cl = buf_pool_clock_tic(buf_pool);
 
 	/*blockǼ뵽new listLRUĳȲBUF_LRU_OLD_MIN_LEN,ôblock뵽lru һλ*/
 	if(!old || (UT_LIST_GET_LEN(buf_pool->LRU) < BUF_LRU_OLD_MIN_LEN)){
@@ -352,10 +374,10 @@ UNIV_INLINE void buf_LRU_add_block_low(buf_block_t* block, ibool old)
 	/*ȷָ*/
 	if(UT_LIST_GET_LEN(buf_pool->LRU) > BUF_LRU_OLD_MIN_LEN){
 		ut_ad(buf_pool->LRU_old);
-		buf_LRU_old_adjust_len();
+		buf_LRU_old_adjust_len(buf_pool);
 	}
 	else if(UT_LIST_GET_LEN(buf_pool->LRU) == BUF_LRU_OLD_MIN_LEN)
-		buf_LRU_old_init();
+		buf_LRU_old_init(buf_pool);
 }
 
 void buf_LRU_add_block(buf_block_t* block, ibool old)
@@ -380,6 +402,8 @@ void buf_LRU_make_block_old(buf_block_t* block)
 /*buf_block뵽buf_poolfree*/
 void buf_LRU_block_free_non_file_page(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block);
 
@@ -391,6 +415,8 @@ void buf_LRU_block_free_non_file_page(buf_block_t* block)
 /*blockLRUɾҽbuf_block루space id, page_noĹϣӦϵ*/
 static void buf_LRU_block_remove_hashed_page(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block);
 
@@ -403,6 +429,10 @@ static void buf_LRU_block_remove_hashed_page(buf_block_t* block)
 	/*buf_blockLRUɾ*/
 	buf_LRU_remove_block(block);
 
+	/*ԤpageһζûбʹһЧԤ*/
+	if(block->read_ahead && !block->accessed)
+		buf_pool->n_ra_pages_evicted ++;
+
 	buf_pool->freed_page_clock ++;
 	/*block->modify_clockԼ*/
 	buf_frame_modify_clock_inc(block->frame);
@@ -416,6 +446,8 @@ static void buf_LRU_block_remove_hashed_page(buf_block_t* block)
 /*blockfree list*/
 static void buf_LRU_block_free_hashed_page(buf_block_t* block)
 {
+	buf_pool_t* buf_pool = buf_pool_from_block(block);
+
 	ut_ad(mutex_own(&(buf_pool->mutex)));
 	ut_ad(block->state == BUF_BLOCK_REMOVE_HASH);
 
@@ -425,7 +457,7 @@ static void buf_LRU_block_free_hashed_page(buf_block_t* block)
 }
 
 /*LRU listĺϷ*/
-ibool buf_LRU_validate(void)
+static ibool buf_LRU_validate_instance(buf_pool_t* buf_pool)
 {
 	buf_block_t*	block;
 	ulint		old_len;
@@ -486,8 +518,18 @@ ibool buf_LRU_validate(void)
 	return(TRUE);
 }
 
+ibool buf_LRU_validate(void)
+{
+	ulint i;
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		ut_a(buf_LRU_validate_instance(buf_pool_from_array(i)));
+
+	return(TRUE);
+}
+
 /*LRUеϢдӡ*/
-void buf_LRU_print(void)
+static void buf_LRU_print_instance(buf_pool_t* buf_pool)
 {
 	buf_block_t*	block;
 	buf_frame_t*	frame;
@@ -496,7 +538,7 @@ void buf_LRU_print(void)
 	ut_ad(buf_pool);
 	mutex_enter(&(buf_pool->mutex));
 
-	printf("Pool ulint clock %lu\n", buf_pool->ulint_clock);
+	printf("Pool instance %lu ulint clock %lu\n", buf_pool->instance_no, buf_pool->ulint_clock);
 
 	block = UT_LIST_GET_FIRST(buf_pool->LRU);
 
@@ -533,3 +575,11 @@ void buf_LRU_print(void)
 	mutex_exit(&(buf_pool->mutex));
 }
 
+void buf_LRU_print(void)
+{
+	ulint i;
+
+	for(i = 0; i < buf_pool_instances; i ++)
+		buf_LRU_print_instance(buf_pool_from_array(i));
+}
+
@@ -10,16 +10,17 @@
 #include "buf0types.h"
 
 #define BUF_LRU_OLD_MIN_LEN		80
-#define BUF_LRU_FREE_SEARCH_LEN (5 + 2 * BUF_READ_AHEAD_AREA)
+#define BUF_LRU_FREE_SEARCH_LEN(b) (5 + 2 * BUF_READ_AHEAD_AREA(b))
 
 
-void							buf_LRU_try_free_flushed_blocks();
-ulint							buf_LRU_get_recent_limit();
-buf_block_t*					buf_LRU_get_free_block();
+void							buf_LRU_try_free_flushed_blocks(buf_pool_t* buf_pool);
+ulint							buf_LRU_get_recent_limit(buf_pool_t* buf_pool);
+buf_block_t*					buf_LRU_get_free_block(buf_pool_t* buf_pool);
 void							buf_LRU_block_free_non_file_page(buf_block_t* block);
 void							buf_LRU_add_block(buf_block_t* block, ibool old);
 void							buf_LRU_make_block_young(buf_block_t* block);
-void							buf_LRU_search_and_free_block(ulint n_iterations);
+void							buf_LRU_make_block_old(buf_block_t* block);
+ibool							buf_LRU_search_and_free_block(buf_pool_t* buf_pool, ulint n_iterations);
 
 ibool							buf_LRU_validate();
 void							buf_LRU_print();
@@ -11,20 +11,22 @@
 #include "trx0sys.h"
 #include "os0file.h"
 #include "srv0start.h"
+#include "srv0srv.h"
 
 
-#define BUF_READ_AHEAD_RANDOM_AREA			BUF_READ_AHEAD_AREA
+#define BUF_READ_AHEAD_RANDOM_AREA(b)		BUF_READ_AHEAD_AREA(b)
 
-#define BUF_READ_AHEAD_RANDOM_THRESHOLD		(5 + BUF_READ_AHEAD_RANDOM_AREA / 8)
+#define BUF_READ_AHEAD_RANDOM_THRESHOLD(b)	(5 + BUF_READ_AHEAD_RANDOM_AREA(b) / 8)
 
-#define BUF_READ_AHEAD_LINEAR_AREA			BUF_READ_AHEAD_AREA
+#define BUF_READ_AHEAD_LINEAR_AREA(b)		BUF_READ_AHEAD_AREA(b)
 
-#define BUF_READ_AHEAD_LINEAR_THRESHOLD		(3 * BUF_READ_AHEAD_LINEAR_AREA / 8)
+/*ôpage˳򱻷ʹŴԤ,srv_read_ahead_threshold64pageԵ*/
+#define BUF_READ_AHEAD_LINEAR_THRESHOLD(b)	(srv_read_ahead_threshold * BUF_READ_AHEAD_LINEAR_AREA(b) / 64)
 
 #define BUF_READ_AHEAD_PEND_LIMIT			2
 
-/*Ӵ϶ȡһҳ*/
-static ulint buf_read_page_low(ibool sync, ulint mode, ulint space, ulint offset)
+/*Ӵ϶ȡһҳ,read_aheadʾԤĶ*/
+static ulint buf_read_page_low(ibool sync, ulint mode, ulint space, ulint offset, ibool read_ahead)
 {
 	buf_block_t* block;
 	ulint		 wake_later;
@@ -45,6 +47,9 @@ static ulint buf_read_page_low(ibool sync, ulint mode, ulint space, ulint offset
 	/*pageӦbuf_blockжʼ*/
 	block = buf_page_init_for_read(mode, space, offset);
 	if(block != NULL){
+		/*ڶ֮ǰblockᱻ̭;ڼķʻaccessedΪTRUE,̭ʱʶһж*/
+		block->read_ahead = read_ahead;
+
 		if(buf_debug_prints)
 			printf("Posting read request for page %lu, sync %lu\n", offset, sync);
 
@@ -60,8 +65,9 @@ static ulint buf_read_page_low(ibool sync, ulint mode, ulint space, ulint offset
 }
 
 /*Ԥ*/
-static void ulint buf_read_ahead_random(ulint space, ulint offset)
+static ulint buf_read_ahead_random(ulint space, ulint offset)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	ulint		recent_blocks	= 0;
 	ulint		count;
@@ -77,14 +83,17 @@ static void ulint buf_read_ahead_random(ulint space, ulint offset)
 	if(ibuf_bitmap_page(offset) || trx_sys_hdr_page(space, offset))
 		return 0;
 
-	low  = (offset / BUF_READ_AHEAD_RANDOM_AREA) * BUF_READ_AHEAD_RANDOM_AREA;
-	high = (offset / BUF_READ_AHEAD_RANDOM_AREA + 1) * BUF_READ_AHEAD_RANDOM_AREA;
+	/*Ԥ򲻳64pageеpageͬһʵ*/
+	buf_pool = buf_pool_get(space, offset);
+
+	low  = (offset / BUF_READ_AHEAD_RANDOM_AREA(buf_pool)) * BUF_READ_AHEAD_RANDOM_AREA(buf_pool);
+	high = (offset / BUF_READ_AHEAD_RANDOM_AREA(buf_pool) + 1) * BUF_READ_AHEAD_RANDOM_AREA(buf_pool);
 
 	/*ȷhightable space߷Χ*/
 	if(high > fil_space_get_size(space))
 		high = fil_space_get_size(space);
 
-	LRU_recent_limit = buf_LRU_get_recent_limit();
+	LRU_recent_limit = buf_LRU_get_recent_limit(buf_pool);
 
 	mutex_enter(&(buf_pool->mutex));
 	/*ڶ̵pagebuf_poolʹõpageһ룬Ԥ*/
@@ -95,14 +104,14 @@ static void ulint buf_read_ahead_random(ulint space, ulint offset)
 
 	/*[low, high]֮pageжʹģbuf_blockLRUµbuf_block*/
 	for(i = low; i < high; i ++){
-		block = buf_page_hash_get(space, i);
+		block = buf_page_hash_get(buf_pool, space, i);
 		if(block != NULL && block->LRU_position > LRU_recent_limit && block->accessed)
 			recent_blocks++;
 	}
 
 	mutex_exit(&(buf_pool->mutex));
 	/*ʹĿ̫,ҪԤ*/
-	if(recent_blocks < BUF_READ_AHEAD_RANDOM_THRESHOLD)
+	if(recent_blocks < BUF_READ_AHEAD_RANDOM_THRESHOLD(buf_pool))
 		return 0;
 
 	/*жǷȡibufеpage*/
@@ -115,12 +124,16 @@ static void ulint buf_read_ahead_random(ulint space, ulint offset)
 
 	for(i = low; i < high; i ++){
 		if(!ibuf_bitmap_page(i))
-			count += buf_read_page_low(FALSE, ibuf_mode | OS_AIO_SIMULATED_WAKE_LATER, space, i);
+			count += buf_read_page_low(FALSE, ibuf_mode | OS_AIO_SIMULATED_WAKE_LATER, space, i, TRUE);
 	}
 
-	/*еIO߳*/
+	/*еIO߳,native aioύĶ*/
 	os_aio_simulated_wake_handler_threads();
 
+	mutex_enter(&(buf_pool->mutex));
+	buf_pool->n_ra_pages_read += count;
+	mutex_exit(&(buf_pool->mutex));
+
 	if(buf_debug_prints && (count > 0))
 		printf("Random read-ahead space %lu offset %lu pages %lu\n", space, offset, count);
 
@@ -133,9 +146,9 @@ ulint buf_read_page(ulint space, ulint offset)
 
 	count = buf_read_ahead_random(space, offset);
 	/*ͬȡ*/
-	count2 = buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, offset);
+	count2 = buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, offset, FALSE);
 
-	buf_flush_free_margin();
+	buf_flush_free_margin(buf_pool_get(space, offset));
 
 	return count + count2;
 }
@@ -143,6 +156,7 @@ ulint buf_read_page(ulint space, ulint offset)
 /*˳Ԥ*/
 ulint buf_read_ahead_linear(ulint space, ulint offset)
 {
+	buf_pool_t*		buf_pool;
 	buf_block_t*	block;
 	buf_frame_t*	frame;
 	buf_block_t*	pred_block	= NULL;
@@ -152,6 +166,7 @@ ulint buf_read_ahead_linear(ulint space, ulint offset)
 	int		asc_or_desc;
 	ulint		new_offset;
 	ulint		fail_count;
+	ulint		threshold;
 	ulint		ibuf_mode;
 	ulint		low, high;
 	ulint		i;
@@ -163,8 +178,10 @@ ulint buf_read_ahead_linear(ulint space, ulint offset)
 	if(ibuf_bitmap_page(offset) || trx_sys_hdr_page(space, offset))
 		return 0;
 
-	low  = (offset / BUF_READ_AHEAD_LINEAR_AREA) * BUF_READ_AHEAD_LINEAR_AREA;
-	high = (offset / BUF_READ_AHEAD_LINEAR_AREA + 1) * BUF_READ_AHEAD_LINEAR_AREA;
+	buf_pool = buf_pool_get(space, offset);
+
+	low  = (offset / BUF_READ_AHEAD_LINEAR_AREA(buf_pool)) * BUF_READ_AHEAD_LINEAR_AREA(buf_pool);
+	high = (offset / BUF_READ_AHEAD_LINEAR_AREA(buf_pool) + 1) * BUF_READ_AHEAD_LINEAR_AREA(buf_pool);
 
 	/*page_no[low, high)ı߽*/
 	if(offset != low && offset != high - 1)
@@ -180,24 +197,32 @@ ulint buf_read_ahead_linear(ulint space, ulint offset)
 		return(0);
 	}
 
+	/*ĵͶ˴˵ǽʣʵpageLRU_position*/
 	asc_or_desc = 1;
+	if(offset == low)
+		asc_or_desc = -1;
+
+	/*ͳûбʻûаշʷ򱻷ʵpage,ֵͲԤ*/
+	threshold = BUF_READ_AHEAD_LINEAR_AREA(buf_pool) - ut_min(BUF_READ_AHEAD_LINEAR_THRESHOLD(buf_pool), BUF_READ_AHEAD_LINEAR_AREA(buf_pool));
+	fail_count = 0;
 	for(i = low; i < high; i ++){
-		block = buf_page_hash_get(space, i);
+		block = buf_page_hash_get(buf_pool, space, i);
 		if(block == NULL || !block->accessed)
 			fail_count ++;
-		else if(pred_block && ut_ulint_cmp(block->LRU_position, pred_block->LRU_position) != asc_or_desc){
+		else if(pred_block && ut_ulint_cmp(block->LRU_position, pred_block->LRU_position) != asc_or_desc)
 			fail_count ++;
-			pred_block = block;
+
+		/*̫ҪӴ϶ȡpage*/
+		if(fail_count > threshold){
+			mutex_exit(&(buf_pool->mutex));
+			return 0;
 		}
-	}
 
-	/*̫ҪӴ϶ȡpage*/
-	if (fail_count > BUF_READ_AHEAD_LINEAR_AREA - BUF_READ_AHEAD_LINEAR_THRESHOLD){
-		mutex_exit(&(buf_pool->mutex));
-		return 0;
+		if(block != NULL && block->accessed)
+			pred_block = block;
 	}
 
-	block = buf_page_hash_get(space, offset);
+	block = buf_page_hash_get(buf_pool, space, offset);
 	if(block == NULL){
 		mutex_exit(&(buf_pool->mutex));
 		return 0;
@@ -217,8 +242,8 @@ ulint buf_read_ahead_linear(ulint space, ulint offset)
 	else
 		return 0;
 
-	low  = (new_offset / BUF_READ_AHEAD_LINEAR_AREA) * BUF_READ_AHEAD_LINEAR_AREA;
-	high = (new_offset / BUF_READ_AHEAD_LINEAR_AREA + 1) * BUF_READ_AHEAD_LINEAR_AREA;
+	low  = (new_offset / BUF_READ_AHEAD_LINEAR_AREA(buf_pool)) * BUF_READ_AHEAD_LINEAR_AREA(buf_pool);
+	high = (new_offset / BUF_READ_AHEAD_LINEAR_AREA(buf_pool) + 1) * BUF_READ_AHEAD_LINEAR_AREA(buf_pool);
 	if(new_offset != low && new_offset != high - 1)
 		return 0;
 
@@ -235,12 +260,16 @@ ulint buf_read_ahead_linear(ulint space, ulint offset)
 
 	for(i = low; i < high; i ++){
 		if (!ibuf_bitmap_page(i))
-			count += buf_read_page_low(FALSE, ibuf_mode | OS_AIO_SIMULATED_WAKE_LATER, space, i);
+			count += buf_read_page_low(FALSE, ibuf_mode | OS_AIO_SIMULATED_WAKE_LATER, space, i, TRUE);
 	}
 
 	os_aio_simulated_wake_handler_threads();
 
-	buf_flush_free_margin();
+	mutex_enter(&(buf_pool->mutex));
+	buf_pool->n_ra_pages_read += count;
+	mutex_exit(&(buf_pool->mutex));
+
+	buf_flush_free_margin(buf_pool);
 
 	if(buf_debug_prints && count > 0)
 		printf( "LINEAR read-ahead space %lu offset %lu pages %lu\n", space, offset, count);
@@ -250,32 +279,40 @@ ulint buf_read_ahead_linear(ulint space, ulint offset)
 /*һ԰Ҫϲibuf treeļ¼ڵpageȫ뻺أҳ뵽ʱibuf_merge_or_delete_for_pageibuf¼鲢*/
 void buf_read_ibuf_merge_pages(ibool sync, ulint space, ulint* page_nos, ulint n_stored)
 {
-	ut_ad(!buf_inside());
+	buf_pool_t*	buf_pool;
+	ulint		i;
 
-	/*̫ĶIOȴ*/
-	while(buf_pool->n_pend_reads > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT)
-		os_thread_sleep(500000);
+	ut_ad(!buf_inside());
 
 	for(i = 0; i < n_stored; i ++){
+		buf_pool = buf_pool_get(space, page_nos[i]);
+
+		/*̫ĶIOȴ*/
+		while(buf_pool->n_pend_reads > buf_pool->curr_size / BUF_READ_AHEAD_PEND_LIMIT)
+			os_thread_sleep(500000);
+
 		if(i + 1 == n_stored && sync)
-			buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, page_nos[i]);
+			buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, page_nos[i], FALSE);
 		else
-			buf_read_page_low(FALSE, BUF_READ_ANY_PAGE, space, page_nos[i]);
+			buf_read_page_low(FALSE, BUF_READ_ANY_PAGE, space, page_nos[i], FALSE);
 	}
 
-	buf_flush_free_margin();
+	for(i = 0; i < buf_pool_instances; i ++)
+		buf_flush_free_margin(buf_pool_from_array(i));
 
 	if(buf_debug_prints)
 		printf("Ibuf merge read-ahead space %lu pages %lu\n", space, n_stored);
 }
 
 /*redo logݵʱȡҪ޸ĵҳ*/
-void buf_read_recv_pages(iool sync, ulint space, ulint* page_nos, ulint n_stored)
+void buf_read_recv_pages(ibool sync, ulint space, ulint* page_nos, ulint n_stored)
 {
-	ulint	count;
-	ulint	i;
+	buf_pool_t*	buf_pool;
+	ulint		count;
+	ulint		i;
 
 	for(i = 0; i < n_stored; i ++){
+		buf_pool = buf_pool_get(space, page_nos[i]);
 		count = 0;
 		os_aio_print_debug = FALSE;
 		while(buf_pool->n_pend_reads >= RECV_POOL_N_FREE_BLOCKS / 2){
@@ -295,14 +332,15 @@ void buf_read_recv_pages(iool sync, ulint space, ulint* page_nos, ulint n_stored
 		os_aio_print_debug = FALSE;
 
 		if(i + 1 == n_stored && sync) /*һΪͬȡ*/
-			buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, page_nos[i]);
+			buf_read_page_low(TRUE, BUF_READ_ANY_PAGE, space, page_nos[i], FALSE);
 		else
-			buf_read_page_low(FALSE, BUF_READ_ANY_PAGE | OS_AIO_SIMULATED_WAKE_LATER, space, page_nos[i]);
+			buf_read_page_low(FALSE, BUF_READ_ANY_PAGE | OS_AIO_SIMULATED_WAKE_LATER, space, page_nos[i], FALSE);
 	}
 
 	os_aio_simulated_wake_handler_threads();
 
-	buf_flush_free_margin();
+	for(i = 0; i < buf_pool_instances; i ++)
+		buf_flush_free_margin(buf_pool_from_array(i));
 
 	if(buf_debug_prints)
 		printf("Recovery applies read-ahead pages %lu\n", n_stored);
@@ -11,7 +11,7 @@
 #include "buf0types.h"
 #include "buf0buf.h"
 
-#define	BUF_READ_AHEAD_AREA				ut_min(64, ut_2_power_up(buf_pool->curr_size / 32))
+#define	BUF_READ_AHEAD_AREA(b)			ut_min(64, ut_2_power_up((b)->curr_size / 32))
 
 /* Modes used in read-ahead */
 #define BUF_READ_IBUF_PAGES_ONLY		131
@@ -20,7 +20,7 @@
 ulint									buf_read_page(ulint space, ulint offset);
 ulint									buf_read_ahead_linear(ulint space, ulint offset);
 void									buf_read_ibuf_merge_pages(ibool sync, ulint space, ulint* page_nos, ulint n_stored);
-void									buf_read_recv_pages(iool sync, ulint space, ulint* page_nos, ulint n_stored);
+void									buf_read_recv_pages(ibool sync, ulint space, ulint* page_nos, ulint n_stored);
 
 #endif
 
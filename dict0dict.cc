@@ -33,7 +33,6 @@ static void dict_col_reposition_in_cache(dict_table_t* table, dict_col_t* col, c
 
 static void dict_col_remove_from_cache(dict_table_t* table, dict_col_t* col);
 
-static void dict_index_remove_from_cache(dict_table_t* table, dict_index_t* index);
 
 UNIV_INLINE void dict_index_add_col(dict_index_t* index, dict_col_t* col, ulint order);
 
@@ -674,8 +673,8 @@ ibool dict_index_add_to_cache(dict_table_t* table, dict_index_t* index)
 	return TRUE;
 }
 
-/*indexֵcacheɾ*/
-static void dict_index_remove_from_cache(dict_table_t* table, dict_index_t* index)
+/*indexֵcacheɾ,ʧʱҲһûύ*/
+void dict_index_remove_from_cache(dict_table_t* table, dict_index_t* index)
 {
 	dict_field_t*	field;
 	ulint		size;
@@ -1656,8 +1655,15 @@ dtuple_t* dict_tree_build_node_ptr(dict_tree_t* tree, rec_t* rec, ulint page_no,
 	/*Ҫ͸е*/
 	dtuple_set_n_fields_cmp(tuple, n_unique);
 	dict_index_copy_types(tuple, ind, n_unique);
-	/*recݿtuple*/
+	/*һָӽڵpage_no*/
+	buf = mem_heap_alloc(heap, 4);
+	mach_write_to_4(buf, page_no);
+
+	field = dtuple_get_nth_field(tuple, n_unique);
+	dfield_set_data(field, buf, 4);
 	dtype_set(dfield_get_type(field), DATA_SYS_CHILD, 0, 0, 0);
+
+	/*recݿtuple*/
 	rec_copy_prefix_to_dtuple(tuple, rec, n_unique, heap);
 
 	return tuple;
@@ -1676,6 +1682,8 @@ rec_t* dict_tree_copy_rec_order_prefix(dict_tree_t* tree, rec_t* rec, byte** buf
 		n_fields = rec_get_n_fields(rec);
 
 	order_rec = rec_copy_prefix_to_buf(rec, n_fields, buf, buf_size);
+
+	return order_rec;
 }
 
 /*Builds a typed data tuple out of a physical record. */
@@ -126,6 +126,8 @@ dict_index_t*						dict_index_find_on_id_low(dulint id);
 
 ibool								dict_index_add_to_cache(dict_table_t* table, dict_index_t* index);
 
+void								dict_index_remove_from_cache(dict_table_t* table, dict_index_t* index);
+
 UNIV_INLINE ulint					dict_index_get_n_fields(dict_index_t* index);
 
 UNIV_INLINE ulint					dict_index_get_n_unique(dict_index_t* index);
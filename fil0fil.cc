@@ -789,7 +789,9 @@ void fil_aio_wait(ulint segment)
 
 	if(os_aio_use_native_aio){ /*ϵͳaio*/
 		srv_io_thread_op_info[segment] = "native aio handle";
-#ifdef POSIX_ASYNC_IO
+#if defined(LINUX_NATIVE_AIO)
+		ret = os_aio_linux_handle(segment, (void**)&fil_node, &message, &type);
+#elif defined(POSIX_ASYNC_IO)
 		ret = os_aio_posix_handle(segment, &fil_node, &message);
 #else
 		ret = 0; /* Eliminate compiler warning */
@@ -863,7 +863,7 @@ static ulint ibuf_get_merge_page_nos(ibool contract, rec_t* first_rec, ulint* pa
 
 	*n_stored = 0;
 
-	limit = ut_min(IBUF_MAX_N_PAGES_MERGED, buf_pool->curr_size / 4);
+	limit = ut_min(IBUF_MAX_N_PAGES_MERGED, buf_pool_get_curr_size() / UNIV_PAGE_SIZE / 4);
 
 	page = uf_frame_align(first_rec);
 
@@ -41,7 +41,7 @@ UNIV_INLINE ibool	ibuf_should_try(dict_index_t* index, ulint ignore_sec_unique)
 	if(!(index->type & DICT_CLUSTERED) && (ignore_sec_unique || !(index->type & DICT_UNIQUE)) && ibuf->meter > IBUF_THRESHOLD){
 		ibuf_flush_count ++;
 		if(ibuf_flush_count % 8 == 0) /*ԽLRUѾ̵blocksͷŵfree list*/
-			buf_LRU_try_free_flushed_blocks();
+			buf_LRU_try_free_flushed_blocks(NULL);
 
 		return TRUE;
 	}
@@ -52,14 +52,50 @@ static ibool		lock_deadlock_occurs(lock_t* lock, trx_t* trx);
 static ibool		lock_deadlock_recursive(trx_t* start, trx_t* trx, lock_t* wait_lock, ulint* cost);
 
 /************************************************************************/
-/*kernel_mutexsrv0srv.hȫںmutex latch*/
+/*(space, page_no)Ӧҳrec_hashƬmutex,ͬһҳϵͬһƬ*/
+mutex_t* lock_rec_get_mutex_for_addr(ulint space, ulint page_no)
+{
+	return lock_sys->rec_mutexes + ut_2pow_remainder(lock_rec_hash(space, page_no), lock_sys->n_rec_mutexes);
+}
+
+/*ptrҳӦrec_hashƬmutex*/
+UNIV_INLINE mutex_t* lock_rec_get_mutex(byte* ptr)
+{
+	return lock_sys->rec_mutexes + ut_2pow_remainder(buf_frame_get_lock_hash_val(ptr), lock_sys->n_rec_mutexes);
+}
+
+/*ƬŴСrec_hashƬmutex*/
+static void lock_rec_mutex_enter_all()
+{
+	ulint i;
+
+	for(i = 0; i < lock_sys->n_rec_mutexes; i ++)
+		mutex_enter(lock_sys->rec_mutexes + i);
+}
+
+/*ͷrec_hashƬmutex*/
+static void lock_rec_mutex_exit_all()
+{
+	ulint i;
+
+	for(i = lock_sys->n_rec_mutexes; i > 0; i --)
+		mutex_exit(lock_sys->rec_mutexes + i - 1);
+}
+
+/*kernel_mutexsrv0srv.hȫںmutex latch
+ϵͳȫ·kernel_mutexٰrec_hashƬmutex,ȴ⡢
+ʽתҳѺϲʱǨƺͷ·Ҫȴȡ(·)ֻ
+¼ҳķƬmutexlatch˳Ϊkernel_mutex -> Ƭmutex(ŴС)зƬmutexʱ
+ȥkernel_mutex*/
 UNIV_INLINE void lock_mutex_enter_kernel()
 {
 	mutex_enter(&kernel_mutex);
+	lock_rec_mutex_enter_all();
 }
 
 UNIV_INLINE void lock_mutex_exit_kernel()
 {
+	lock_rec_mutex_exit_all();
 	mutex_exit(&kernel_mutex);
 }
 
@@ -100,10 +136,21 @@ ulint  lock_sec_rec_cons_read_sees(rec_t* rec, dict_index_t* index, read_view_t*
 /*һϵͳϣ*/
 void lock_sys_create(ulint n_cells)
 {
+	ulint i;
+
 	/*lock sys*/
 	lock_sys = mem_alloc(sizeof(lock_sys_t));
 	/*һlock_sysеĹϣ*/
 	lock_sys->rec_hash = hash_create(n_cells);
+
+	/*rec_hashķƬmutex,Ƭ2*/
+	ut_a(srv_lock_rec_hash_parts > 0 && ut_is_2pow(srv_lock_rec_hash_parts));
+	lock_sys->n_rec_mutexes = srv_lock_rec_hash_parts;
+	lock_sys->rec_mutexes = mem_alloc(lock_sys->n_rec_mutexes * sizeof(mutex_t));
+	for(i = 0; i < lock_sys->n_rec_mutexes; i ++){
+		mutex_create(lock_sys->rec_mutexes + i);
+		mutex_set_level(lock_sys->rec_mutexes + i, SYNC_NO_ORDER_CHECK);
+	}
 	/*ϢĻ*/
 	lock_latest_err_buf = mem_alloc(5000);
 }
@@ -343,11 +390,11 @@ UNIV_INLINE lock_t* lock_rec_get_next_on_page(lock_t* lock)
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(mutex_own(&kernel_mutex));
-
 	space = lock->un_member.rec_lock.space;
 	page_no = lock->un_member.rec_lock.page_no;
 
+	ut_ad(mutex_own(lock_rec_get_mutex_for_addr(space, page_no)));
+
 	/*lock_sysĹϣв*/
 	for(;;){
 		lock = HASH_GET_NEXT(hash, lock);
@@ -355,7 +402,7 @@ UNIV_INLINE lock_t* lock_rec_get_next_on_page(lock_t* lock)
 			break;
 
 		/*LOCKͬһҳ*/
-		if(lock->un_member.rec_lock.space == space && lock->un_member.rec_lock.page_no = page_no)
+		if(lock->un_member.rec_lock.space == space && lock->un_member.rec_lock.page_no == page_no)
 			break;
 	}
 
@@ -367,7 +414,7 @@ UNIV_INLINE lock_t* lock_rec_get_first_on_page_addr(ulint space, ulint page_no)
 {
 	lock_t* lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(lock_rec_get_mutex_for_addr(space, page_no)));
 
 	/*lock_sysϣ*/
 	lock = HASH_GET_FIRST(lock_sys->rec_hash, lock_rec_hash(space, page_no));
@@ -385,15 +432,18 @@ UNIV_INLINE lock_t* lock_rec_get_first_on_page_addr(ulint space, ulint page_no)
 /*жϣspace page_noָҳǷʽ*/
 ibool lock_rec_expl_exist_on_page(ulint space, ulint page_no)
 {
-	ibool ret;
+	ibool		ret;
+	mutex_t*	rec_mutex;
 
-	mutex_enter(&kernel_mutex);
+	/*ֻҪҳӦķƬmutex*/
+	rec_mutex = lock_rec_get_mutex_for_addr(space, page_no);
+	mutex_enter(rec_mutex);
 	if(lock_rec_get_first_on_page_addr(space, page_no))
 		ret = TRUE;
 	else
 		ret = FALSE;
 
-	mutex_exit(&kernel_mutex);
+	mutex_exit(rec_mutex);
 
 	return ret;
 }
@@ -406,7 +456,7 @@ UNIV_INLINE lock_t* lock_rec_get_first_on_page(byte* ptr)
 	ulint	space;
 	ulint	page_no;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(lock_rec_get_mutex(ptr)));
 
 	hash = buf_frame_get_lock_hash_val(ptr);
 	lock = HASH_GET_FIRST(lock_sys->rec_hash, hash);
@@ -427,7 +477,7 @@ UNIV_INLINE lock_t* lock_rec_get_first_on_page(byte* ptr)
 /*м¼lockһʽ*/
 UNIV_INLINE lock_t* lock_rec_get_next(rec_t* rec, lock_t* lock)
 {
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(lock_rec_get_mutex(rec)));
 
 	for(;;){
 		lock = lock_rec_get_next_on_page(lock);
@@ -444,7 +494,7 @@ UNIV_INLINE lock_t* lock_rec_get_first(rec_t* rec)
 {
 	lock_t* lock;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(lock_rec_get_mutex(rec)));
 	lock = lock_rec_get_first_on_page(rec);
 	while(lock){
 		if(lock_rec_get_nth_bit(lock, rec_get_heap_no(rec))) /*жlockbitmapǷжӦλ״̬*/
@@ -631,7 +681,7 @@ static lock_t* lock_rec_create(ulint type_mode, rec_t* rec, dict_index_t* index,
 	ulint	n_bits;
 	ulint	n_bytes;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(lock_rec_get_mutex(rec)));
 
 	page = buf_frame_align(rec);
 	space = buf_frame_get_space_id(page);
@@ -767,13 +817,13 @@ static lock_t* lock_rec_add_to_queue(ulint type_mode, rec_t* rec, dict_index_t*
 	return lock_rec_create(type_mode, rec, index, trx);
 }
 
-/*ٻ󲿷̶,ûκм¼*/
+/*ٻ󲿷̶,ûκм¼ϡֻҪrecҳķƬmutex*/
 UNIV_INLINE ibool lock_rec_lock_fast(ibool impl, ulint mode, rec_t* rec, dict_index_t* index, que_thr_t* thr)
 {
 	lock_t*	lock;
 	ulint	heap_no;
 
-	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(mutex_own(lock_rec_get_mutex(rec)));
 	ut_ad(mode == LOCK_X || mode == LOCK_S);
 
 	heap_no = rec_get_heap_no(rec);
@@ -800,6 +850,22 @@ UNIV_INLINE ibool lock_rec_lock_fast(ibool impl, ulint mode, rec_t* rec, dict_in
 	return TRUE;
 }
 
+/*kernel_mutex,ֻrecҳķƬmutex³ԿٻrecϲҪתʽ
+FALSEʱҪȫ·*/
+static ibool lock_rec_lock_shard(ulint mode, rec_t* rec, dict_index_t* index, que_thr_t* thr)
+{
+	mutex_t*	rec_mutex;
+	ibool		ret;
+
+	rec_mutex = lock_rec_get_mutex(rec);
+
+	mutex_enter(rec_mutex);
+	ret = lock_rec_lock_fast(FALSE, mode, rec, index, thr);
+	mutex_exit(rec_mutex);
+
+	return ret;
+}
+
 /*ŶӶѡlock,Ȩ,ļ*/
 static ulint lock_rec_lock_slow(ibool impl, ulint mode, rec_t* rec, dict_index_t* index, que_thr_t* thr)
 {
@@ -1294,12 +1360,12 @@ void lock_update_merge_left(page_t* left_page, rec_t* orig_pred, page_t* right_p
 /*heirļ¼̳recheirGAPΧ*/
 void lock_rec_reset_and_inherit_gap_locks(rec_t* heir, rec_t* rec)
 {
-	mutex_enter(&kernel_mutex);	      		
+	lock_mutex_enter_kernel();	      		
 
 	lock_rec_reset_and_release_wait(heir);
 	lock_rec_inherit_to_gap(heir, rec);
 
-	mutex_exit(&kernel_mutex);	 
+	lock_mutex_exit_kernel();	 
 }
 
 /*pageתƵheir*/
@@ -1755,6 +1821,9 @@ void lock_release_off_kernel(trx_t* trx)
 
 	ut_ad(mutex_own(&kernel_mutex));
 
+	/*ֻkernel_mutex,ﲹеķƬmutexȫ·*/
+	lock_rec_mutex_enter_all();
+
 	lock = UT_LIST_GET_LAST(trx->trx_locks);
 	count = 0;
 	while(lock != NULL){
@@ -1778,6 +1847,8 @@ void lock_release_off_kernel(trx_t* trx)
 		lock = UT_LIST_GET_LAST(trx->trx_locks);
 	}
 
+	lock_rec_mutex_exit_all();
+
 	/*ͷӦlock*/
 	mem_heap_empty(trx->lock_heap);
 
@@ -1790,8 +1861,11 @@ void lock_cancel_waiting_and_release(lock_t* lock)
 	ut_ad(mutex_own(&kernel_mutex));
 
 	/*ȴ*/
-	if(lock_get_type(lock) == LOCK_REC)
+	if(lock_get_type(lock) == LOCK_REC){
+		lock_rec_mutex_enter_all();
 		lock_rec_dequeue_from_page(lock);
+		lock_rec_mutex_exit_all();
+	}
 	else{
 		ut_ad(lock_get_type(lock) == LOCK_TABLE);
 		lock_table_dequeue(lock);
@@ -1833,7 +1907,7 @@ void lock_reset_all_on_table(dict_table_t* table)
 {
 	lock_t* lock;
 
-	mutex_enter(&kernel_mutex);
+	lock_mutex_enter_kernel();
 
 	lock = UT_LIST_GET_FIRST(table->locks);
 
@@ -1846,7 +1920,7 @@ void lock_reset_all_on_table(dict_table_t* table)
 		lock = UT_LIST_GET_FIRST(table->locks);
 	}
 
-	mutex_exit(&kernel_mutex);
+	lock_mutex_exit_kernel();
 }
 
 /**********************VALIDATION AND DEBUGGING *************************/
@@ -2007,6 +2081,9 @@ void lock_print_info(char*	buf, char*	buf_end)
 		ut_dulint_get_low(purge_sys->purge_trx_no),
 		ut_dulint_get_high(purge_sys->purge_undo_no),
 		ut_dulint_get_low(purge_sys->purge_undo_no));
+
+	buf += sprintf(buf, "History list length %lu, purge lag %lu trx's, purge threads %lu\n",
+		trx_sys->rseg_history_len, trx_purge_get_lag(), purge_sys->n_threads);
 	
 	lock_mutex_enter_kernel();
 
@@ -2452,14 +2529,15 @@ ibool lock_validate(void)
 	return(TRUE);
 }
 
-ulint lock_rec_insert_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, que_thr_t* thr, ibool inherit)
+ulint lock_rec_insert_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, que_thr_t* thr, ibool* inherit)
 {
-	rec_t*	next_rec;
-	trx_t*	trx;
-	lock_t*	lock;
-	ulint	err;
+	rec_t*		next_rec;
+	trx_t*		trx;
+	lock_t*		lock;
+	ulint		err;
+	mutex_t*	rec_mutex;
 
-	if(flags && BTR_NO_LOCKING_FLAG)
+	if(flags & BTR_NO_LOCKING_FLAG)
 		return DB_SUCCESS;
 
 	ut_ad(rec);
@@ -2467,23 +2545,27 @@ ulint lock_rec_insert_check_and_lock(ulint flags, rec_t* rec, dict_index_t* inde
 	trx = thr_get_trx(thr);
 	next_rec = page_rec_get_next(rec);
 
-	*thr_get_trx = FALSE;
-
-	lock_mutex_enter_kernel();
-
-	ut_ad(lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
+	*inherit = FALSE;
 
+	/*·󲿷ֲnext_recûκʽֻҪҳӦķƬmutex顣
+	߳ҳX latch,ڲ֮ǰnext_recϼ*/
+	rec_mutex = lock_rec_get_mutex(next_rec);
+	mutex_enter(rec_mutex);
 	lock = lock_rec_get_first(next_rec);
+	mutex_exit(rec_mutex);
+
 	if(lock == NULL){ /*м¼Բ*/
-		lock_mutex_exit_kernel();
-		
 		/*pageִеID*/
-		if(!(index->type) & DICT_CLUSTERED)
-			page_update_max_trx_id(buf_frame_align(rec), thr_get_trx(thr)->id);
+		if(!(index->type & DICT_CLUSTERED))
+			page_update_max_trx_id(buf_frame_align(rec), trx->id);
 
 		return DB_SUCCESS;
 	}
 
+	lock_mutex_enter_kernel();
+
+	ut_ad(lock_table_has(trx, index->table, LOCK_IX));
+
 	*inherit = TRUE;
 
 	/*next_recбLOCK_SϸҲtrx,insertһLOCK_Xֲ֧*/
@@ -2554,6 +2636,8 @@ ulint lock_clust_rec_modify_check_and_lock(ulint flags, rec_t* rec, dict_index_t
 /*ͨ޸ļ¼УһȴLOCK_XɹPAGEĲtrx_id*/
 ulint lock_sec_rec_modify_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, que_thr_t* thr)
 {
+	ulint err;
+
 	if(flags & BTR_NO_LOCKING_FLAG)
 		return DB_SUCCESS;
 
@@ -2570,13 +2654,16 @@ ulint lock_sec_rec_modify_check_and_lock(ulint flags, rec_t* rec, dict_index_t*
 	ut_ad(lock_rec_queue_validate(rec, index));
 
 	if(err == DB_SUCCESS)
-		page_update_max_trx_id(buf_frame_algin(rec), thr_get_trx(thr)->id)
+		page_update_max_trx_id(buf_frame_align(rec), thr_get_trx(thr)->id);
+
+	return err;
 }
 
 /*ͨȡ¼У¼ĶһʽתʾLOCK_X,ԻִȨ*/
 ulint lock_sec_rec_read_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, ulint mode, que_thr_t* thr)
 {
-	ulint err;
+	ulint	err;
+	ibool	impl = FALSE;
 
 	ut_ad(!(index->type & DICT_CLUSTERED));
 	ut_ad(page_rec_is_user_rec(rec) || page_rec_is_supremum(rec));
@@ -2584,6 +2671,17 @@ ulint lock_sec_rec_read_check_and_lock(ulint flags, rec_t* rec, dict_index_t* in
 	if(flags & BTR_NO_LOCKING_FLAG)
 		return DB_SUCCESS;
 
+	/*Ծkernel_mutexֻkernel_mutexжrecǷʽ*/
+	if(!page_rec_is_supremum(rec)){
+		mutex_enter(&kernel_mutex);
+		impl = (ut_dulint_cmp(page_get_max_trx_id(buf_frame_align(rec)), trx_list_get_min_trx_id()) >= 0 || recv_recovery_is_on());
+		mutex_exit(&kernel_mutex);
+	}
+
+	/*ҪʽתֻзƬmutex*/
+	if(!impl && lock_rec_lock_shard(mode, rec, index, thr))
+		return DB_SUCCESS;
+
 	lock_mutex_enter_kernel();
 
 	ut_ad(mode != LOCK_X || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
@@ -2606,6 +2704,7 @@ ulint lock_sec_rec_read_check_and_lock(ulint flags, rec_t* rec, dict_index_t* in
 ulint lock_clust_rec_read_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, ulint mode, que_thr_t* thr)
 {
 	ulint	err;
+	ibool	impl = FALSE;
 
 	ut_ad(index->type & DICT_CLUSTERED);
 	ut_ad(page_rec_is_user_rec(rec) || page_rec_is_supremum(rec));
@@ -2613,6 +2712,17 @@ ulint lock_clust_rec_read_check_and_lock(ulint flags, rec_t* rec, dict_index_t*
 	if(flags & BTR_NO_LOCKING_FLAG)
 		return DB_SUCCESS;
 
+	/*жʽҪѯԾ(kernel_mutex)߳ҳlatch,ж֮recϲµʽ*/
+	if(!page_rec_is_supremum(rec)){
+		mutex_enter(&kernel_mutex);
+		impl = (lock_clust_rec_some_has_impl(rec, index) != NULL);
+		mutex_exit(&kernel_mutex);
+	}
+
+	/*ûʽҪתֻзƬmutexʧٽȫ·*/
+	if(!impl && lock_rec_lock_shard(mode, rec, index, thr))
+		return DB_SUCCESS;
+
 	lock_mutex_enter_kernel();
 
 	ut_ad(mode != LOCK_X || lock_table_has(thr_get_trx(thr), index->table, LOCK_IX));
@@ -59,7 +59,7 @@ void					lock_rec_restore_from_page_infimum(rec_t* rec, page_t* page);
 
 ibool					lock_rec_expl_exist_on_page(ulint space, ulint page_no);
 
-ulint					lock_rec_insert_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, que_thr_t* thr, ibool inherit);
+ulint					lock_rec_insert_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, que_thr_t* thr, ibool* inherit);
 
 ulint					lock_clust_rec_modify_check_and_lock(ulint flags, rec_t* rec, dict_index_t* index, que_thr_t* thr);
 
@@ -144,6 +144,8 @@ typedef struct lock_op_struct
 struct lock_sys_struct
 {
 	hash_table_t*	rec_hash;
+	ulint			n_rec_mutexes;	/*rec_hashķƬ2*/
+	mutex_t*		rec_mutexes;	/*ÿƬһmutex,ϣƬҳ*/
 };
 
 extern lock_sys_t*		lock_sys;
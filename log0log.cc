@@ -1,6 +1,7 @@
 #include "log0log.h"
 
 #include "mem0mem.h"
+#include "ut0rnd.h"
 #include "buf0buf.h"
 #include "buf0flu.h"
 #include "srv0srv.h"
@@ -49,6 +50,17 @@ byte log_archive_io;
 #define LOG_UNLOCK_NONE_FLUSHED_LOCK	1
 #define LOG_UNLOCK_FLUSH_LOCK			2
 
+/*flush leaderlog_sys->mutex֮д,n_pending_writes֤ͬʱֻһleader,grouplsnlsn_offsetֻ
+log_sys->mutexʱleader߻ָ޸,д·϶ȡgroupֶֻҪ֮һ*/
+#define log_write_owned()	(mutex_own(&(log_sys->mutex)) || log_sys->n_pending_writes > 0)
+
+/*дmtrͷlog_sys->mutexȴпرյ*/
+#define LOG_WAIT_CLOSED_MAX_RETRY		10
+/*mtrύʱȴǰlsnر,,֮closed_eventϵȴ*/
+#define LOG_CLOSE_SPIN_ROUNDS			20
+/*closed_eventĵȴʱ(΢)ȴڻѺͼźܱ֮һȴreset,ʱ¼closed_lsn*/
+#define LOG_CLOSED_WAIT_TIMEOUT			10000
+
 /*ArchiveĲ*/
 #define	LOG_ARCHIVE_READ				1
 #define	LOG_ARCHIVE_WRITE				2
@@ -74,22 +86,91 @@ void log_fsp_current_free_limit_set_and_checkpoint(ulint limit)
 		success = log_checkpoint(TRUE, TRUE);
 	}
 }
-/*buf poolϵlsnbuf poolеoldest = 0ĬϷlog_sysеlsn*/
+/*closed_eventϵȴһclosed_lsnƽ߳closed_mutexѾȷ,ʱclosed_mutex*/
+static void log_closed_wait_low()
+{
+	ut_ad(mutex_own(&(log_sys->closed_mutex)));
+
+	/*closed_mutexreset,֮Ĺرһܿn_closed_waiterssetź*/
+	os_event_reset(log_sys->closed_event);
+	log_sys->n_closed_waiters ++;
+	mutex_exit(&(log_sys->closed_mutex));
+
+	os_event_wait_time(log_sys->closed_event, LOG_CLOSED_WAIT_TIMEOUT);
+
+	mutex_enter(&(log_sys->closed_mutex));
+	log_sys->n_closed_waiters --;
+	mutex_exit(&(log_sys->closed_mutex));
+}
+
+/*пģʽµȴclosed_lsnƽlsnclosed_eventϵȴ,̹߳رʱҪlog_sys->mutex,
+ԵһӦͷlog_sys->mutex*/
+static void log_wait_for_closed(dulint lsn)
+{
+	for(;;){
+		mutex_enter(&(log_sys->closed_mutex));
+		if(ut_dulint_cmp(log_sys->closed_lsn, lsn) >= 0){
+			mutex_exit(&(log_sys->closed_mutex));
+			return;
+		}
+
+		log_closed_wait_low();
+	}
+}
+
+/*closed_lsnƽѵȴ,߳closed_mutex*/
+UNIV_INLINE void log_closed_signal()
+{
+	ut_ad(mutex_own(&(log_sys->closed_mutex)));
+
+	if(log_sys->n_closed_waiters > 0)
+		os_event_set(log_sys->closed_event);
+}
+
+/*ѾԤlsnǷѾر,߳log_sys->mutex*/
+static ibool log_copies_closed()
+{
+	ibool	closed;
+
+	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	if(!srv_log_parallel_copy)
+		return TRUE;
+
+	mutex_enter(&(log_sys->closed_mutex));
+	closed = (ut_dulint_cmp(log_sys->closed_lsn, log_sys->lsn) == 0);
+	mutex_exit(&(log_sys->closed_mutex));
+
+	return closed;
+}
+
+/*buf poolϵlsnbuf poolеoldest = 0ĬϷlog_sysеlsnпģʽ»ڿmtrҳ
+ûмflush list,ǵlsnСclosed_lsn,Խclosed_lsn,Ҫȴ*/
 static dulint log_buf_pool_get_oldest_modification()
 {
 	dulint lsn;
+	dulint closed_lsn;
 
 	ut_ad(mutex_own(&(log_sys->mutex)));
+
+	/*ȶclosed_lsnٶflush list,closed_lsn֮ǰرյmtrҳһѾflush list*/
+	closed_lsn = log_sys->lsn;
+	if(srv_log_parallel_copy){
+		mutex_enter(&(log_sys->closed_mutex));
+		closed_lsn = log_sys->closed_lsn;
+		mutex_exit(&(log_sys->closed_mutex));
+	}
+
 	/*buf_pool_get_oldest_modificationbuf0bufУbuf pool޸ĵblockɵlsn*/
 	lsn = buf_pool_get_oldest_modification();
-	if(ut_dulint_is_zero(lsn))
-		lsn = log_sys->lsn;
+	if(ut_dulint_is_zero(lsn) || ut_dulint_cmp(lsn, closed_lsn) > 0)
+		lsn = closed_lsn;
 
 	return lsn;
 }
 
-/*һµblockڴǰҪжlog->bufʣռ͹鵵bufռ*/
-dulint log_reserve_and_open(ulint len)
+/*Ϊlenȵ־׼log bufferռ,ʱlog_sys->mutex׼ǰҪжlog->bufʣռ͹鵵bufռ*/
+static void log_reserve_and_open_low(ulint len)
 {
 	log_t*	log	= log_sys;
 	ulint	len_upper_limit;
@@ -124,13 +205,39 @@ loop:
 			ut_ad(len_upper_limit <= log->max_archived_lsn_age);
 			/*ǿͬarchive write*/
 			log_archive_do(TRUE, &dummy);
-			cout ++;
+			count ++;
 			
 			ut_ad(count < 50);
 
 			goto loop;
 		}
 	}
+}
+
+/*һµblock߻log_sys->mutexֱдlog buffer*/
+dulint log_reserve_and_open(ulint len)
+{
+	log_t*	log	= log_sys;
+	dulint	lsn;
+	ulint	count	= 0;
+
+loop:
+	log_reserve_and_open_low(len);
+
+	/*пģʽ,buf_free֮ǰmtrڿʱͷlog_sys->mutexȴǹرպԤ*/
+	if(!log_copies_closed()){
+		lsn = log->lsn;
+		if(count < LOG_WAIT_CLOSED_MAX_RETRY){
+			mutex_exit(&(log->mutex));
+			log_wait_for_closed(lsn);
+
+			count ++;
+			goto loop;
+		}
+
+		/*µԤһֱڽ,mutexסµԤ,closed_eventϵȴѾԤĿر*/
+		log_wait_for_closed(lsn);
+	}
 
 #ifdef UNIV_LOG_DEBUG
 	log->old_buf_free = log->buf_free;
@@ -164,10 +271,10 @@ part_loop:
 	str_len -= len;
 	str = str + len;
 
-	log_block = ut_align(log->buf + log->buf_free, OS_FILE_LOG_BLOCK_SIZE);
+	log_block = ut_align_down(log->buf + log->buf_free, OS_FILE_LOG_BLOCK_SIZE);
 	log_block_set_data_len(log_block, data_len);
 
-	if(data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE){ /*һblockд*/
+	if(data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE){ /*һblockд*/
 		log_block_set_data_len(log_block, OS_FILE_LOG_BLOCK_SIZE); /*ó*/
 		log_block_set_checkpoint_no(log_block, log_sys->next_checkpoint_no); /*checkpoint number*/
 
@@ -185,14 +292,13 @@ part_loop:
 	if(str_len > 0)
 		goto part_loop;
 }
-/*mtr_commitύʱ*/
-dulint log_close()
+/*رյǰ־д,blockfirst_rec_group,жǷҪˢ̻߽checkpoint*/
+static dulint log_close_low(log_t* log)
 {
 	byte*	log_block;
 	ulint	first_rec_group;
 	dulint	oldest_lsn;
 	dulint	lsn;
-	log_t*	log	= log_sys;
 
 	ut_ad(mutex_own(&(log->mutex)));
 
@@ -220,6 +326,25 @@ dulint log_close()
 			log->check_flush_or_checkpoint = TRUE;
 
 function_exit:
+	return lsn;
+}
+
+/*mtr_commitύʱ*/
+dulint log_close()
+{
+	dulint	lsn;
+	log_t*	log	= log_sys;
+
+	lsn = log_close_low(log);
+
+	/*дmtrlog_reserve_and_openѾȴ֮ǰĿ,ֱƽclosed_lsn*/
+	if(srv_log_parallel_copy){
+		mutex_enter(&(log->closed_mutex));
+		log->closed_lsn = lsn;
+		log_closed_signal();
+		mutex_exit(&(log->closed_mutex));
+	}
+
 #ifdef UNIV_LOG_DEBUG
 	log_check_log_recs(log->buf + log->old_buf_free, log->buf_free - log->old_buf_free, log->old_lsn);
 #endif
@@ -227,6 +352,122 @@ function_exit:
 	return lsn;
 }
 
+/*пģʽΪΪlenmtr־Ԥlsnlog bufferռ䡣Ԥlog_sys->mutex,ֻƽ
+lsn/buf_freeдblockĿͷ,־ͷmutexlog_write_reserved߱ʱ
+FALSE,ԭĴ·*/
+ibool log_reserve_for_copy(ulint len, dulint* start_lsn, dulint* end_lsn, ulint* start_offset)
+{
+	log_t*	log	= log_sys;
+	ulint	data_len;
+	ulint	part_len;
+	byte*	log_block;
+
+	ut_ad(srv_log_parallel_copy);
+
+	log_reserve_and_open_low(len);
+
+	if(log->online_backup_state){
+		mutex_exit(&(log->mutex));
+		return FALSE;
+	}
+
+	*start_lsn = log->lsn;
+	*start_offset = log->buf_free;
+
+	/*log_write_lowͬķֿ鷽ʽƽbuf_freelsn,*/
+	while(len > 0){
+		data_len = log->buf_free % OS_FILE_LOG_BLOCK_SIZE + len;
+		if(data_len < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE)
+			part_len = len;
+		else{
+			data_len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE;
+			part_len = OS_FILE_LOG_BLOCK_SIZE - (log->buf_free % OS_FILE_LOG_BLOCK_SIZE) - LOG_BLOCK_TRL_SIZE;
+		}
+		len -= part_len;
+
+		log_block = ut_align_down(log->buf + log->buf_free, OS_FILE_LOG_BLOCK_SIZE);
+		log_block_set_data_len(log_block, data_len);
+
+		if(data_len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE){
+			log_block_set_data_len(log_block, OS_FILE_LOG_BLOCK_SIZE);
+			log_block_set_checkpoint_no(log_block, log->next_checkpoint_no);
+
+			part_len += LOG_BLOCK_HDR_SIZE + LOG_BLOCK_TRL_SIZE;
+			log->lsn = ut_dulint_add(log->lsn, part_len);
+			log_block_init(log_block + OS_FILE_LOG_BLOCK_SIZE, log->lsn);
+		}
+		else
+			log->lsn = ut_dulint_add(log->lsn, part_len);
+
+		log->buf_free += part_len;
+		ut_ad(log->buf_free <= log->buf_size);
+	}
+
+	*end_lsn = log_close_low(log);
+
+	mutex_exit(&(log->mutex));
+
+	return TRUE;
+}
+
+/*strlog_reserve_for_copyԤlog buffer,*offsetһдλ,blockʱβһĿͷ
+Ҫlog_sys->mutex,Ԥڹر֮ǰᱻˢ̻ƶ*/
+void log_write_reserved(byte* str, ulint str_len, ulint* offset)
+{
+	ulint	len;
+	ulint	block_offset;
+
+	while(str_len > 0){
+		block_offset = *offset % OS_FILE_LOG_BLOCK_SIZE;
+		len = OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE - block_offset;
+		if(str_len < len)
+			len = str_len;
+
+		ut_memcpy(log_sys->buf + *offset, str, len);
+		str += len;
+		str_len -= len;
+
+		if(block_offset + len == OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE)
+			*offset += len + LOG_BLOCK_TRL_SIZE + LOG_BLOCK_HDR_SIZE;
+		else
+			*offset += len;
+	}
+}
+
+/*ȴstart_lsn֮ǰԤmtrر,ʱclosed_mutex,֤ҳlsn˳flush list
+߳mtrҳlatch,޵,֮closed_eventϵȴ,ռǰmtrرҪCPU*/
+void log_close_enter(dulint start_lsn)
+{
+	ulint	i	= 0;
+
+	for(;;){
+		mutex_enter(&(log_sys->closed_mutex));
+		if(ut_dulint_cmp(log_sys->closed_lsn, start_lsn) == 0)
+			return;
+
+		ut_ad(ut_dulint_cmp(log_sys->closed_lsn, start_lsn) < 0);
+
+		if(i < LOG_CLOSE_SPIN_ROUNDS){
+			mutex_exit(&(log_sys->closed_mutex));
+
+			i ++;
+			os_thread_yield();
+		}
+		else
+			log_closed_wait_low();
+	}
+}
+
+/*ҳflush listرmtrlsn*/
+void log_close_exit(dulint end_lsn)
+{
+	ut_ad(mutex_own(&(log_sys->closed_mutex)));
+
+	log_sys->closed_lsn = end_lsn;
+	log_closed_signal();
+	mutex_exit(&(log_sys->closed_mutex));
+}
+
 /*ڹ鵵ǰһblock*/
 static void log_pad_current_log_block()
 {
@@ -252,21 +493,21 @@ static void log_pad_current_log_block()
 /*һgroup ɵ־,һgroupͬȵļ*/
 ulint log_group_get_capacity(log_group_t* group)
 {
-	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(log_write_owned());
 	return((group->file_size - LOG_FILE_HDR_SIZE) * group->n_files); 
 }
 
 /*group ڲƫƻƫƻƫ = offset - ļͷ */
 UNIV_INLINE ulint log_group_calc_size_offset(ulint offset, log_group_t* group)
 {
-	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(log_write_owned());
 	return offset - LOG_FILE_HDR_SIZE * (1 + offset / group->file_size);
 }
 
 /*ͨƫƻgroup fileƫ*/
 UNIV_INLINE ulint log_group_calc_real_offset(ulint offset, log_group_t* group)
 {
-	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(log_write_owned());
 
 	return (offset + LOG_FILE_HDR_SIZE * (1 + offset / (group->file_size - LOG_FILE_HDR_SIZE)));
 }
@@ -280,7 +521,7 @@ static ulint log_group_calc_lsn_offset(dulint lsn, log_group_t* group)
 	int64_t			group_size;
 	int64_t			offset;
 
-	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(log_write_owned());
 
 	gr_lsn = group->lsn;
 	/*lsn_offsetƫ,ȥļͷ*/
@@ -430,6 +671,9 @@ void log_init()
 	log_sys->buf_size = LOG_BUFFER_SIZE;
 	memset(log_sys->buf, 0, LOG_BUFFER_SIZE);
 
+	/*leaderд̵ĸ,ͬ512ֽڶ*/
+	log_sys->flush_buf = ut_align(ut_malloc(LOG_BUFFER_SIZE + OS_FILE_LOG_BLOCK_SIZE), OS_FILE_LOG_BLOCK_SIZE);
+
 	log_sys->max_buf_free = log_sys->buf_size / LOG_BUF_FLUSH_RATIO - LOG_BUF_FLUSH_MARGIN;
 	log_sys->check_flush_or_checkpoint = TRUE;
 
@@ -445,6 +689,20 @@ void log_init()
 	log_sys->written_to_all_lsn = log_sys->lsn;
 
 	log_sys->n_pending_writes = 0;
+
+	mutex_create(&(log_sys->closed_mutex));
+	mutex_set_level(&(log_sys->closed_mutex), SYNC_NO_ORDER_CHECK);
+	log_sys->closed_event = os_event_create(NULL);
+	log_sys->n_closed_waiters = 0;
+
+	log_sys->gc_max_queued_lsn = ut_dulint_zero;
+	log_sys->gc_n_queued = 0;
+	log_sys->gc_group_size = 0;
+	log_sys->gc_max_group_size = 0;
+	log_sys->n_flush_requests = 0;
+	log_sys->n_group_flushes = 0;
+	log_sys->n_flush_requests_old = 0;
+	log_sys->n_group_flushes_old = 0;
 	
 	log_sys->no_flush_event = os_event_create(NULL);
 	os_event_set(log_sys->no_flush_event);
@@ -488,6 +746,7 @@ void log_init()
 	/*óʼƫʵλ*/
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn = ut_dulint_add(LOG_START_LSN, LOG_BLOCK_HDR_SIZE);
+	log_sys->closed_lsn = log_sys->lsn;
 
 	mutex_exit(&(log_sys->mutex));
 
@@ -589,7 +848,8 @@ static ulint log_sys_check_flush_completion()
 		log_sys->buf_next_to_write = log_sys->flush_end_offset; /*´νlog flushʼƫ*/
 
 		/*ǰƣΪȫѾflush*/
-		if(log_sys->flush_end_offset > log_sys->max_buf_free / 2){
+		/*ƶʱmtrlog bufferп,пûйرʱһˢƶ*/
+		if(log_sys->flush_end_offset > log_sys->max_buf_free / 2 && log_copies_closed()){
 			/*ȷƶλ*/
 			move_start = ut_calc_align_down(log_sys->flush_end_offset, OS_FILE_LOG_BLOCK_SIZE);
 			move_end = ut_calc_align(log_sys->buf_free, OS_FILE_LOG_BLOCK_SIZE);
@@ -703,7 +963,7 @@ static void log_group_file_header_flush(ulint type, log_group_t* group, ulint nt
 	byte*	buf;
 	ulint	dest_offset;
 
-	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(log_write_owned());
 	ut_a(nth_file < group->n_files);
 
 	/*ҵļӦgoupеͷ*/
@@ -728,10 +988,19 @@ static void log_group_file_header_flush(ulint type, log_group_t* group, ulint nt
 			buf, group);
 	}
 }
-/*blockcheck sum*/
+/*blockcheck sum,page checksumһsrv_checksum_algorithmʽ:
+CRC32ʱڿͷCRC32C־,дϸʽ,֤ϰ汾Զȡ(ȫ)
+recoveryͷ־У,ָʽʶ*/
 static void log_block_store_checksum(byte* block)
 {
-	log_block_set_checksum(block, log_block_calc_checksum(block));
+	if(srv_checksum_algorithm == BUF_CHECKSUM_ALGORITHM_CRC32){
+		log_block_set_crc32_bit(block, TRUE);
+		log_block_set_checksum(block, log_block_calc_crc32(block));
+	}
+	else{
+		log_block_set_crc32_bit(block, FALSE);
+		log_block_set_checksum(block, log_block_calc_checksum(block));
+	}
 }
 
 void log_group_write_buf(ulint type, log_group_t* group, byte* buf, ulint len, dulint start_lsn, ulint new_data_offset)
@@ -741,7 +1010,7 @@ void log_group_write_buf(ulint type, log_group_t* group, byte* buf, ulint len, d
 	ulint	next_offset;
 	ulint	i;
 
-	ut_ad(mutex_own(&(log_sys->mutex)));
+	ut_ad(log_write_owned());
 	ut_a(len % OS_FILE_LOG_BLOCK_SIZE == 0);
 	ut_a(ut_dulint_get_low(start_lsn) % OS_FILE_LOG_BLOCK_SIZE == 0);
 
@@ -814,12 +1083,18 @@ void log_flush_up_to(dulint lsn, ulint wait)
 	ulint		area_end;
 	ulint		loop_count;
 	ulint		unlock;
+	ulint		data_len;
+	dulint		write_lsn;
+	dulint		wait_lsn;
+	dulint		write_start_lsn;
+	byte*		buf;
+	byte*		last_block;
 
 	/*ûibuf logڻָݿ*/
 	if(recv_no_ibuf_operations)
 		return ;
 
-	loop_count;
+	loop_count = 0;
 
 loop:
 	loop_count ++;
@@ -839,21 +1114,62 @@ loop:
 			return;
 	}
 
+	if(loop_count == 1)
+		log_sys->n_flush_requests ++;
+
 	/*log_sysfil_flush IO*/
 	if(log_sys->n_pending_writes > 0){
-		if(ut_dulint_cmp(log_sys->flush_lsn, lsn) >= 0)
+		/*ǰһˢѾlsn,Ϊfollowerȴһ*/
+		if(ut_dulint_cmp(log_sys->flush_lsn, lsn) >= 0){
+			log_sys->gc_group_size ++;
 			goto do_waits;
+		}
+
+		/*group commit,ȴǰһɺһֵleaderһˢ*/
+		if(ut_dulint_cmp(lsn, log_sys->gc_max_queued_lsn) > 0)
+			log_sys->gc_max_queued_lsn = lsn;
+		log_sys->gc_n_queued ++;
 
 		mutex_exit(&(log_sys->mutex));
 
 		/*no flush eventȴ*/
 		os_event_wait(log_sys->no_flush_event);
 
+		mutex_enter(&(log_sys->mutex));
+		ut_ad(log_sys->gc_n_queued > 0);
+		log_sys->gc_n_queued --;
+		mutex_exit(&(log_sys->mutex));
+
 		goto loop;
 	}
 
+	/*̳߳Ϊleader,ĿҪŶӵȴһֵύlsn*/
+	wait_lsn = lsn;
+	if(ut_dulint_cmp(log_sys->gc_max_queued_lsn, wait_lsn) > 0)
+		wait_lsn = log_sys->gc_max_queued_lsn;
+	if(ut_dulint_cmp(wait_lsn, log_sys->lsn) > 0)
+		wait_lsn = log_sys->lsn;
+
+	/*пģʽֻдѾرյ־Ŀ֮ǰmtrڿʱ,ͷlog_sys->mutexclosed_eventϵȴǹر*/
+	write_lsn = log_sys->lsn;
+	if(srv_log_parallel_copy){
+		mutex_enter(&(log_sys->closed_mutex));
+		write_lsn = log_sys->closed_lsn;
+		mutex_exit(&(log_sys->closed_mutex));
+
+		if(ut_dulint_cmp(write_lsn, wait_lsn) < 0){
+			mutex_exit(&(log_sys->mutex));
+			log_wait_for_closed(wait_lsn);
+
+			goto loop;
+		}
+	}
+
+	/*write_lsnӦbufƫ,lsnbuf_freeͬƽ*/
+	end_offset = log_sys->buf_free - ut_dulint_minus(log_sys->lsn, write_lsn);
+
 	/*ˢ*/
-	if(log_sys->buf_free == log_sys->buf_next_to_write){
+	if(end_offset == log_sys->buf_next_to_write){
 		mutex_exit(&(log_sys->mutex));
 		return;
 	}
@@ -877,41 +1193,53 @@ loop:
 
 	/*Ҫflushλ÷Χ*/
 	start_offset = log_sys->buf_next_to_write;
-	end_offset = log_sys->buf_free;
 
 	area_start = ut_calc_align_down(start_offset, OS_FILE_LOG_BLOCK_SIZE);
 	area_end = ut_calc_align(end_offset, OS_FILE_LOG_BLOCK_SIZE);
 
 	ut_ad(area_end - area_start > 0);
 
-	/*flushlsn*/
-	log_sys->flush_lsn = log_sys->lsn;
+	/*flushlsn,queueбwrite_lsnǵύֱӷ,ûиǵŶ*/
+	log_sys->flush_lsn = write_lsn;
 	log_sys->one_flushed = FALSE;
 
+	log_sys->gc_max_queued_lsn = ut_dulint_zero;
+	log_sys->gc_group_size = 1;
+	log_sys->n_group_flushes ++;
+
+	/*log bufferĸд,һblockwrite_lsn֮󻹻־,аضϵwrite_lsn,
+	log bufferҪٰһblock*/
+	buf = log_sys->flush_buf;
+	ut_memcpy(buf, log_sys->buf + area_start, area_end - area_start);
+
+	last_block = buf + area_end - area_start - OS_FILE_LOG_BLOCK_SIZE;
+	data_len = end_offset % OS_FILE_LOG_BLOCK_SIZE;
+	if(data_len != 0){
+		log_block_set_data_len(last_block, data_len);
+		if(log_block_get_first_rec_group(last_block) > data_len)
+			log_block_set_first_rec_group(last_block, data_len);
+	}
+
 	/*flushıʶλ*/
-	log_block_set_flush_bit(log_sys->buf + area_start, TRUE);
+	log_block_set_flush_bit(buf, TRUE);
 	/*һcheckpoint no*/
-	log_block_set_checkpoint_no(log_sys->buf + area_end - OS_FILE_LOG_BLOCK_SIZE, log_sys->next_checkpoint_no);
+	log_block_set_checkpoint_no(last_block, log_sys->next_checkpoint_no);
 
-	/*Ϊʲôһblockƶ,пһblockûֹ´ддflushϣΪbuf_free flush_end_offset*/
-	ut_memcpy(log_sys->buf + area_end, log_sys->buf + area_end - OS_FILE_LOG_BLOCK_SIZE, OS_FILE_LOG_BLOCK_SIZE);
-	log_sys->buf_free += OS_FILE_LOG_BLOCK_SIZE;
-	log_sys->flush_end_offset = log_sys->buf_free;
+	log_sys->flush_end_offset = end_offset;
+	write_start_lsn = ut_dulint_align_down(log_sys->written_to_all_lsn, OS_FILE_LOG_BLOCK_SIZE);
+
+	/*д̺fsynclog_sys->mutex֮,n_pending_writesסleaderڼmtrԼдlog buffer,
+	µύ뱾ֵfollowerŶӵȴһ*/
+	mutex_exit(&(log_sys->mutex));
 
 	/*group bufˢ뵽*/
 	group = UT_LIST_GET_FIRST(log_sys->log_groups);
 	while(group){
 		/*group bufˢ뵽logļ*/
-		log_group_write_buf(LOG_FLUSH, group, log_sys->buf + area_start, area_end - area_start, 
-			ut_dulint_align_down(log_sys->written_to_all_lsn, OS_FILE_LOG_BLOCK_SIZE), start_offset - area_start);
-
-		/*µgroup->lsn*/
-		log_group_set_fields(group, log_sys->flush_lsn);
+		log_group_write_buf(LOG_FLUSH, group, buf, area_end - area_start, write_start_lsn, start_offset - area_start);
 		group = UT_LIST_GET_NEXT(log_groups, group);
 	}
 
-	mutex_exit(&(log_sys->mutex));
-
 	/*srv_flush_log_at_trx_commit =2Ļ־ֻPAGE CACHEУϵ־Ͷ*/
 	if (srv_unix_file_flush_method != SRV_UNIX_O_DSYNC && srv_unix_file_flush_method != SRV_UNIX_NOSYNC && srv_flush_log_at_trx_commit != 2) {
 			group = UT_LIST_GET_FIRST(log_sys->log_groups);
@@ -919,6 +1247,14 @@ loop:
 	}
 
 	mutex_enter(&(log_sys->mutex));
+
+	/*µgroup->lsn*/
+	group = UT_LIST_GET_FIRST(log_sys->log_groups);
+	while(group){
+		log_group_set_fields(group, log_sys->flush_lsn);
+		group = UT_LIST_GET_NEXT(log_groups, group);
+	}
+
 	group = UT_LIST_GET_FIRST(log_sys->log_groups);
 
 	ut_a(group->n_pending_writes == 1);
@@ -927,12 +1263,15 @@ loop:
 	group->n_pending_writes--;
 	log_sys->n_pending_writes--;
 
-	/*ioǷ*/
+	if(log_sys->gc_group_size > log_sys->gc_max_group_size)
+		log_sys->gc_max_group_size = log_sys->gc_group_size;
+
+	/*ioǷ,һһֵfollower*/
 	unlock = log_group_check_flush_completion(group);
 	unlock = unlock | log_sys_check_flush_completion();
 	log_flush_do_unlocks(unlock);
 
-	mutex_exit(log_sys->mutex);
+	mutex_exit(&(log_sys->mutex));
 	return;
 
 do_waits:
@@ -978,9 +1317,9 @@ ibool log_preflush_pool_modified_pages(dulint new_oldest, ibool sync)
 		recv_apply_hashed_log_recs(TRUE);
 	}
 
-	n_pages = buf_flush_batch(BUF_FLUSH_LIST, ULINT_MAX, new_oldest);
+	n_pages = buf_flush_list(ULINT_MAX, new_oldest);
 	if(sync)
-		buf_flush_wait_batch_end(BUF_FLUSH_LIST);
+		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
 	
 	return (n_pages == ULINT_UNDEFINED) ? FALSE : TRUE;
 }
@@ -2060,8 +2399,9 @@ void log_print(char* buf, char*	buf_end)
 {
 	double	time_elapsed;
 	time_t	current_time;
+	ulint	n_flushes;
 
-	if (buf_end - buf < 300)
+	if (buf_end - buf < 400)
 		return;
 
 	mutex_enter(&(log_sys->mutex));
@@ -2088,7 +2428,18 @@ void log_print(char* buf, char*	buf_end)
 		log_sys->n_log_ios,
 		(log_sys->n_log_ios - log_sys->n_log_ios_old) / time_elapsed);
 
+	n_flushes = log_sys->n_group_flushes - log_sys->n_group_flushes_old;
+	buf += sprintf(buf,
+		"Group commit: %lu flush requests, %lu log flushes, %.2f requests/flush, max group %lu, %lu queued\n",
+		log_sys->n_flush_requests,
+		log_sys->n_group_flushes,
+		n_flushes > 0 ? (log_sys->n_flush_requests - log_sys->n_flush_requests_old) / (double)n_flushes : 0.0,
+		log_sys->gc_max_group_size,
+		log_sys->gc_n_queued);
+
 	log_sys->n_log_ios_old = log_sys->n_log_ios;
+	log_sys->n_flush_requests_old = log_sys->n_flush_requests;
+	log_sys->n_group_flushes_old = log_sys->n_group_flushes;
 	log_sys->last_printout_time = current_time;
 
 	mutex_exit(&(log_sys->mutex));
@@ -2098,9 +2449,52 @@ void log_print(char* buf, char*	buf_end)
 void log_refresh_stats(void)
 {
 	log_sys->n_log_ios_old = log_sys->n_log_ios;
+	log_sys->n_flush_requests_old = log_sys->n_flush_requests;
+	log_sys->n_group_flushes_old = log_sys->n_group_flushes;
 	log_sys->last_printout_time = time(NULL);
 }
 
+#ifdef UNIV_LOG_DEBUG
+/*Աlog block checksum㷨ĺʱ,ÿֶһ1MBbufferblockchecksum*/
+void log_block_checksum_measure(ulint n_rounds)
+{
+	byte*	buf;
+	byte*	block;
+	ulint	i;
+	ulint	sum	= 0;
+	ullint	start;
+	ullint	old_us;
+	ullint	crc32_us;
+	ulint	n_blocks;
+
+	buf = ut_malloc(1024 * 1024);
+	n_blocks = n_rounds * (1024 * 1024 / OS_FILE_LOG_BLOCK_SIZE);
+
+	for(i = 0; i < 1024 * 1024; i ++)
+		buf[i] = (byte)ut_rnd_gen_ulint();
+
+	start = ut_time_us(NULL);
+	for(i = 0; i < n_blocks; i ++){
+		block = buf + (i % (1024 * 1024 / OS_FILE_LOG_BLOCK_SIZE)) * OS_FILE_LOG_BLOCK_SIZE;
+		sum += log_block_calc_checksum(block);
+	}
+	old_us = ut_time_us(NULL) - start;
+
+	start = ut_time_us(NULL);
+	for(i = 0; i < n_blocks; i ++){
+		block = buf + (i % (1024 * 1024 / OS_FILE_LOG_BLOCK_SIZE)) * OS_FILE_LOG_BLOCK_SIZE;
+		sum += log_block_calc_crc32(block);
+	}
+	crc32_us = ut_time_us(NULL) - start;
+
+	ut_free(buf);
+
+	fprintf(stderr,
+		"InnoDB: log block checksum of %lu blocks: old format %lu us, crc32c%s %lu us (%lu)\n",
+		n_blocks, (ulint)old_us, ut_crc32_sse2_enabled ? " sse4.2" : "", (ulint)crc32_us, sum);
+}
+#endif
+
 
 
 
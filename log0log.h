@@ -69,10 +69,18 @@ typedef struct log_struct
 
 	dulint			flush_lsn;			/*flushlsn*/
 	ulint			flush_end_offset;	/*һlog fileˢʱbuf_freeҲһflushĩβƫ*/
+	byte*			flush_buf;			/*leaderдõlog buffer,ֻflush_lsn֮ǰѾرյ־*/
 	ulint			n_pending_writes;	/*ڵfil_flushĸ*/
 
 	os_event_t		no_flush_event;		/*fil_flushɺŻᴥź,ȴеgoupsˢ*/
 
+	/*srv_log_parallel_copyģʽ,mtrlog_sys->mutexֻԤlsn,ͷmutexп־,
+	ٰlsn˳رաclosed_lsn֮ǰ־Ѿlog buffer,ӦҳҲѾflush list*/
+	mutex_t			closed_mutex;		/*closed_lsn,ͬʱ֤ҳlsn˳flush list*/
+	dulint			closed_lsn;			/*Ѿɿرյlsn,log_sys->lsnѾԤlsn*/
+	os_event_t		closed_event;		/*closed_lsnƽʱ,еȴ߾ʹź*/
+	ulint			n_closed_waiters;	/*closed_eventϵȴ̸߳,closed_mutex*/
+
 	ibool			one_flushed;			/*һlog groupˢֵ̺óTRUE*/
 	os_event_t		one_flushed_event;      /*ֻҪһgroup flushɾͻᴥź*/
 
@@ -80,6 +88,18 @@ typedef struct log_struct
 	ulint			n_log_ios_old;			/*һͳʱio*/
 	time_t			last_printout_time;
 
+	/*group commit,leaderlog_sys->mutex֮д̺fsync,ڼ䵽ύflush_lsnǾΪfollower
+	ȴ,Ŷӵȴһ֡һֵleaderһд벢fsyncǶĿlsnѹر־,
+	ֵfollowerˢʱһ𱻻*/
+	dulint			gc_max_queued_lsn;		/*Ŷӵȴһˢ̵Ŀlsn*/
+	ulint			gc_n_queued;			/*Ŷӵȴһˢ̵ύ߸*/
+	ulint			gc_group_size;			/*ǰһˢ̸ǵύ߸,leader*/
+	ulint			gc_max_group_size;		/*ˢ̸ǵύ߸*/
+	ulint			n_flush_requests;		/*Ҫȴ־ˢ̵log_flush_up_toô*/
+	ulint			n_group_flushes;		/*log_flush_up_toʵִед+fsync*/
+	ulint			n_flush_requests_old;
+	ulint			n_group_flushes_old;
+
 	ulint			max_modified_age_async;	/*첽־ļˢ̵ֵ*/
 	ulint			max_modified_age_sync;	/*ͬ־ļˢ̵ֵ*/
 	ulint			adm_checkpoint_interval;
@@ -136,6 +156,8 @@ extern log_t*	log_sys;
 #define LOG_BLOCK_FLUSH_BIT_MASK	0x80000000
 /*log block head ĳ*/
 #define LOG_BLOCK_HDR_DATA_LEN		4
+/*data lenλ,1ʾblockchecksumCRC32Cʽ,ϵλۼӸʽ*/
+#define LOG_BLOCK_CRC32_BIT_MASK	0x8000
 	
 #define LOG_BLOCK_FIRST_REC_GROUP	6
 
@@ -199,6 +221,12 @@ dulint		log_reserve_and_open(ulint len);
 void		log_write_low(byte* str, ulint str_len);
 dulint		log_close();
 
+/*пģʽ,Ԥlsn->־->lsn˳ر*/
+ibool		log_reserve_for_copy(ulint len, dulint* start_lsn, dulint* end_lsn, ulint* start_offset);
+void		log_write_reserved(byte* str, ulint str_len, ulint* offset);
+void		log_close_enter(dulint start_lsn);
+void		log_close_exit(dulint end_lsn);
+
 ulint		log_group_get_capacity(log_group_t* group);
 /*lsngroupжӦļλƫ*/
 ulint		log_calc_where_lsn_is(int64_t* log_file_offset, dulint first_header_lsn, dulint lsn, ulint n_log_files, int64_t log_file_size);
@@ -220,6 +248,11 @@ void		log_group_write_buf(ulint type, log_group_t* group, byte* buf, ulint len,
 /*sys_logеgroupflush*/
 void		log_flush_up_to(dulint lsn, ulint wait);
 
+#ifdef UNIV_LOG_DEBUG
+/*Աlog block checksum㷨ĺʱ*/
+void		log_block_checksum_measure(ulint n_rounds);
+#endif
+
 /********************************************************************
 Advances the smallest lsn for which there are unflushed dirty blocks in the
 buffer pool. NOTE: this function may only be called if the calling thread owns
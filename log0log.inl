@@ -1,6 +1,7 @@
 #include "os0file.h"
 #include "mach0data.h"
 #include "mtr0mtr.h"
+#include "ul0crc32.h"
 
 ibool log_ceck_log_rec(byte* buf, ulint len, dulint buf_start_lsn);
 
@@ -41,14 +42,37 @@ UNIV_INLINE void log_block_set_hdr_no(byte* log_block, ulint n)
 
 UNIV_INLINE ulint log_block_get_data_len(byte* log_block)
 {
-	return mach_read_from_2(log_block + LOG_BLOCK_HDR_DATA_LEN);
+	return (~LOG_BLOCK_CRC32_BIT_MASK & mach_read_from_2(log_block + LOG_BLOCK_HDR_DATA_LEN));
 }
 
+/*data len,ͬʱCRC32C־λ,־λд̼checksumʱ*/
 UNIV_INLINE void log_block_set_data_len(byte* log_block, ulint len)
 {
+	ut_ad(len <= OS_FILE_LOG_BLOCK_SIZE);
 	mach_write_to_2(log_block + LOG_BLOCK_HDR_DATA_LEN, len);
 }
 
+/*жblockchecksumǷCRC32Cʽ*/
+UNIV_INLINE ibool log_block_get_crc32_bit(byte* log_block)
+{
+	if(LOG_BLOCK_CRC32_BIT_MASK & mach_read_from_2(log_block + LOG_BLOCK_HDR_DATA_LEN))
+		return TRUE;
+
+	return FALSE;
+}
+
+UNIV_INLINE void log_block_set_crc32_bit(byte* log_block, ibool val)
+{
+	ulint field = mach_read_from_2(log_block + LOG_BLOCK_HDR_DATA_LEN);
+
+	if(val)
+		field = field | LOG_BLOCK_CRC32_BIT_MASK;
+	else
+		field = field & (~LOG_BLOCK_CRC32_BIT_MASK);
+
+	mach_write_to_2(log_block + LOG_BLOCK_HDR_DATA_LEN, field);
+}
+
 UNIV_INLINE ulint log_block_get_first_rec_group(byte* log_block)
 {
 	return mach_read_from_2(log_block + LOG_BLOCK_FIRST_REC_GROUP);
@@ -90,7 +114,7 @@ UNIV_INLINE ulint log_block_calc_checksum(byte* block)
 	sum = 1;
 	sh = 0;
 	/*ĸֽӦдcheck sum*/
-	for(i = 0; i < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE, i ++){
+	for(i = 0; i < OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE; i ++){
 		sum = sum & 0x7FFFFFFF;
 		sum += (((ulint)(*(block + i))) << sh) + (ulint)(*(block + i));
 		sh ++;
@@ -101,6 +125,12 @@ UNIV_INLINE ulint log_block_calc_checksum(byte* block)
 	return sum;
 }
 
+/*CRC32Cblockchecksum,ǷΧlog_block_calc_checksumͬ,CRC32C־λ*/
+UNIV_INLINE ulint log_block_calc_crc32(byte* block)
+{
+	return (ulint)ut_crc32(block, OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_TRL_SIZE);
+}
+
 UNIV_INLINE ulint log_block_get_checksum(byte* log_block)
 {
 	return mach_read_from_4(log_block + OS_FILE_LOG_BLOCK_SIZE - LOG_BLOCK_CHECKSUM);
@@ -140,12 +170,14 @@ UNIV_INLINE void log_block_init_in_old_format(byte* log_block, dulint lsn)
 	log_block_set_first_rec_group(log_block, 0);
 }
 
-UNIV_INLINE dulint log_reserve_and_write_fast(byte* str, ulint len ,dulint start_len, ibool* success)
+UNIV_INLINE dulint log_reserve_and_write_fast(byte* str, ulint len, dulint* start_lsn, ibool* success)
 {
 	log_t* log = log_sys;
 	ulint data_len;
 	dulint lsn;
 
+	mutex_enter(&(log->mutex));
+
 	*success = TRUE;
 
 	data_len = len + log->buf_free % OS_FILE_LOG_BLOCK_SIZE;
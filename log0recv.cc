@@ -20,11 +20,18 @@
 #include "btr0cur.h"
 #include "dict0boot.h"
 #include "fil0fil.h"
+#include "os0thread.h"
 
 #define RECV_DATA_BLOCK_SIZE	(MEM_MAX_ALLOC_IN_BUF - sizeof(recv_data_t))
 
 #define RECV_READ_AHEAD_AREA	32
 
+/*Ӧredo־߳*/
+#define RECV_MAX_APPLY_THREADS	32
+
+/*Ӧ־ʱӡȵʱ,λ*/
+#define RECV_PROGRESS_INTERVAL	10
+
 recv_sys_t*		recv_sys = NULL;
 ibool			recv_recovery_on = FALSE;
 ibool			recv_recovery_from_backup_on = FALSE;
@@ -43,6 +50,12 @@ ulint			recv_previous_parsed_rec_is_multi = 0;
 
 #define SYS_MUTEX &(recv_sys->mutex)
 
+/*Ӧ̵߳Ĳ̸߳addr_hashź߳ID*/
+static ulint			recv_apply_thread_parts[RECV_MAX_APPLY_THREADS];
+static os_thread_id_t	recv_apply_thread_ids[RECV_MAX_APPLY_THREADS];
+/*addr_hashķҲӦ̸߳*/
+static ulint			recv_apply_n_parts = 1;
+
 /***************************************************************/
 /*һϵͳָrecv_sys*/
 void recv_sys_create()
@@ -55,6 +68,8 @@ void recv_sys_create()
 
 		recv_sys->heap = NULL;
 		recv_sys->addr_hash = NULL;
+		recv_sys->n_applied = 0;
+		recv_sys->n_apply_threads = 0;
 	}
 }
 
@@ -367,6 +382,9 @@ ibool recv_read_cp_info_for_backup(byte* hdr, dulint* lsn, ulint* offset, ulint*
 /*УϿʽblockϷ*/
 static ibool log_block_checksum_is_ok_old_format(byte* block)
 {
+	/*CRC32Cʽ,ɿͷı־λȷ,ֻһ*/
+	if(log_block_get_crc32_bit(block))
+		return log_block_calc_crc32(block) == log_block_get_checksum(block);
 	/*¸ʽ*/
 	if (log_block_calc_checksum(block) == log_block_get_checksum(block))
 		return TRUE;
@@ -621,7 +639,7 @@ void recv_recover_page(ibool recover_backup, ibool just_read_in, page_t* page, u
 	while(recv){
 		end_lsn = recv->end_lsn;
 		/*recv*/
-		if(recv->end_lsn > RECV_DATA_BLOCK_SIZE){
+		if(recv->len > RECV_DATA_BLOCK_SIZE){
 			buf = mem_alloc(recv->len);
 			recv_data_copy_to_buf(buf, recv);
 		}
@@ -662,6 +680,7 @@ void recv_recover_page(ibool recover_backup, ibool just_read_in, page_t* page, u
 	/*hash cellļ-1,Աrecv_apply_hashed_log_recsȴ*/
 	ut_a(recv_sys->n_addrs);
 	recv_sys->n_addrs --;
+	recv_sys->n_applied ++;
 	mutex_exit(SYS_MUTEX);
 
 	if(!recover_backup && modification_to_page)
@@ -703,38 +722,20 @@ static ulint recv_read_in_area(ulint space, ulint page_no)
 	return(n);
 }
 
-void recv_apply_hashed_log_recs(ibool allow_ibuf)
+/*Ӧaddr_hashŶn_partsȡģpartĹϣͰϵ־ͬpage־
+ÿrecv_addrĴȨstaterecv_sys->mutex죬߳̿ͬʱ*/
+static void recv_apply_hashed_log_recs_low(ulint part, ulint n_parts)
 {
 	recv_addr_t* recv_addr;
 	page_t*	page;
 	ulint	i;
 	ulint	space;
 	ulint	page_no;
-	ulint	n_pages;
-	ibool	has_printed	= FALSE;
 	mtr_t	mtr;
 
-loop:
 	mutex_enter(&(recv_sys->mutex));
 
-	if (recv_sys->apply_batch_on) {
-		mutex_exit(&(recv_sys->mutex));
-		os_thread_sleep(500000);
-		goto loop;
-	}
-
-	if (!allow_ibuf) {
-		ut_ad(mutex_own(&(log_sys->mutex)));
-		recv_no_ibuf_operations = TRUE;
-	} 
-	else
-		ut_ad(!mutex_own(&(log_sys->mutex)));
-
-	/*ʶӦ־*/
-	recv_sys->apply_log_recs = TRUE;
-	recv_sys->apply_batch_on = TRUE;
-
-	for (i = 0; i < hash_get_n_cells(recv_sys->addr_hash); i++) {
+	for (i = part; i < hash_get_n_cells(recv_sys->addr_hash); i += n_parts) {
 		recv_addr = HASH_GET_FIRST(recv_sys->addr_hash, i);
 
 		while (recv_addr) {
@@ -742,14 +743,6 @@ loop:
 			page_no = recv_addr->page_no;
 
 			if (recv_addr->state == RECV_NOT_PROCESSED) {
-				if (!has_printed) {
-					ut_print_timestamp(stderr);
-					fprintf(stderr, 
-						"  InnoDB: Starting an apply batch of log records to the database...\n"
-						"InnoDB: Progress in percents: ");
-					has_printed = TRUE;
-				}
-				
 				mutex_exit(&(recv_sys->mutex));
 
 				if (buf_page_peek(space, page_no)) {
@@ -762,7 +755,7 @@ loop:
 
 					mtr_commit(&mtr);
 				} 
-				else
+				else /*һ첽page_noҪָҳbuf_page_io_completeӦ־*/
 					recv_read_in_area(space, page_no);
 
 				mutex_enter(&(recv_sys->mutex));
@@ -770,20 +763,105 @@ loop:
 
 			recv_addr = HASH_GET_NEXT(addr_hash, recv_addr);
 		}
+	}
+
+	mutex_exit(&(recv_sys->mutex));
+}
+
+/*redo־Ӧ̵߳庯*/
+static void* recv_apply_thread(void* arg)
+{
+	ulint part;
+
+	part = *((ulint*)arg);
+
+	recv_apply_hashed_log_recs_low(part, recv_apply_n_parts);
+
+	mutex_enter(&(recv_sys->mutex));
+	ut_a(recv_sys->n_apply_threads > 0);
+	recv_sys->n_apply_threads --;
+	mutex_exit(&(recv_sys->mutex));
+
+	os_thread_exit(0);
+
+	return NULL;
+}
+
+void recv_apply_hashed_log_recs(ibool allow_ibuf)
+{
+	ulint	i;
+	ulint	n_pages;
+	ulint	n_threads;
+	ulint	n_waits;
+	time_t	start_time;
+	double	time_elapsed;
+	ibool	has_printed	= FALSE;
+
+loop:
+	mutex_enter(&(recv_sys->mutex));
+
+	if (recv_sys->apply_batch_on) {
+		mutex_exit(&(recv_sys->mutex));
+		os_thread_sleep(500000);
+		goto loop;
+	}
+
+	if (!allow_ibuf) {
+		ut_ad(mutex_own(&(log_sys->mutex)));
+		recv_no_ibuf_operations = TRUE;
+	} 
+	else
+		ut_ad(!mutex_own(&(log_sys->mutex)));
 
-		if (has_printed && (i * 100) / hash_get_n_cells(recv_sys->addr_hash) != ((i + 1) * 100) / hash_get_n_cells(recv_sys->addr_hash))
-			fprintf(stderr, "%lu ", (i * 100) / hash_get_n_cells(recv_sys->addr_hash));
+	/*ʶӦ־*/
+	recv_sys->apply_log_recs = TRUE;
+	recv_sys->apply_batch_on = TRUE;
+	recv_sys->n_applied = 0;
+
+	/*addr_hashϣͰֳn_threadsÿһ߳Ӧ*/
+	n_threads = ut_min(ut_max(srv_recv_apply_threads, 1), RECV_MAX_APPLY_THREADS);
+	start_time = time(NULL);
+
+	if (recv_sys->n_addrs > 0) {
+		ut_print_timestamp(stderr);
+		fprintf(stderr, 
+			"  InnoDB: Starting an apply batch of log records to %lu pages with %lu threads...\n",
+			recv_sys->n_addrs, n_threads);
+		has_printed = TRUE;
+	}
+
+	if (n_threads > 1 && recv_sys->n_addrs > 0) {
+		recv_apply_n_parts = n_threads;
+		recv_sys->n_apply_threads = n_threads;
+		mutex_exit(&(recv_sys->mutex));
 
+		for (i = 0; i < n_threads; i++) {
+			recv_apply_thread_parts[i] = i;
+			os_thread_create(recv_apply_thread, recv_apply_thread_parts + i, recv_apply_thread_ids + i);
+		}
+	}
+	else {
+		mutex_exit(&(recv_sys->mutex));
+		recv_apply_hashed_log_recs_low(0, 1);
 	}
-	/* Wait until all the pages have been processed */
-	while (recv_sys->n_addrs != 0) {
+
+	mutex_enter(&(recv_sys->mutex));
+
+	/* Wait until all the pages have been processed and all the apply threads have exited */
+	n_waits = 0;
+	while (recv_sys->n_addrs != 0 || recv_sys->n_apply_threads != 0) {
 		mutex_exit(&(recv_sys->mutex));
 		os_thread_sleep(500000);
 		mutex_enter(&(recv_sys->mutex));
-	}	
 
-	if (has_printed)
-	        fprintf(stderr, "\n");
+		n_waits ++;
+		if (has_printed && n_waits % (2 * RECV_PROGRESS_INTERVAL) == 0) {
+			time_elapsed = 0.001 + difftime(time(NULL), start_time);
+			ut_print_timestamp(stderr);
+			fprintf(stderr, "  InnoDB: Applied log records to %lu pages, %lu pages left, %.2f pages/s\n",
+				recv_sys->n_applied, recv_sys->n_addrs, recv_sys->n_applied / time_elapsed);
+		}
+	}	
 
 	if (!allow_ibuf) {
 		/* Flush all the file pages to disk and invalidate them in
@@ -792,11 +870,10 @@ loop:
 		mutex_exit(&(recv_sys->mutex));
 		mutex_exit(&(log_sys->mutex));
 
-		n_pages = buf_flush_batch(BUF_FLUSH_LIST, ULINT_MAX,
-								ut_dulint_max);
+		n_pages = buf_flush_list(ULINT_MAX, ut_dulint_max);
 		ut_a(n_pages != ULINT_UNDEFINED);
 		
-		buf_flush_wait_batch_end(BUF_FLUSH_LIST);
+		buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
 
 		buf_pool_invalidate();
 
@@ -811,8 +888,11 @@ loop:
 	/*Ѿָ־fil_addr¼*/		
 	recv_sys_empty_hash();
 
-	if (has_printed)
-		fprintf(stderr, "InnoDB: Apply batch completed\n");
+	if (has_printed) {
+		time_elapsed = 0.001 + difftime(time(NULL), start_time);
+		fprintf(stderr, "InnoDB: Apply batch completed, %lu pages in %.0f seconds, %.2f pages/s\n",
+			recv_sys->n_applied, time_elapsed, recv_sys->n_applied / time_elapsed);
+	}
 
 	mutex_exit(&(recv_sys->mutex));
 }
@@ -831,7 +911,7 @@ void recv_apply_log_recs_for_backup(ulint n_data_files, char** data_files, ulint
 	recv_sys->apply_log_recs = TRUE;
 	recv_sys->apply_batch_on = TRUE;
 
-	page = buf_pool->frame_zero;
+	page = buf_pool_from_array(0)->frame_zero;
 
 	/*page*/
 	for(i = 0; i < n_data_files; i ++)
@@ -934,14 +1014,17 @@ static void recv_check_identical(byte* str1, byte* str2, ulint len)
 
 static void recv_compare_relicate(ulint page, ulint page_no)
 {
+	buf_pool_t*	buf_pool;
 	page_t*	replica;
 	page_t*	page;
 	mtr_t	mtr;
 
 	mtr_start(&mtr);
 
+	buf_pool = buf_pool_get(space, page_no);
+
 	mutex_enter(&(buf_pool->mutex));
-	page = buf_page_hash_get(space, page_no)->frame;
+	page = buf_page_hash_get(buf_pool, space, page_no)->frame;
 	mutex_exit(&(buf_pool->mutex));
 
 	replica = buf_page_get(space + RECV_REPLICA_SPACE_ADD, page_no, RW_X_LATCH, &mtr);
@@ -1341,7 +1424,8 @@ ibool recv_scan_log_recs(ibool apply_automatically, ulint available_memory, iboo
 					"InnoDB: Log block no %lu at lsn %lu %lu has\n"
 					"InnoDB: ok header, but checksum field contains %lu, should be %lu\n",
 					no, ut_dulint_get_high(scanned_lsn), ut_dulint_get_low(scanned_lsn),
-					log_block_get_checksum(log_block), log_block_calc_checksum(log_block));
+					log_block_get_checksum(log_block),
+					log_block_get_crc32_bit(log_block) ? log_block_calc_crc32(log_block) : log_block_calc_checksum(log_block));
 			}
 			
 			finished = TRUE;
@@ -1470,6 +1554,8 @@ ulint recv_recovery_from_checkpoint_start(ulint type, dulint limit_lsn, dulint m
 	if(type == LOG_CHECKPOINT){ /*recv_sys*/
 		recv_sys_create();
 		recv_sys_init(FALSE, buf_pool_get_curr_size());
+		/*ָڼҳú뵽flush list*/
+		buf_flush_init_flush_rbt();
 	}
 
 	/*ǿƲִredoָ*/
@@ -1613,6 +1699,7 @@ ulint recv_recovery_from_checkpoint_start(ulint type, dulint limit_lsn, dulint m
 
 	log_sys->buf_free = ut_dulint_get_low(log_sys->lsn) % OS_FILE_LOG_BLOCK_SIZE;
 	log_sys->buf_next_to_write = log_sys->buf_free;
+	log_sys->closed_lsn = log_sys->lsn;
 	log_sys->written_to_some_lsn = log_sys->lsn;
 	log_sys->written_to_all_lsn = log_sys->lsn;
 	log_sys->last_checkpoint_lsn = checkpoint_lsn;
@@ -1643,6 +1730,9 @@ void recv_recovery_from_checkpoint_finish()
 	if(srv_force_recovery < SRV_FORCE_NO_LOG_REDO)
 		recv_apply_hashed_log_recs(TRUE);
 
+	/*е־ѾӦã֮ҳLSN˳*/
+	buf_flush_free_flush_rbt();
+
 	if(log_debug_writes)
 		fprintf(stderr, "InnoDB: Log records applied to the database\n");
 
@@ -1704,6 +1794,7 @@ void recv_reset_logs(dulint lsn, ulint arch_log_no, ibool new_logs_created)
 
 	log_sys->buf_free = LOG_BLOCK_HDR_SIZE;
 	log_sys->lsn = ut_dulint_add(log_sys->lsn, LOG_BLOCK_HDR_SIZE);
+	log_sys->closed_lsn = log_sys->lsn;
 
 	mutex_exit(&(log_sys->mutex));
 
@@ -105,6 +105,8 @@ struct recv_sys_struct
 	mem_heap_t*		heap;				/*recv sysڴ*/
 	hash_table_t*	addr_hash;			/*recv_addrhashspace idpage noΪKEY*/
 	ulint			n_addrs;			/*addr_hashаrecv_addrĸ*/
+	ulint			n_applied;			/*ѾӦ־page,ڴӡ*/
+	ulint			n_apply_threads;	/*λеĲӦ߳*/
 };
 
 extern recv_sys_t*		recv_sys;
@@ -18,7 +18,7 @@ void mlog_write_initial_log_record(byte* ptr, byte type, mtr_t* mtr)
 	byte*	log_ptr;
 
 	ut_ad(type <= MLOG_BIGGEST_TYPE);
-	if(ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end){
+	if(buf_pool_from_frame(ptr) == NULL){
 		fprintf(stderr,"InnoDB: Error: trying to write to a stray memory location %lx\n", (ulint)ptr);
 		ut_a(0);
 	}
@@ -121,7 +121,7 @@ void mlog_write_ulint(byte* ptr, ulint val, byte type, mtr_t* mtr)
 {
 	byte*	log_ptr;
 
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (buf_pool_from_frame(ptr) == NULL) {
 		fprintf(stderr, "InnoDB: Error: trying to write to a stray memory location %lx\n", (ulint)ptr);
 		ut_a(0);
 	}
@@ -152,7 +152,7 @@ void mlog_write_dulint(byte* ptr, dulint val, byte type, mtr_t* mtr)
 {
 	byte*	log_ptr;
 
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (buf_pool_from_frame(ptr) == NULL) {
 		fprintf(stderr, "InnoDB: Error: trying to write to a stray memory location %lx\n", (ulint)ptr);
 		ut_a(0);
 	}
@@ -179,7 +179,7 @@ void mlog_write_string(byte* ptr, byte* str, ulint len, mtr_t* mtr)
 {
 	byte* log_ptr;
 
-	if (ptr < buf_pool->frame_zero || ptr >= buf_pool->high_end) {
+	if (buf_pool_from_frame(ptr) == NULL) {
 		fprintf(stderr, "InnoDB: Error: trying to write to a stray memory location %lx\n", (ulint)ptr);
 		ut_a(0);
 	}
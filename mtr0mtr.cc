@@ -3,6 +3,7 @@
 #include "page0types.h"
 #include "mtr0log.h"
 #include "log0log.h"
+#include "srv0srv.h"
 
 mtr_t* mtr_start_noninline(mtr_t* mtr)
 {
@@ -174,7 +175,9 @@ static ibool mtr_first_to_modify_page_after_backup(mtr_t* mtr, ulint* n_pages)
 	return ret;
 }
 
-static void mtr_log_reserve_and_write(mtr_t* mtr)
+/*mtr־дlog buffer,TRUEʾǲпд,log_sys->mutexѾͷ,Ҫlsn˳ر;
+FALSEʾȻlog_sys->mutex*/
+static ibool mtr_log_reserve_and_write(mtr_t* mtr)
 {
 	dyn_array_t*	mlog;
 	dyn_block_t*	block;
@@ -182,6 +185,7 @@ static void mtr_log_reserve_and_write(mtr_t* mtr)
 	ibool		success;
 	byte*		first_data;
 	ulint		n_modified_pages;
+	ulint		offset;
 
 	ut_ad(mtr);
 
@@ -192,15 +196,32 @@ static void mtr_log_reserve_and_write(mtr_t* mtr)
 	else
 		*first_data = (byte)((ulint)*first_data | MLOG_SINGLE_REC_FLAG);
 
-	if(mlog->heap == NULL){ /*mtr->logֻһblockֱӿд*/
+	/*mloglogݵܳ*/
+	data_size =dyn_array_get_data_size(mlog);
+
+	/*п:ֻlog_sys->mutexԤlsn,־mutex֮⿽*/
+	if(srv_log_parallel_copy && log_reserve_for_copy(data_size, &(mtr->start_lsn), &(mtr->end_lsn), &offset)){
+		if(mtr->log_mode == MTR_LOG_ALL){
+			block = mlog;
+			while(block != NULL){
+				log_write_reserved(dyn_block_get_data(block), dyn_block_get_used(block), &offset);
+				block = dyn_array_get_next_block(mlog, block);
+			}
+		}
+		else{
+			ut_ad(mtr->log_mode == MTR_LOG_NONE);
+		}
+
+		return TRUE;
+	}
+
+	if(!srv_log_parallel_copy && mlog->heap == NULL){ /*mtr->logֻһblockֱӿд*/
 		/*mlogе־Ϣˢlog_sys->buf*/
 		mtr->end_lsn = log_reserve_and_write_fast(first_data, dyn_block_get_used(mlog), &(mtr->start_lsn), &success);
 		if(success)
-			return ;
+			return FALSE;
 	}
 
-	/*mloglogݵܳ*/
-	data_size =dyn_array_get_data_size(mlog);
 	mtr->start_lsn = log_reserve_and_open(data_size);
 	if(mtr->log_mode == MTR_LOG_ALL){
 		/*ȱұ֮ǰҳĶ,ȫҳ־¼*/
@@ -226,11 +247,15 @@ static void mtr_log_reserve_and_write(mtr_t* mtr)
 
 	/*log lsn,log_sys->lsn*/
 	mtr->end_lsn = log_close();
+
+	return FALSE;
 }
 
 /*ύmtr*/
 void mtr_commit(mtr_t* mtr)
 {
+	ibool	parallel_copy	= FALSE;
+
 	ut_ad(mtr);
 	ut_ad(mtr->magic_n == MTR_MAGIC_N);
 	ut_ad(mtr->state == MTR_ACTIVE);
@@ -238,13 +263,21 @@ void mtr_commit(mtr_t* mtr)
 	mtr->state = MTR_COMMITTING;
 
 	if (mtr->modifications) /*ҳĶ־ˢ*/
-		mtr_log_reserve_and_write(mtr);
+		parallel_copy = mtr_log_reserve_and_write(mtr);
 
-	/*ͷŵmtrlatchĿȨ*/
-	mtr_memo_pop_all(mtr);
+	if(parallel_copy){
+		/*lsn˳ر,ҳlsn˳flush list*/
+		log_close_enter(mtr->start_lsn);
+		mtr_memo_pop_all(mtr);
+		log_close_exit(mtr->end_lsn);
+	}
+	else{
+		/*ͷŵmtrlatchĿȨ*/
+		mtr_memo_pop_all(mtr);
 
-	if (mtr->modifications)
-		log_release();
+		if (mtr->modifications)
+			log_release();
+	}
 
 	mtr->state = MTR_COMMITTED;
 
@@ -6,6 +6,10 @@
 #include "fil0fil.h"
 #include "buf0buf.h"
 
+#if defined(LINUX_NATIVE_AIO)
+#include <libaio.h>
+#endif
+
 #undef HAVE_FDATASYNC
 
 /*ļseek mutex*/
@@ -18,6 +22,11 @@ ibool	os_do_not_call_flush_at_each_write = FALSE;
 
 #define OS_AIO_MERGE_N_CONSECUTIVE	64
 
+#if defined(LINUX_NATIVE_AIO)
+/*io_geteventsȴ¼ĳʱʱ,0.5,λ*/
+#define OS_AIO_REAP_TIMEOUT			(500000000UL)
+#endif
+
 /*Ĭϲʹnative aio*/
 ibool	os_aio_use_native_aio = FALSE;
 
@@ -45,6 +54,13 @@ typedef struct os_aio_slot_struct
 #ifdef POSIX_ASYNC_IO
 	struct aiocb	control;				/*posix ƿ*/
 #endif
+
+#if defined(LINUX_NATIVE_AIO)
+	struct iocb		control;			/*linux native aioƿ,iocb.dataָslot*/
+	long			n_bytes;			/*io_geteventsصʵʶдֽ,ʱǸerrno*/
+	long			ret;				/*io_geteventsصres2*/
+	ibool			submit_later;		/*Ԥӳύ,os_aio_simulated_wake_handler_threadsio_submit*/
+#endif
 }os_aio_slot_t;
 
 /*slots arrayṹ*/
@@ -60,6 +76,11 @@ typedef struct os_aio_array_struct
 	os_aio_slot_t*	slots;		/*slots*/
 
 	os_event_t*		events;		/*slots event array*/
+
+#if defined(LINUX_NATIVE_AIO)
+	io_context_t*		aio_ctx;	/*ÿsegmentһaio context,ioֻ߳ոԼsegmentϵ*/
+	struct io_event*	aio_events;	/*io_geteventsĽ,ÿslotһԪ,segmentֶʹ*/
+#endif
 }os_aio_array_t;
 
 os_event_t* os_aio_segment_wait_events = NULL;
@@ -250,7 +271,15 @@ try_again:
 	}
 #endif
 
-	if(create_mode == OF_FILE_CREATE)
+#ifdef O_DIRECT
+	/*ļƹOS page cache,صҳǰUNIV_PAGE_SIZE,O_DIRECTĶҪ
+	logļȻpage cache*/
+	if (type == OS_DATA_FILE && srv_unix_file_flush_method == SRV_UNIX_O_DIRECT) {
+			create_flag = create_flag | O_DIRECT;
+	}
+#endif
+
+	if(create_mode == OS_FILE_CREATE)
 		file = open(name, create_flag, os_innodb_umask);
 	else
 		file = open(name, create_flag);
@@ -277,6 +306,26 @@ ibool os_file_close(os_file_t file)
 	return TRUE;
 }
 
+/*һرպԶɾʱļ,ʧʱ-1*/
+os_file_t os_file_create_tmpfile()
+{
+	FILE*	file;
+	int		fd = -1;
+
+	file = tmpfile();
+	if(file != NULL){
+		fd = dup(fileno(file));
+		fclose(file);
+	}
+
+	if(fd < 0){
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Error: unable to create temporary file; errno: %d\n", errno);
+	}
+
+	return fd;
+}
+
 ibool os_file_get_size(os_file_t file, ulint* size, ulint* size_high)
 {
 	off_t offs = lseek(file, 0, SEEK_END);
@@ -477,7 +526,7 @@ ibool os_file_write(char* name, os_file_t file, void* buf, ulint offset, ulint o
 {
 	ssize_t ret;
 	ret = os_file_pwrite(file, buf, n, offset, offset_high);
-	if((ulint) ret = n)
+	if((ulint) ret == n)
 		return TRUE;
 
 	if(!os_has_said_disk_full){
@@ -509,6 +558,9 @@ static os_aio_array_t* os_aio_array_create(ulint n, ulint n_segments)
 	os_aio_array_t* array;
 	ulint			i;
 	os_aio_slot_t*	slot;
+#if defined(LINUX_NATIVE_AIO)
+	int				ret;
+#endif
 
 	ut_a(n > 0);
 	ut_a(n_segments > 0);
@@ -533,9 +585,50 @@ static os_aio_array_t* os_aio_array_create(ulint n, ulint n_segments)
 		slot->reserved = FALSE;
 	}
 
+#if defined(LINUX_NATIVE_AIO)
+	array->aio_ctx = NULL;
+	array->aio_events = NULL;
+
+	if(os_aio_use_native_aio){
+		array->aio_ctx = ut_malloc(n_segments * sizeof(io_context_t));
+		for(i = 0; i < n_segments; i ++){
+			/*ÿsegmentaio contextͬʱn / n_segments*/
+			memset(&(array->aio_ctx[i]), 0, sizeof(io_context_t));
+			ret = io_setup(n / n_segments, &(array->aio_ctx[i]));
+			if(ret != 0){
+				ut_print_timestamp(stderr);
+				fprintf(stderr, "  InnoDB: Error: io_setup() failed with error %d.\n"
+					"InnoDB: Check /proc/sys/fs/aio-max-nr or disable native aio.\n", ret);
+				ut_error;
+			}
+		}
+
+		array->aio_events = ut_malloc(n * sizeof(struct io_event));
+		memset(array->aio_events, 0, n * sizeof(struct io_event));
+	}
+#endif
+
 	return array;
 }
 
+#if defined(LINUX_NATIVE_AIO)
+/*ںǷ֧native aio,֧ʱ(ĳЩ⻯)˻صģaio*/
+static ibool os_aio_linux_supported()
+{
+	io_context_t	io_ctx;
+	int				ret;
+
+	memset(&io_ctx, 0, sizeof(io_ctx));
+	ret = io_setup(1, &io_ctx);
+	if(ret != 0)
+		return FALSE;
+
+	io_destroy(io_ctx);
+
+	return TRUE;
+}
+#endif
+
 /*aioĳʼ*/
 void os_aio_init(ulint n, ulint n_segments, ulint n_slots_sync)
 {
@@ -553,6 +646,15 @@ void os_aio_init(ulint n, ulint n_segments, ulint n_slots_sync)
 
 	os_io_init_simple();
 
+#if defined(LINUX_NATIVE_AIO)
+	if(os_aio_use_native_aio && !os_aio_linux_supported()){
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Warning: Linux native AIO is not supported on this system,\n"
+			"InnoDB: falling back to simulated aio.\n");
+		os_aio_use_native_aio = FALSE;
+	}
+#endif
+
 	/*дnsegment԰֣Ԥ2ibuflog*/
 	n_per_seg = n / n_segments;			 /*ÿsegmentվslotsĸ*/
 	n_write_segs = (n_segments - 2) / 2;
@@ -679,10 +781,10 @@ loop:
 	os_mutex_enter(array->mutex);
 	/*array slots޿еԪ*/
 	if(array->n_reserved == array->n_slots){
-		os_mutex_enter(array->mutex);
+		os_mutex_exit(array->mutex);
 		
-		if(!os_aio_use_native_aio)
-			os_aio_simulated_wake_handler_threads();
+		/*native aio¿Լӳύռarray,ύȥ*/
+		os_aio_simulated_wake_handler_threads();
 
 		/*ȴһпеź*/
 		os_event_wait(array->not_full);
@@ -729,6 +831,25 @@ loop:
 
 	control->aio_sigevent.sigev_value.sival_ptr = slot;
 #endif
+
+#if defined(LINUX_NATIVE_AIO)
+	if(os_aio_use_native_aio){
+		off_t	aio_offset;
+
+		aio_offset = (off_t)offset + (((off_t)offset_high) << 32);
+		if(type == OS_FILE_READ)
+			io_prep_pread(&(slot->control), file, buf, len, aio_offset);
+		else{
+			ut_a(type == OS_FILE_WRITE);
+			io_prep_pwrite(&(slot->control), file, buf, len, aio_offset);
+		}
+
+		slot->control.data = (void*)slot;
+		slot->n_bytes = 0;
+		slot->ret = 0;
+		slot->submit_later = FALSE;
+	}
+#endif
 	os_mutex_exit(array->mutex);
 
 	return slot;
@@ -756,6 +877,63 @@ static void os_aio_array_free_slot(os_aio_array_t* array, os_aio_slot_t* slot)
 	os_mutex_exit(array->mutex);
 }
 
+#if defined(LINUX_NATIVE_AIO)
+/*os_aio_linux_dispatch_pendingÿio_submitύ*/
+#define OS_AIO_DISPATCH_BATCH	64
+
+/*arrayӳύĶsegment(aio context),ÿþٵio_submitύ,
+һԤɴ˱ϵͳáarray->mutexֻռiocbʱ,
+io_submitmutex֮,ᵲס̱߳slot*/
+static void os_aio_linux_dispatch_pending(os_aio_array_t* array)
+{
+	os_aio_slot_t*	slot;
+	struct iocb*	iocbs[OS_AIO_DISPATCH_BATCH];
+	ulint			n_per_seg;
+	ulint			n_pending;
+	ulint			seg;
+	ulint			i;
+	int				ret;
+
+	n_per_seg = array->n_slots / array->n_segments;
+
+	for(seg = 0; seg < array->n_segments; seg ++){
+next_batch:
+		/*ȡsubmit_lateriocb,ʶԺ̲߳ظύ*/
+		n_pending = 0;
+		os_mutex_enter(array->mutex);
+		for(i = seg * n_per_seg; i < (seg + 1) * n_per_seg && n_pending < OS_AIO_DISPATCH_BATCH; i ++){
+			slot = os_aio_array_get_nth_slot(array, i);
+			if(slot->reserved && slot->submit_later){
+				slot->submit_later = FALSE;
+				iocbs[n_pending ++] = &(slot->control);
+			}
+		}
+		os_mutex_exit(array->mutex);
+
+		/*io_submitֻύһ,ʣµļύ;ʱos_aioһos_file_handle_errorǷ*/
+		i = 0;
+		while(i < n_pending){
+			ret = io_submit(array->aio_ctx[seg], (long)(n_pending - i), iocbs + i);
+			if(ret > 0){
+				i += (ulint)ret;
+				continue;
+			}
+
+			/*һҲûύ,ںaioԴʱ*/
+			errno = (ret == 0) ? EAGAIN : -ret;
+			if(!os_file_handle_error(NULL, NULL)){
+				ut_print_timestamp(stderr);
+				fprintf(stderr, "  InnoDB: Error: io_submit() of %lu requests failed with error %d.\n", n_pending - i, ret);
+				ut_error;
+			}
+		}
+
+		if(n_pending == OS_AIO_DISPATCH_BATCH)
+			goto next_batch;
+	}
+}
+#endif
+
 /*һģaio߳*/
 static void os_aio_simulated_wake_handler_thread(ulint global_segment)
 {
@@ -788,8 +966,13 @@ void os_aio_simulated_wake_handler_threads()
 {
 	ulint i;
 	
-	if(os_aio_use_native_aio)
+	if(os_aio_use_native_aio){
+#if defined(LINUX_NATIVE_AIO)
+		/*native aioûҪѵģiọ߳ԤӳύĶύ*/
+		os_aio_linux_dispatch_pending(os_aio_read_array);
+#endif
 		return;
+	}
 
 	os_aio_recommend_sleep_for_read_threads = FALSE;
 	for(i = 0; i < os_aio_n_segments; i ++){
@@ -805,15 +988,41 @@ void os_aio_simulated_put_read_threads_to_sleep()
 	os_aio_recommend_sleep_for_read_threads = TRUE;
 
 	for(g = 0; g < os_aio_n_segments; g++){
-		os_aio_get_array_and_local_segment(array, g);
+		os_aio_get_array_and_local_segment(&array, g);
 		if(array == os_aio_read_array) /*ǶslotsΪevent waiting״̬*/
 			os_event_reset(os_aio_segment_wait_events[g]);
 	}
 }
 
+#if defined(LINUX_NATIVE_AIO)
+/*slot׼õiocbύslotsegmentaio context*/
+static ibool os_aio_linux_dispatch(os_aio_array_t* array, os_aio_slot_t* slot)
+{
+	struct iocb*	iocb;
+	ulint			io_ctx_index;
+	int				ret;
+
+	ut_ad(slot->reserved);
+
+	iocb = &(slot->control);
+	io_ctx_index = (slot->pos * array->n_segments) / array->n_slots;
+
+	/*io_submitύɹ,ʱظerrno*/
+	ret = io_submit(array->aio_ctx[io_ctx_index], 1, &iocb);
+	if(ret != 1){
+		errno = -ret;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+#endif
+
 ibool os_aio(ulint type, ulint mode, char* name, os_file_t file, void* buf, ulint offset, ulint offset_high, 
 	ulint n, void* message1, void* message2)
 {
+	os_aio_array_t*	array;
+	os_aio_slot_t*	slot;
 	ulint		err	= 0;
 	ibool		retry;
 	ulint		wake_later;
@@ -868,6 +1077,16 @@ try_again:
 			slot->control.aio_lio_opcode = LIO_READ;
 			err = (ulint) aio_read(&(slot->control));
 			printf("Starting Posix aio read %lu\n", err);
+#endif
+#if defined(LINUX_NATIVE_AIO)
+			if(wake_later && array == os_aio_read_array){
+				/*Ԥһɵ֮os_aio_simulated_wake_handler_threadsͳһύ*/
+				os_mutex_enter(array->mutex);
+				slot->submit_later = TRUE;
+				os_mutex_exit(array->mutex);
+			}
+			else if(!os_aio_linux_dispatch(array, slot))
+				err = 1;
 #endif
 		}
 		else{
@@ -881,6 +1100,10 @@ try_again:
 			slot->control.aio_lio_opcode = LIO_WRITE;
 			err = (ulint) aio_write(&(slot->control));
 			printf("Starting Posix aio write %lu\n", err);
+#endif
+#if defined(LINUX_NATIVE_AIO)
+			if(!os_aio_linux_dispatch(array, slot))
+				err = 1;
 #endif
 		}
 		else{
@@ -908,7 +1131,7 @@ try_again:
 }
 
 #ifdef POSIX_ASYNC_IO
-ibool os_aio_posix_hadle(ulint array_no, void** message1, void** message2)
+ibool os_aio_posix_handle(ulint array_no, void** message1, void** message2)
 {
 	os_aio_array_t*	array;
 	os_aio_slot_t*	slot;
@@ -952,8 +1175,128 @@ ibool os_aio_posix_hadle(ulint array_no, void** message1, void** message2)
 }
 #endif
 
+#if defined(LINUX_NATIVE_AIO)
+/*segmentaio contextոɵio,ѽ¼Ӧslotϡʱ߱źŴʱֱӷ,
+ɵ¼*/
+static void os_aio_linux_collect(os_aio_array_t* array, ulint segment, ulint seg_size)
+{
+	struct io_event*	events;
+	struct timespec		timeout;
+	struct iocb*		control;
+	os_aio_slot_t*		slot;
+	ulint				start_pos;
+	ulint				end_pos;
+	int					ret;
+	int					i;
+
+	start_pos = segment * seg_size;
+	end_pos = start_pos + seg_size;
+
+	/*ÿsegmentֻʹeventsԼһ*/
+	events = &(array->aio_events[start_pos]);
+
+	timeout.tv_sec = 0;
+	timeout.tv_nsec = OS_AIO_REAP_TIMEOUT;
+
+	ret = io_getevents(array->aio_ctx[segment], 1, seg_size, events, &timeout);
+	if(ret > 0){
+		os_mutex_enter(array->mutex);
+		for(i = 0; i < ret; i ++){
+			control = (struct iocb*)events[i].obj;
+			ut_a(control != NULL);
+
+			slot = (os_aio_slot_t*)control->data;
+			ut_a(slot->reserved);
+			ut_a(slot->pos >= start_pos && slot->pos < end_pos);
+
+			slot->n_bytes = (long)events[i].res;
+			slot->ret = (long)events[i].res2;
+			slot->io_already_done = TRUE;
+		}
+		os_mutex_exit(array->mutex);
+
+		return;
+	}
+
+	/*ʱ߱źŴ*/
+	if(ret == 0 || ret == -EINTR)
+		return;
+
+	ut_print_timestamp(stderr);
+	fprintf(stderr, "  InnoDB: Error: io_getevents() returned %d.\n", ret);
+	ut_error;
+}
+
+/*linux native aioio̴߳,ÿioֻ߳ոԼsegmentɵ*/
+ibool os_aio_linux_handle(ulint global_segment, void** message1, void** message2, ulint* type)
+{
+	os_aio_array_t*	array;
+	os_aio_slot_t*	slot;
+	ulint			segment;
+	ulint			n;
+	ulint			i;
+	ibool			ret;
+
+	ut_a(os_aio_use_native_aio);
+
+	segment = os_aio_get_array_and_local_segment(&array, global_segment);
+	n = array->n_slots / array->n_segments;
+
+	for(;;){
+		srv_io_thread_op_info[global_segment] = (char*)"looking for completed aio requests";
+
+		/*Ѿոûдslot*/
+		os_mutex_enter(array->mutex);
+		for(i = 0; i < n; i ++){
+			slot = os_aio_array_get_nth_slot(array, i + segment * n);
+			if(slot->reserved && slot->io_already_done)
+				break;
+		}
+		os_mutex_exit(array->mutex);
+
+		if(i < n)
+			break;
+
+		srv_io_thread_op_info[global_segment] = (char*)"waiting for completed aio requests";
+		os_aio_linux_collect(array, segment, n);
+	}
+
+	srv_io_thread_op_info[global_segment] = (char*)"processing completed aio requests";
+
+	ut_a(slot->reserved);
+
+	*message1 = slot->message1;
+	*message2 = slot->message2;
+	*type = slot->type;
+
+	if(slot->ret == 0 && slot->n_bytes == (long)slot->len){
+		ret = TRUE;
+
+		if(slot->type == OS_FILE_WRITE && !os_do_not_call_flush_at_each_write)
+			ut_a(TRUE == os_file_flush(slot->file));
+	}
+	else{
+		ret = FALSE;
+
+		ut_print_timestamp(stderr);
+		fprintf(stderr, "  InnoDB: Error: native aio %s of %lu bytes at offset %lu %lu in file %s returned %ld\n",
+			slot->type == OS_FILE_READ ? "read" : "write", slot->len, slot->offset_high, slot->offset,
+			slot->name, slot->n_bytes);
+
+		if(slot->n_bytes < 0){
+			errno = (int)(-slot->n_bytes);
+			os_file_get_last_error();
+		}
+	}
+
+	os_aio_array_free_slot(array, slot);
+
+	return ret;
+}
+#endif
+
 /*ģaioķ*/
-ibool os_aio_simulated_handle(ulint global_segment, void** message1, void** message2, ulint type)
+ibool os_aio_simulated_handle(ulint global_segment, void** message1, void** message2, ulint* type)
 {
 	os_aio_array_t*	array;
 	ulint		segment;
@@ -972,6 +1315,7 @@ ibool os_aio_simulated_handle(ulint global_segment, void** message1, void** mess
 	ulint		len2;
 
 	segment = os_aio_get_array_and_local_segment(&array, global_segment);
+	n = array->n_slots / array->n_segments;
 
 restart:
 	ut_ad(os_aio_validate());
@@ -74,6 +74,8 @@ os_file_t		os_file_create(char* name, ulint create_mode, ulint purpose, ulint ty
 
 ibool			os_file_close(os_file_t file);
 
+os_file_t		os_file_create_tmpfile();
+
 /*ļĳߴ*/
 ibool			os_file_get_size(os_file_t file, ulint* size, ulint* size_high);
 /*ļĳߴ*/
@@ -101,6 +103,11 @@ void			os_aio_simulated_put_read_threads_to_sleep();
 ibool			os_aio_posix_handle(ulint array_no, void** message1, void** message2);
 #endif
 
+#if defined(LINUX_NATIVE_AIO)
+/*linux native aio(io_submit/io_getevents),ÿsegmentһaio context*/
+ibool			os_aio_linux_handle(ulint global_segment, void** message1, void** message2, ulint* type);
+#endif
+
 ibool			os_aio_simulated_handle(ulint segment, void** message1, void** message2, ulint* type);
 
 /*һЩԺ*/
@@ -1,6 +1,9 @@
 #ifdef __WIN__
 #include <winbase.h>
 #include <windows.h>
+#else
+#include <sys/time.h>
+#include <errno.h>
 #endif
 
 #include "os0sync.h"
@@ -37,6 +40,7 @@ os_event_t os_event_create(char* name)
 
 	event = ut_malloc(sizeof(struct os_event_struct));
 	os_fast_mutex_init(&event->os_mutex);
+	pthread_cond_init(&(event->cond_var), NULL);
 	event->is_set = FALSE;
 
 	return event;
@@ -63,9 +67,9 @@ void os_event_set(os_event_t event)
 	ut_a(SetEvent(event));
 #else
 	ut_a(event);
-	os_fast_mutex_lock(event->os_mutex);
+	os_fast_mutex_lock(&(event->os_mutex));
 	if(!event->is_set){
-		event->is_event = TRUE;
+		event->is_set = TRUE;
 		pthread_cond_broadcast(&(event->cond_var));
 	}
 	os_fast_mutex_unlock(&(event->os_mutex));
@@ -79,7 +83,7 @@ void os_event_reset(os_event_t event)
 	ut_a(ResetEvent(event));
 #else
 	ut_a(event);
-	os_fast_mutex_lock(&(event_os_mutex));
+	os_fast_mutex_lock(&(event->os_mutex));
 	if(event->is_set)
 		event->is_set = FALSE;
 	os_fast_mutex_unlock(&(event->os_mutex));
@@ -88,12 +92,14 @@ void os_event_reset(os_event_t event)
 
 void os_event_free(os_event_t event)
 {
-#ifndef __WIN__
+#ifdef __WIN__
 	ut_a(event);
 	ut_a(CloseHandle(event));
 #else
 	ut_a(event);
 	os_fast_mutex_free(&(event->os_mutex));
+	pthread_cond_destroy(&(event->cond_var));
+	ut_free(event);
 #endif
 }
 
@@ -118,7 +124,7 @@ loop:
 #endif
 }
 
-void os_event_wait_time(os_event_t event, ulint time)
+ulint os_event_wait_time(os_event_t event, ulint time)
 {
 #ifdef __WIN__
 	DWORD	err;
@@ -139,9 +145,38 @@ void os_event_wait_time(os_event_t event, ulint time)
 		ut_error;
 		return(1000000); /* dummy value to eliminate compiler warn. */
 	}
-#else /*posixģʽ޷ʱȴֻ޵ȴֱźŴ*/
-	os_event_wait(event);
-	return 0;
+#else /*timeĵλ΢,pthread_cond_timedwaitʱȴ*/
+	struct timeval	tv;
+	struct timespec	abstime;
+	ulint			ret = 0;
+
+	ut_a(event);
+	if(time == OS_SYNC_INFINITE_TIME){
+		os_event_wait(event);
+		return 0;
+	}
+
+	gettimeofday(&tv, NULL);
+	tv.tv_sec += time / 1000000;
+	tv.tv_usec += time % 1000000;
+	if(tv.tv_usec >= 1000000){
+		tv.tv_sec ++;
+		tv.tv_usec -= 1000000;
+	}
+	abstime.tv_sec = tv.tv_sec;
+	abstime.tv_nsec = tv.tv_usec * 1000;
+
+	os_fast_mutex_lock(&(event->os_mutex));
+	while(!event->is_set){
+		if(pthread_cond_timedwait(&(event->cond_var), &(event->os_mutex), &abstime) == ETIMEDOUT){
+			if(!event->is_set)
+				ret = OS_SYNC_TIME_EXCEEDED;
+			break;
+		}
+	}
+	os_fast_mutex_unlock(&(event->os_mutex));
+
+	return ret;
 #endif
 }
 
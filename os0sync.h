@@ -7,7 +7,7 @@
 #define os_fast_mutex_t CRITICAL_SECTION
 typedef void*	os_event_t;
 #else /*posixϵͳ*/
-typedef pthread_mutex	os_fast_mutex_t;
+typedef pthread_mutex_t	os_fast_mutex_t;
 struct os_event_struct
 {
 	os_fast_mutex_t	os_mutex;
@@ -47,6 +47,35 @@ void		os_fast_mutex_trylock(os_fast_mutex_t* fast_mutex);
 void		os_fast_mutex_unlock(os_fast_mutex_t* fast_mutex);
 void		os_fast_mutex_lock(os_fast_mutex_t* fast_mutex);
 
+/*ԭӲGCC__syncڽṩfull memory barrier*/
+#if defined(__GNUC__) && !defined(HAVE_ATOMIC_BUILTINS)
+#define HAVE_ATOMIC_BUILTINS
+#endif
+
+#ifdef HAVE_ATOMIC_BUILTINS
+/**ptr == old_val,*ptrónew_valTRUE,򷵻FALSE*/
+#define os_compare_and_swap(ptr, old_val, new_val)		__sync_bool_compare_and_swap(ptr, old_val, new_val)
+#define os_compare_and_swap_lint(ptr, old_val, new_val)	os_compare_and_swap(ptr, old_val, new_val)
+#define os_compare_and_swap_ulint(ptr, old_val, new_val)	os_compare_and_swap(ptr, old_val, new_val)
+#define os_compare_and_swap_thread_id(ptr, old_val, new_val) os_compare_and_swap(ptr, old_val, new_val)
+
+/*ԭӼӼزֵ֮*/
+#define os_atomic_increment(ptr, amount)				__sync_add_and_fetch(ptr, amount)
+#define os_atomic_increment_lint(ptr, amount)			os_atomic_increment(ptr, amount)
+#define os_atomic_increment_ulint(ptr, amount)			os_atomic_increment(ptr, amount)
+#define os_atomic_decrement(ptr, amount)				__sync_sub_and_fetch(ptr, amount)
+#define os_atomic_decrement_lint(ptr, amount)			os_atomic_decrement(ptr, amount)
+#define os_atomic_decrement_ulint(ptr, amount)			os_atomic_decrement(ptr, amount)
+
+/**ptrónew_valԭֵ*/
+#define os_atomic_test_and_set_byte(ptr, new_val)		__sync_lock_test_and_set(ptr, (byte)new_val)
+#define os_atomic_test_and_set_ulint(ptr, new_val)		__sync_lock_test_and_set(ptr, new_val)
+
+/*ڴ*/
+#define os_mb											__sync_synchronize()
+#endif
+
+
 #endif
 
 
@@ -8,6 +8,24 @@
 ulint page_cur_short_succ = 0;
 ulint page_rnd = 976722341;
 
+/*ֲtupleҳм¼ıȽ:tupleתnormalized keyʱ(nkeyΪNULL)ֱӰֽڱȽ,
+recƫƺбȽ*/
+UNIV_INLINE int page_cur_cmp_tuple_rec(dtuple_t* tuple, cmp_norm_key_t* nkey, rec_t* rec, ulint** offsets, mem_heap_t** heap,
+	ulint* matched_fields, ulint* matched_bytes)
+{
+	int	cmp;
+
+	if(nkey != NULL && !(rec_get_info_bits(rec) & REC_INFO_MIN_REC_FLAG)){
+		cmp = cmp_norm_key_rec_with_match(nkey, rec, matched_fields, matched_bytes);
+		ut_ad(cmp == cmp_dtuple_rec(tuple, rec));
+		return cmp;
+	}
+
+	*offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(tuple), *offsets, heap);
+
+	return cmp_dtuple_rec_with_match(tuple, rec, *offsets, matched_fields, matched_bytes);
+}
+
 #ifdef PAGE_CUR_ADAPT
 
 UNIV_INLINE ibool page_cur_try_search_shortcut(page_t* page, dtuple_t* tuple, 
@@ -20,9 +38,15 @@ UNIV_INLINE ibool page_cur_try_search_shortcut(page_t* page, dtuple_t* tuple,
 	ulint	low_bytes;
 	ulint	up_match;
 	ulint	up_bytes;
+	ibool	success		= FALSE;
+	mem_heap_t*	heap	= NULL;
+	ulint	offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*	offsets		= offsets_;
 
 	ut_ad(dtuple_check_typed(tuple));
 
+	rec_offs_init(offsets_);
+
 	/*һβrec_t*/
 	rec = page_header_get_ptr(page, PAGE_LAST_INSERT);
 	ut_ad(rec);
@@ -34,14 +58,16 @@ UNIV_INLINE ibool page_cur_try_search_shortcut(page_t* page, dtuple_t* tuple,
 	up_bytes = low_bytes;
 
 	/*TUPLEǷ񳬳Χ*/
-	cmp = page_cmp_dtuple_rec_with_match(tuple, rec, &low_match, &low_bytes);
+	offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(tuple), offsets, &heap);
+	cmp = page_cmp_dtuple_rec_with_match(tuple, rec, offsets, &low_match, &low_bytes);
 	if(cmp == -1) /*rec > tuple,FALSE*/
-		return FALSE;
+		goto exit_func;
 
 	next_rec = page_rec_get_next(rec); 
-	cmp = page_cmp_dtuple_rec_with_match(tuple, next_rec, &up_match, &up_bytes);
+	offsets = rec_get_offsets(next_rec, dtuple_get_n_fields_cmp(tuple), offsets, &heap);
+	cmp = page_cmp_dtuple_rec_with_match(tuple, next_rec, offsets, &up_match, &up_bytes);
 	if(cmp != -1) /*next_rec <= tuple,FALSE*/
-		return FALSE;
+		goto exit_func;
 
 	cursor->rec = rec;
 	if(next_rec != page_get_supremum_rec(page)){
@@ -52,7 +78,13 @@ UNIV_INLINE ibool page_cur_try_search_shortcut(page_t* page, dtuple_t* tuple,
 	*ilow_matched_fields = low_match;
 	*ilow_matched_bytes = low_bytes;
 
-	return TRUE;
+	success = TRUE;
+
+exit_func:
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return success;
 }
 #endif
 
@@ -74,6 +106,13 @@ void page_cur_search_with_match(page_t* page, dtuple_t* tuple, ulint mode,
 	ulint	cur_matched_fields;
 	ulint	cur_matched_bytes;
 	int	cmp;
+	mem_heap_t*	heap	= NULL;
+	ulint	offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*	offsets		= offsets_;
+	cmp_norm_key_t	nkey_buf;
+	cmp_norm_key_t*	nkey	= NULL;
+
+	rec_offs_init(offsets_);
 
 	ut_ad(page && tuple && iup_matched_fields && iup_matched_bytes && ilow_matched_fields && ilow_matched_bytes && cursor);
 
@@ -106,6 +145,10 @@ void page_cur_search_with_match(page_t* page, dtuple_t* tuple, ulint mode,
 	low_matched_fields = *ilow_matched_fields;
 	low_matched_bytes  = *ilow_matched_bytes;
 
+	/*֮һnormalized key,ԺÿαȽֻֽڱȽ*/
+	if(cmp_norm_key_init(&nkey_buf, tuple))
+		nkey = &nkey_buf;
+
 	low = 0;
 	up = page_dir_get_n_slots(page) - 1;
 
@@ -120,13 +163,13 @@ void page_cur_search_with_match(page_t* page, dtuple_t* tuple, ulint mode,
 			low_matched_fields, low_matched_bytes,
 			up_matched_fields, up_matched_bytes);
 
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec, &cur_matched_fields, &cur_matched_bytes);
-		if(cmp == -1){
+		cmp = page_cur_cmp_tuple_rec(tuple, nkey, mid_rec, &offsets, &heap, &cur_matched_fields, &cur_matched_bytes);
+		if(cmp == 1){
 			low = mid;
 			low_matched_fields = cur_matched_fields;
 			low_matched_bytes = cur_matched_bytes;
 		}
-		else if(cmp == 1){
+		else if(cmp == -1){
 			up = mid;
 			up_matched_fields = cur_matched_fields;
 			up_matched_bytes = cur_matched_bytes; 
@@ -157,7 +200,7 @@ void page_cur_search_with_match(page_t* page, dtuple_t* tuple, ulint mode,
 			low_matched_fields, low_matched_bytes,
 			up_matched_fields, up_matched_bytes);
 
-		cmp = cmp_dtuple_rec_with_match(tuple, mid_rec,
+		cmp = page_cur_cmp_tuple_rec(tuple, nkey, mid_rec, &offsets, &heap,
 			&cur_matched_fields,
 			&cur_matched_bytes);
 
@@ -191,6 +234,9 @@ void page_cur_search_with_match(page_t* page, dtuple_t* tuple, ulint mode,
 	*iup_matched_bytes   = up_matched_bytes;
 	*ilow_matched_fields = low_matched_fields;
 	*ilow_matched_bytes  = low_matched_bytes;
+
+	if(heap != NULL)
+		mem_heap_free(heap);
 }
 
 /*ȡһ¼Ϊαָ*/
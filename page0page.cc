@@ -3,6 +3,7 @@
 #include "lock0lock.h"
 #include "fut0lst.h"
 #include "btr0sea.h"
+#include "btr0btr.h"
 #include "buf0buf.h"
 
 page_t* page_template = NULL;
@@ -84,22 +85,25 @@ static ibool page_dir_slot_check(page_dir_slot_t* slot)
 	return TRUE;
 }
 
-void page_set_max_trx_id(page_t* page, dunlint trx_id)
+void page_set_max_trx_id(page_t* page, dulint trx_id)
 {
-	buf_block_t* block;
+	buf_block_t*	block;
+	rw_lock_t*		latch;
 
 	ut_ad(page);
 
-	block = buf_block_agign(page);
+	block = buf_block_align(page);
+	/*pageindexӦhashlatch*/
+	latch = btr_search_get_latch_by_id(btr_page_get_index_id(page));
 
 	/*b treeseach latchȨ*/
 	if(block->is_hashed)
-		rw_lock_x_lock(&btr_search_latch);
+		rw_lock_x_lock(latch);
 	/*ID*/
 	mach_write_to_8(page + PAGE_HEADER + PAGE_MAX_TRX_ID, trx_id);
 
 	if(block->is_hashed)
-		rw_lock_x_unlock(&btr_search_latch);
+		rw_lock_x_unlock(latch);
 }
 
 byte* page_mem_alloc(page_t* page, ulint need, ulint* heap_no)
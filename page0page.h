@@ -89,7 +89,7 @@ UNIV_INLINE rec_t*		page_get_supremum_rec(page_t* page);
 
 rec_t*					page_get_middle_rec(page_t* page);
 
-UNIV_INLINE int			page_cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_fields, ulint* matched_bytes);
+UNIV_INLINE int			page_cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, const ulint* offsets, ulint* matched_fields, ulint* matched_bytes);
 
 UNIV_INLINE ulint		page_get_n_recs(page_t* page);
 
@@ -149,7 +149,7 @@ UNIV_INLINE ibool page_rec_is_last_user_rec(rec_t* rec)
 	return FALSE;
 }
 
-UNIV_INLINE int page_cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_fields, ulint* matched_bytes)
+UNIV_INLINE int page_cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, const ulint* offsets, ulint* matched_fields, ulint* matched_bytes)
 {
 	page_t* page;
 
@@ -161,7 +161,7 @@ UNIV_INLINE int page_cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, uli
 	else if(rec == page_get_supremum_rec(page))
 		return -1;
 	else
-		return cmp_dtuple_rec_with_match(dtuple, rec, matched_fields, matched_bytes);
+		return cmp_dtuple_rec_with_match(dtuple, rec, offsets, matched_fields, matched_bytes);
 
 }
 
@@ -2,26 +2,64 @@
 
 #include "srv0srv.h"
 #include "trx0sys.h"
+#include "ut0mem.h"
 
-/*һread_view_t*/
-UNIV_INLINE read_view_t* read_view_create_low(ulint n, mem_heap_t* heap)
+/*trx_sys->active_idsĿ,active_idsûб仯ʱֱӹһεĿ*/
+static read_view_snap_t* read_view_snap_get()
 {
-	read_view_t* view  = mem_heap_alloc(heap, sizeof(read_view_t));
-	view->n_trx_ids  = n;
-	view->trx_ids = mem_heap_alloc(heap, n * sizeof(dulint));
+	read_view_snap_t*	snap;
+	ulint				n;
 
-	return view;
+	ut_ad(mutex_own(&kernel_mutex));
+
+	snap = trx_sys->view_snap;
+	if(snap == NULL){
+		n = trx_sys->n_active_ids;
+
+		snap = ut_malloc(sizeof(read_view_snap_t) + n * sizeof(dulint));
+		snap->ref_count = 1; /*trx_sys->view_snapе*/
+		snap->n_ids = n;
+		snap->ids = (dulint*)(snap + 1);
+		if(n > 0)
+			ut_memcpy(snap->ids, trx_sys->active_ids, n * sizeof(dulint));
+
+		trx_sys->view_snap = snap;
+	}
+
+	snap->ref_count ++;
+
+	return snap;
 }
 
-/*cr_trxread_view,sys_trxϵread viewеtrx_ids*/
+/*ͷŶԿյһ,ûʱͷſ*/
+void read_view_snap_release(read_view_snap_t* snap)
+{
+	ut_ad(mutex_own(&kernel_mutex));
+	ut_ad(snap->ref_count > 0);
+
+	snap->ref_count --;
+	if(snap->ref_count == 0)
+		ut_free(snap);
+}
+
+/*viewÿsnap,view->low_limit_idѾ*/
+UNIV_INLINE void read_view_attach_snap(read_view_t* view, read_view_snap_t* snap)
+{
+	view->snap = snap;
+	view->n_trx_ids = snap->n_ids;
+	view->trx_ids = snap->ids;
+
+	if(snap->n_ids > 0) /*СĻԾtrx id*/
+		view->up_limit_id = snap->ids[0];
+	else
+		view->up_limit_id = view->low_limit_id;
+}
+
+/*cr_trxread_view,sys_trxϵread viewеtrx_ids*/
 read_view_t* read_view_oldest_copy_or_open_new(trx_t* cr_trx, mem_heap_t* heap)
 {
 	read_view_t*	old_view;
 	read_view_t*	view_copy;
-	ibool		needs_insert = TRUE;
-	ulint		insert_done	= 0;
-	ulint		n;
-	ulint		i;
 
 	ut_ad(mutex_own(&kernel_mutex));
 
@@ -29,52 +67,30 @@ read_view_t* read_view_oldest_copy_or_open_new(trx_t* cr_trx, mem_heap_t* heap)
 	if(old_view == NULL) /*trx_sys->view_listǿյ*/
 		return read_view_open_now(cr_trx, heap);
 
-	n = old_view->n_trx_ids;
-	if(old_view->creator != NULL) /*old viewԼ*/
-		n ++;
-	else
-		needs_insert = FALSE;
-	/*һread viewold viewĸ*/
-	view_copy = read_view_create_low(n, heap);
-	i = 0;
-	while(i < n){
-		/*Ҫold viewcreator trx id,Ҫλλ*/
-		if (needs_insert && (i >= old_view->n_trx_ids || ut_dulint_cmp(old_view->creator->id, read_view_get_nth_trx_id(old_view, i)) > 0)){
-			read_view_set_nth_trx_id(view_copy, i, old_view->creator->id);
-			needs_insert = FALSE;
-			insert_done = 1;
-		}
-		else{ /*old_view->trx_idscopy_view->trx_ids*/
-			read_view_set_nth_trx_id(view_copy, i, read_view_get_nth_trx_id(old_view, i - insert_done));
-		}
-		i++;
-	}
-
+	/*old viewĿѾold viewԼid,Ҫٲ*/
+	view_copy = mem_heap_alloc(heap, sizeof(read_view_t));
 	view_copy->creator = cr_trx;
 	view_copy->low_limit_no = old_view->low_limit_no;
 	view_copy->low_limit_id = old_view->low_limit_id;
 	view_copy->can_be_too_old = FALSE;
 
-	if(n > 0) /*trx id*/
-		view_copy->up_limit_id = read_view_get_nth_trx_id(view_copy, n - 1);
-	else
-		view_copy->up_limit_id = old_view->up_limit_id;
+	old_view->snap->ref_count ++;
+	read_view_attach_snap(view_copy, old_view->snap);
 
 	UT_LIST_ADD_LAST(view_list, trx_sys->view_list, view_copy);
 
 	return view_copy;
 }
 
-/*sys_trxļе״̬Ϣһread view*/
+/*sys_trxļе״̬Ϣһread view,trx_list*/
 read_view_t* read_view_open_now(trx_t* cr_trx, mem_heap_t* heap)
 {
 	read_view_t*	view;
-	trx_t*		trx;
-	ulint		n;
+	trx_t*			trx;
 
 	ut_ad(mutex_own(&kernel_mutex));
 
-	view = read_view_create_low(UT_LIST_GET_LEN(trx_sys->trx_list), heap);
+	view = mem_heap_alloc(heap, sizeof(read_view_t));
 	view->creator = cr_trx;
 
 	/*ϵͳtrx_idΪlow id*/
@@ -83,25 +99,12 @@ read_view_t* read_view_open_now(trx_t* cr_trx, mem_heap_t* heap)
 
 	view->can_be_too_old = FALSE;
 
-	n = 0;
-	trx = UT_LIST_GET_FIRST(trx_sys->trx_list);
-	while(trx){
-		if(trx != cr_trx && trx->conc_state == TRX_ACTIVE){ /*ȡactive״̬,idȫview->trx_ids*/
-			read_view_set_nth_trx_id(view, n, trx->id);
-			n ++;
-
-			if(ut_dulint_cmp(view->low_limit_no, trx->no) > 0) /*trx->noСlow_limit_nonoΪlow_limit_no,ӦǼСtrx_id*/
-				view->low_limit_no = trx->no;
-		}
+	/*no_listѾtrx->noactive״̬,һnoС*/
+	trx = UT_LIST_GET_FIRST(trx_sys->no_list);
+	if(trx != NULL && ut_dulint_cmp(view->low_limit_no, trx->no) > 0)
+		view->low_limit_no = trx->no;
 
-		trx = UT_LIST_GET_NEXT(trx_list, trx);
-	}
-
-	view->n_trx_ids = n;
-	if(n > 0)
-		view->up_limit_id = read_view_get_nth_trx_id(view, n - 1);
-	else
-		view->up_limit_id = view->low_limit_id;
+	read_view_attach_snap(view, read_view_snap_get());
 
 	UT_LIST_ADD_FIRST(view_list, trx_sys->view_list, view);
 	return view;
@@ -112,9 +115,12 @@ void read_view_close(read_view_t* view)
 {
 	ut_ad(mutex_own(&kernel_mutex));
 	UT_LIST_REMOVE(view_list, trx_sys->view_list, view);
+
+	read_view_snap_release(view->snap);
+	view->snap = NULL;
 }
 
-voidread_view_print(read_view_t* view)
+void read_view_print(read_view_t* view)
 {
 	ulint	n_ids;
 	ulint	i;
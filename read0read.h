@@ -2,24 +2,33 @@
 #define __read0read_h_
 
 #include "univ.h"
-#include "ut0bype.h"
+#include "ut0byte.h"
 #include "ut0lst.h"
 #include "trx0trx.h"
+#include "read0types.h"
+
+/*Ծidֻ,idССtrx_sys->active_idsûб仯ʱ,µread viewֱӹһ*/
+struct read_view_snap_struct
+{
+	ulint			ref_count;						/*յread view,trx_sys->view_snapҲһ*/
+	ulint			n_ids;
+	dulint*			ids;
+};
 
-typedef struct read_view_struct read_view_t;
 /*Ŀɼṹ*/
-typedef struct read_view_struct
+struct read_view_struct
 {
 	ibool			can_be_too_old;					/*TRUEʾpurge old version, read viewܼݣֿܻDB_MISSING_HISTORY*/
 	dulint			low_limit_no;					
 	dulint			low_limit_id;					/*trx_idsֵ*/
 	dulint			up_limit_id;					/*trx idsֵ*/
 	ulint			n_trx_ids;
-	dulint*			trx_ids;						
+	dulint*			trx_ids;						/*ʱactive״̬id,С,ָsnap->ids,ܰcreatorԼid*/
+	read_view_snap_t* snap;
 	trx_t*			creator;						/**/
 
 	UT_LIST_NODE_T(read_view_t) view_list;			/*Ϊʽtrx_sys->view_listжǰϵ*/
-}read_view_t;
+};
 
 
 read_view_t*				read_view_open_now(trx_t* cr_trx, mem_heap_t* heap);
@@ -28,9 +37,11 @@ read_view_t*				read_view_oldest_copy_or_open_new(trx_t* cr_trx, mem_heap_t* hea
 
 void						read_view_close(read_view_t* view);
 
+void						read_view_snap_release(read_view_snap_t* snap);
+
 UNIV_INLINE	ibool			read_view_sees_trx_id(read_view_t* view, dulint trx_id);
 
-void						read_view_printf(read_view_t* view);
+void						read_view_print(read_view_t* view);
 
 #include "read0read.inl"
 
@@ -17,9 +17,11 @@ UNIV_INLINE void read_view_set_nth_trx_id(read_view_t* view, ulint n, dulint trx
 /*жviewǷtrx_idӦɼӦúйϵ ΪviewеIDviewһµ*/
 UNIV_INLINE ibool read_view_sees_trx_id(read_view_t* view, dulint trx_id)
 {
-	ulint n_ids;
-	int cmp;
-	ulint i;
+	dulint*	ids;
+	ulint	low;
+	ulint	high;
+	ulint	mid;
+	int		cmp;
 
 	if(ut_dulint_cmp(trx_id, view->up_limit_id) < 0)
 		return TRUE;
@@ -27,13 +29,24 @@ UNIV_INLINE ibool read_view_sees_trx_id(read_view_t* view, dulint trx_id)
 	if(ut_dulint_cmp(trx_id, view->low_limit_id) >= 0)
 		return FALSE;
 
-	n_ids = view->n_trx_ids;
-	for(i = 0; i < n_ids; i++){
-		cmp = ut_dulint_cmp(trx_id, read_view_get_nth_trx_id(view, n_ids - i - 1));
+	/*аcreatorԼid,Լ޸ǿɼ*/
+	if(view->creator != NULL && ut_dulint_cmp(trx_id, view->creator->id) == 0)
+		return TRUE;
+
+	/*trx_idsǴСе,ֲtrx_idڴviewʱǷactive״̬*/
+	ids = view->trx_ids;
+	low = 0;
+	high = view->n_trx_ids;
+	while(low < high){
+		mid = (low + high) >> 1;
+
+		cmp = ut_dulint_cmp(trx_id, ids[mid]);
 		if(cmp == 0)
 			return FALSE;
 		else if(cmp < 0)
-			return TRUE;
+			high = mid;
+		else
+			low = mid + 1;
 	}
 
 	return TRUE;
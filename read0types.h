@@ -0,0 +1,7 @@
+#ifndef __read0types_h_
+#define __read0types_h_
+
+typedef struct read_view_struct			read_view_t;
+typedef struct read_view_snap_struct	read_view_snap_t;
+
+#endif
@@ -1,7 +1,7 @@
 #include "rem0cmp.h"
 #include "srv0srv.h"
 
-static int			cmp_debug_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint matched_fields);
+static int			cmp_debug_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, const ulint* offsets, ulint* matched_fields);
 
 int					innobase_mysql_cmp(int mysql_type, unsigned char* a, unsigned int a_length, unsigned char* b, unsigned int b_length);
 
@@ -179,7 +179,61 @@ next_byte:
 	return 0;
 }
 
-int cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_fields, ulint* matched_bytes)
+/*жdtupleıȽܷתnormalized key,ʱƴӵnkeyС
+ֻܶΪNULLҪcollationpad,Щڼ¼еֽǵĴС˳*/
+ibool cmp_norm_key_init(cmp_norm_key_t* nkey, dtuple_t* dtuple)
+{
+	dfield_t*	field;
+	dtype_t*	type;
+	ulint		n_fields;
+	ulint		len;
+	ulint		i;
+
+	n_fields = dtuple_get_n_fields_cmp(dtuple);
+	if(n_fields == 0 || n_fields > CMP_NORM_KEY_MAX_FIELDS)
+		return FALSE;
+
+	/*С¼־ҪͨõķʽȽ*/
+	if(dtuple_get_info_bits(dtuple) & REC_INFO_MIN_REC_FLAG)
+		return FALSE;
+
+	nkey->len = 0;
+	for(i = 0; i < n_fields; i ++){
+		field = dtuple_get_nth_field(dtuple, i);
+		type = dfield_get_type(field);
+
+		switch(type->mtype){
+		case DATA_SYS:
+			break;
+		case DATA_INT:
+		case DATA_FIXBINARY:
+			/*¼епNULL*/
+			if(!(type->prtype & DATA_NOT_NULL))
+				return FALSE;
+			break;
+		default:
+			return FALSE;
+		}
+
+		len = dfield_get_len(field);
+		if(len == UNIV_SQL_NULL || len == 0 || len != dtype_get_fixed_size(type))
+			return FALSE;
+
+		if(nkey->len + len > CMP_NORM_KEY_MAX_LEN)
+			return FALSE;
+
+		ut_memcpy(nkey->key + nkey->len, dfield_get_data(field), len);
+		nkey->len += len;
+		nkey->field_end[i] = nkey->len;
+	}
+
+	nkey->n_fields = n_fields;
+
+	return TRUE;
+}
+
+/*ȽdtuplerecĴС,offsetsrec_get_offsetsrecƫ,Ҫdtuplen_fields_cmp*/
+int cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, const ulint* offsets, ulint* matched_fields, ulint* matched_bytes)
 {
 	dtype_t*	cur_type;
 
@@ -205,8 +259,9 @@ int cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_field
 	cur_field = *matched_fields;
 	cur_bytes = *matched_bytes;
 
+	ut_ad(rec_offs_validate(rec, offsets));
 	ut_ad(cur_field <= dtuple_get_n_fields_cmp(dtuple));
-	ut_ad(cur_field <= rec_get_n_fields(rec));
+	ut_ad(dtuple_get_n_fields_cmp(dtuple) <= rec_offs_n_fields(offsets));
 
 	while(cur_field < dtuple_get_n_fields_cmp(dtuple)){
 		/*öӦtupleӦ*/
@@ -215,7 +270,7 @@ int cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_field
 
 		/*rec_tӦ*/
 		dtuple_f_len = dfield_get_len(dtuple_field);
-		rec_b_ptr = rec_get_nth_field(rec, cur_field, &rec_f_len);
+		rec_b_ptr = rec_offs_get_nth_field(rec, offsets, cur_field, &rec_f_len);
 
 		if(cur_bytes == 0){
 			if(cur_field == 0){
@@ -235,7 +290,7 @@ int cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_field
 				}
 			}
 
-			if(rec_get_nth_field_extern_bit(rec, cur_field)){
+			if(rec_offs_nth_extern(offsets, cur_field)){
 				ret = 0;
 				goto order_resolved;
 			}
@@ -316,14 +371,14 @@ next_byte:
 next_field:
 		cur_field ++;
 		cur_bytes = 0;
-
-		ut_ad(cur_bytes == 0);
-		ret = 0;
 	}
 
+	ut_ad(cur_bytes == 0);
+	ret = 0;
+
 order_resolved:
 	ut_ad((ret >= - 1) && (ret <= 1));
-	ut_ad(ret == cmp_debug_dtuple_rec_with_match(dtuple, rec,
+	ut_ad(ret == cmp_debug_dtuple_rec_with_match(dtuple, rec, offsets,
 		matched_fields));
 	ut_ad(*matched_fields == cur_field); 
 
@@ -336,51 +391,83 @@ order_resolved:
 /*Ƚdtuple¼rec֮ĴС*/
 int cmp_dtuple_rec(dtuple_t* dtuple, rec_t* rec)
 {
-	ulint matched_fields = 0;
-	ulint matched_bytes = 0;
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
+	ulint		matched_fields = 0;
+	ulint		matched_bytes = 0;
+	int			ret;
+
+	rec_offs_init(offsets_);
+	offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(dtuple), offsets_, &heap);
+
+	ret = cmp_dtuple_rec_with_match(dtuple, rec, offsets, &matched_fields, &matched_bytes);
 
-	return cmp_dtuple_rec_with_match(dtuple, rec, &matched_fields, &matched_bytes);
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return ret;
 }
 
 ibool cmp_dtuple_is_prefix_of_rec(dtuple_t* dtuple, rec_t* rec)
 {
-	ulint n_fields;
-	ulint matched_fields = 0;
-	ulint matched_bytes = 0;
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
+	ulint		n_fields;
+	ulint		matched_fields = 0;
+	ulint		matched_bytes = 0;
+	ibool		ret = FALSE;
 
 	n_fields = dtuple_get_n_fields(dtuple);
 	if(n_fields > rec_get_n_fields(rec))
 		return FALSE;
 
-	cmp_dtuple_rec_with_match(dtuple, rec, &matched_fields, &matched_bytes);
-	if(matched_fields == n_fields) /*Ƚϵһfield,Ƚϵ*/
-		return TRUE;
+	rec_offs_init(offsets_);
+	offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(dtuple), offsets_, &heap);
 
+	cmp_dtuple_rec_with_match(dtuple, rec, offsets, &matched_fields, &matched_bytes);
+	if(matched_fields == n_fields) /*Ƚϵһfield,Ƚϵ*/
+		ret = TRUE;
 	/*Ƚϵ˵2field,ҵfieldһֽ*/
-	if(matched_fields == n_fields - 1 && matched_bytes == dfield_get_len(dtuple_get_nth_field(dtuple, n_fields - 1)))
-		return TRUE;
+	else if(matched_fields == n_fields - 1 && matched_bytes == dfield_get_len(dtuple_get_nth_field(dtuple, n_fields - 1)))
+		ret = TRUE;
 
-	return FALSE;
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return ret;
 }
 
 /*жϵnfields֮ǰǷ*/
 ibool cmp_dtuple_rec_prefix_equal(dtuple_t* dtuple, rec_t* rec, ulint n_fields)
 {
-	ulint matched_fields = 0;
-	ulint matched_bytes = 0;
+	mem_heap_t*	heap = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
+	ulint		matched_fields = 0;
+	ulint		matched_bytes = 0;
 
 	ut_ad(n_fields <= dtuple_get_n_fields(dtuple));
 	if(rec_get_n_fields(rec) < n_fields)
 		return FALSE;
 
-	cmp_dtuple_rec_with_match(dtuple, rec, &matched_fields, &matched_bytes);
+	rec_offs_init(offsets_);
+	offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(dtuple), offsets_, &heap);
+
+	cmp_dtuple_rec_with_match(dtuple, rec, offsets, &matched_fields, &matched_bytes);
+
+	if(heap != NULL)
+		mem_heap_free(heap);
+
 	if(matched_fields >= n_fields)
 		return TRUE;
 
 	return FALSE;
 }
 
-int cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, dict_index_t* index, ulint* matched_fields, ulint* matched_bytes)
+/*Ƚͬһļ¼,offsets1offsets2¼ƫ,ֻȽ߶˵*/
+int cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, const ulint* offsets1, const ulint* offsets2, dict_index_t* index, ulint* matched_fields, ulint* matched_bytes)
 {
 	dtype_t*	cur_type;
 
@@ -400,9 +487,11 @@ int cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, dict_index_t* index, ulint*
 	int ret = 3333;
 
 	ut_ad(rec1 && rec2 && index);
+	ut_ad(rec_offs_validate(rec1, offsets1));
+	ut_ad(rec_offs_validate(rec2, offsets2));
 
-	rec1_n_fields = rec_get_n_fields(rec1);
-	rec2_n_fields = rec_get_n_fields(rec2);
+	rec1_n_fields = rec_offs_n_fields(offsets1);
+	rec2_n_fields = rec_offs_n_fields(offsets2);
 
 	cur_field = *matched_fields;
 	cur_bytes = *matched_bytes;
@@ -413,8 +502,8 @@ int cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, dict_index_t* index, ulint*
 		else 
 			cur_type = dict_col_get_type(dict_field_get_col(dict_index_get_nth_field(index, cur_field)));
 
-		rec1_b_ptr = rec_get_nth_field(rec1, cur_field, &rec1_f_len);
-		rec2_b_ptr = rec_get_nth_field(rec2, cur_field, &rec2_f_len);
+		rec1_b_ptr = rec_offs_get_nth_field(rec1, offsets1, cur_field, &rec1_f_len);
+		rec2_b_ptr = rec_offs_get_nth_field(rec2, offsets2, cur_field, &rec2_f_len);
 
 		if(cur_bytes == 0){
 			if(cur_field == 0){
@@ -434,7 +523,7 @@ int cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, dict_index_t* index, ulint*
 				}
 			}
 
-			if (rec_get_nth_field_extern_bit(rec1, cur_field) || rec_get_nth_field_extern_bit(rec2, cur_field)) {
+			if (rec_offs_nth_extern(offsets1, cur_field) || rec_offs_nth_extern(offsets2, cur_field)) {
 				ret = 0;
 				goto order_resolved;
 			}
@@ -536,7 +625,7 @@ order_resolved:
 	return(ret);
 }
 
-static int cmp_debug_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_fields)
+static int cmp_debug_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, const ulint* offsets, ulint* matched_fields)
 {
 	dtype_t*		cur_type;
 	dfield_t*		dtuple_field;
@@ -552,7 +641,7 @@ static int cmp_debug_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint*
 	ut_ad(dtuple_check_typed(dtuple));
 
 	ut_ad(*matched_fields <= dtuple_get_n_fields_cmp(dtuple));
-	ut_ad(*matched_fields <= rec_get_n_fields(rec));
+	ut_ad(dtuple_get_n_fields_cmp(dtuple) <= rec_offs_n_fields(offsets));
 
 	cur_field = *matched_fields;
 	if(cur_field == 0){
@@ -579,9 +668,9 @@ static int cmp_debug_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint*
 		dtuple_f_data = dfield_get_data(dtuple_field);
 		dtuple_f_len = dfield_get_len(dtuple_field);
 
-		rec_f_data = rec_get_nth_field(rec, cur_field, &rec_f_len);
+		rec_f_data = rec_offs_get_nth_field(rec, offsets, cur_field, &rec_f_len);
 
-		if (rec_get_nth_field_extern_bit(rec, cur_field)) {
+		if (rec_offs_nth_extern(offsets, cur_field)) {
 			ret = 0;
 			goto order_resolved;
 		}
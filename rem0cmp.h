@@ -7,13 +7,32 @@
 #include "dict0dict.h"
 #include "rem0rec.h"
 
+/*normalized keyֽ*/
+#define CMP_NORM_KEY_MAX_LEN		64
+#define CMP_NORM_KEY_MAX_FIELDS		16
+
+/*dtupleıȽȫǶΪNULLֽڱȽϵ(ϵͳС)ʱ,
+Щƴӳһmemcmpkey¼Щдrecʼ,
+ͼ¼ȽʱֻҪȽkeyrecͷֽ,ý¼ͷаͱȽ*/
+typedef struct cmp_norm_key_struct
+{
+	byte		key[CMP_NORM_KEY_MAX_LEN];
+	ulint		len;
+	ulint		n_fields;
+	ulint		field_end[CMP_NORM_KEY_MAX_FIELDS];	/*ÿһkeyеĽλ*/
+}cmp_norm_key_t;
+
 ibool				cmp_types_are_equal(dtype_t* type1, dtype_t* type2);
 
+ibool				cmp_norm_key_init(cmp_norm_key_t* nkey, dtuple_t* dtuple);
+
+UNIV_INLINE int		cmp_norm_key_rec_with_match(cmp_norm_key_t* nkey, rec_t* rec, ulint* matched_fields, ulint* matched_bytes);
+
 UNIV_INLINE	int		cmp_data_data(dtype_t* cur_type, byte* data1, ulint len1, byte* data2, ulint len2);
 
 UNIV_INLINE int		cmp_dfield_dfield(dfield_t* dfield1, dfield_t* dfield2);
 
-int					cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, ulint* matched_fields, ulint* matched_bytes);
+int					cmp_dtuple_rec_with_match(dtuple_t* dtuple, rec_t* rec, const ulint* offsets, ulint* matched_fields, ulint* matched_bytes);
 
 int					cmp_dtuple_rec(dtuple_t* dtuple, rec_t* rec);
 
@@ -21,7 +40,7 @@ ibool				cmp_dtuple_is_prefix_of_rec(dtuple_t* dtuple, rec_t* rec);
 
 ibool				cmp_dtuple_rec_prefix_equal(dtuple_t* dtuple, rec_t* rec, ulint n_fields);
 
-int					cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, dict_index_t* index, ulint* matched_fields, ulint* matched_bytes);
+int					cmp_rec_rec_with_match(rec_t* rec1, rec_t* rec2, const ulint* offsets1, const ulint* offsets2, dict_index_t* index, ulint* matched_fields, ulint* matched_bytes);
 
 UNIV_INLINE int		cmp_rec_rec(rec_t* rec1, rec_t* rec2, dict_index_t* index);
 
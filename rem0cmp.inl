@@ -15,13 +15,80 @@ UNIV_INLINE int cmp_dfield_dfield(dfield_t* dfield1, dfield_t* dfield2)
 
 UNIV_INLINE int cmp_rec_rec(rec_t* rec1, rec_t* rec2, dict_index_t* index)
 {
-	ulint	match_f	= 0;
-	ulint	match_b	= 0;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets1_[REC_OFFS_NORMAL_SIZE];
+	ulint		offsets2_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets1;
+	ulint*		offsets2;
+	ulint		match_f		= 0;
+	ulint		match_b		= 0;
+	int			ret;
 
-	return cmp_rec_rec_with_match(rec1, rec2, index, &match_f, &match_b);
+	rec_offs_init(offsets1_);
+	rec_offs_init(offsets2_);
+
+	offsets1 = rec_get_offsets(rec1, ULINT_UNDEFINED, offsets1_, &heap);
+	offsets2 = rec_get_offsets(rec2, ULINT_UNDEFINED, offsets2_, &heap);
+
+	ret = cmp_rec_rec_with_match(rec1, rec2, offsets1, offsets2, index, &match_f, &match_b);
+
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return ret;
+}
+
+/*nkeyrecposʼһֽͬڵλ,ͬʱnkey->len
+ÿαȽ8ֽ,԰չɿĴSIMDıȽ*/
+UNIV_INLINE ulint cmp_norm_key_mismatch(cmp_norm_key_t* nkey, rec_t* rec, ulint pos)
+{
+	ib_uint64_t	w1;
+	ib_uint64_t	w2;
+
+	while(pos + 8 <= nkey->len){
+		memcpy(&w1, nkey->key + pos, 8);
+		memcpy(&w2, rec + pos, 8);
+		if(w1 != w2)
+			break;
+
+		pos += 8;
+	}
+
+	while(pos < nkey->len && nkey->key[pos] == rec[pos])
+		pos ++;
+
+	return pos;
 }
 
+/*cmp_norm_key_initkeyrecȽ,cmp_dtuple_rec_with_matchͬ
+recǴREC_INFO_MIN_REC_FLAGļ¼,Ҳinfimumsupremum*/
+UNIV_INLINE int cmp_norm_key_rec_with_match(cmp_norm_key_t* nkey, rec_t* rec, ulint* matched_fields, ulint* matched_bytes)
+{
+	ulint	pos;
+	ulint	field;
+
+	ut_ad(*matched_fields <= nkey->n_fields);
+	ut_ad(!(rec_get_info_bits(rec) & REC_INFO_MIN_REC_FLAG));
+
+	field = *matched_fields;
+	if(field == nkey->n_fields)
+		return 0;
 
+	/*ǰѾƥкֽڲٱȽ*/
+	pos = (field == 0) ? 0 : nkey->field_end[field - 1];
+	pos = cmp_norm_key_mismatch(nkey, rec, pos + *matched_bytes);
 
+	if(pos == nkey->len){
+		*matched_fields = nkey->n_fields;
+		*matched_bytes = 0;
+		return 0;
+	}
 
+	while(nkey->field_end[field] <= pos)
+		field ++;
 
+	*matched_fields = field;
+	*matched_bytes = pos - ((field == 0) ? 0 : nkey->field_end[field - 1]);
+
+	return (nkey->key[pos] > rec[pos]) ? 1 : -1;
+}
@@ -10,8 +10,8 @@ byte* rec_get_nth_field(rec_t* rec, ulint n, ulint* len)
 {
 	ulint os, next_os;
 
-	ut_ad(rec & len);
-	ut_ad(n < rec_get_n_fields());
+	ut_ad(rec && len);
+	ut_ad(n < rec_get_n_fields(rec));
 
 	if(n >= 1024){
 		fprintf(stderr, "Error: trying to access field %lu in rec\n", n);
@@ -41,13 +41,64 @@ byte* rec_get_nth_field(rec_t* rec, ulint n, ulint* len)
 			return rec + os;
 		}
 
-		next_os = next_os & ~(REC_1BYTE_SQL_NULL_MASK | REC_2BYTE_EXTERN_MASK);
+		next_os = next_os & ~(REC_2BYTE_SQL_NULL_MASK | REC_2BYTE_EXTERN_MASK);
 	}
 
 	*len = next_os - os;
 	return rec + os;
 }
 
+/*һνrecǰn_fieldsеĽλ(n_fieldsΪULINT_UNDEFINEDʱ)
+offsetsĿռ䲻ʱ*heapз,*heapΪNULLʱ,ɵͷ*/
+ulint* rec_get_offsets(rec_t* rec, ulint n_fields, ulint* offsets, mem_heap_t** heap)
+{
+	ulint	size;
+	ulint	info;
+	ulint	offs;
+	ulint	i;
+
+	ut_ad(rec && heap);
+
+	if(n_fields > rec_get_n_fields(rec))
+		n_fields = rec_get_n_fields(rec);
+
+	size = n_fields + REC_OFFS_HEADER_SIZE;
+	if(offsets == NULL || rec_offs_get_n_alloc(offsets) < size){
+		if(*heap == NULL)
+			*heap = mem_heap_create(size * sizeof(ulint));
+
+		offsets = mem_heap_alloc(*heap, size * sizeof(ulint));
+		rec_offs_set_n_alloc(offsets, size);
+	}
+
+	offsets[1] = n_fields;
+
+	if(rec_get_1byte_offs_flag(rec)){
+		for(i = 0; i < n_fields; i ++){
+			info = rec_1_get_field_end_info(rec, i);
+			offs = info & ~REC_1BYTE_SQL_NULL_MASK;
+			if(info & REC_1BYTE_SQL_NULL_MASK)
+				offs |= REC_OFFS_SQL_NULL;
+
+			offsets[REC_OFFS_HEADER_SIZE + i] = offs;
+		}
+	}
+	else{
+		for(i = 0; i < n_fields; i ++){
+			info = rec_2_get_field_end_info(rec, i);
+			offs = info & ~(REC_2BYTE_SQL_NULL_MASK | REC_2BYTE_EXTERN_MASK);
+			if(info & REC_2BYTE_SQL_NULL_MASK)
+				offs |= REC_OFFS_SQL_NULL;
+			if(info & REC_2BYTE_EXTERN_MASK)
+				offs |= REC_OFFS_EXTERNAL;
+
+			offsets[REC_OFFS_HEADER_SIZE + i] = offs;
+		}
+	}
+
+	return offsets;
+}
+
 /*ǷΪ*/
 void rec_set_nth_field_null_bit(rec_t* rec, ulint i, ibool val)
 {
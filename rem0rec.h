@@ -24,6 +24,21 @@
 
 #define REC_MAX_DATA_SIZE		(16 * 1024)
 
+/*rec_get_offsetsصƫ:offsets[0]ĳ,offsets[1]Ѿ,
+offsets[REC_OFFS_HEADER_SIZE + i]ǵiеĽλrecƫ,λNULLⲿ洢־
+һ¼ƫֻһ,ȽϺȡʱٷ¼ͷ*/
+#define REC_OFFS_HEADER_SIZE	2
+/*ջϷoffsetsĳó*/
+#define REC_OFFS_NORMAL_SIZE	100
+#define REC_OFFS_SMALL_SIZE		10
+
+#define REC_OFFS_SQL_NULL		((ulint) 1 << 31)
+#define REC_OFFS_EXTERNAL		((ulint) 1 << 30)
+#define REC_OFFS_MASK			(REC_OFFS_EXTERNAL - 1)
+
+/*ʼջϵoffsets,offsetsָ*/
+#define rec_offs_init(offsets)	rec_offs_set_n_alloc(offsets, (sizeof(offsets)) / sizeof(*(offsets)))
+
 UNIV_INLINE ulint			rec_get_next_offs(rec_t* rec);
 UNIV_INLINE void			rec_set_next_offs(rec_t* rec, ulint next);
 
@@ -46,6 +61,19 @@ UNIV_INLINE void			rec_set_1byte_offs_flag(rec_t* rec, ibool flag);
 
 byte*						rec_get_nth_field(rec_t* rec, ulint n, ulint* len); 
 
+ulint*						rec_get_offsets(rec_t* rec, ulint n_fields, ulint* offsets, mem_heap_t** heap);
+
+UNIV_INLINE ulint			rec_offs_get_n_alloc(const ulint* offsets);
+UNIV_INLINE void			rec_offs_set_n_alloc(ulint* offsets, ulint n_alloc);
+
+UNIV_INLINE ulint			rec_offs_n_fields(const ulint* offsets);
+
+UNIV_INLINE byte*			rec_offs_get_nth_field(rec_t* rec, const ulint* offsets, ulint n, ulint* len);
+
+UNIV_INLINE ibool			rec_offs_nth_extern(const ulint* offsets, ulint n);
+
+UNIV_INLINE ibool			rec_offs_validate(rec_t* rec, const ulint* offsets);
+
 UNIV_INLINE ulint			rec_get_nth_field_size(rec_t* rec, ulint n);
 
 UNIV_INLINE ibool			rec_get_nth_field_extern_bit(rec_t* rec, ulint i);
@@ -78,7 +106,7 @@ UNIV_INLINE ulint			rec_get_converted_size(dtuple_t* dtuple);
 
 void						rec_copy_prefix_to_dtuple(dtuple_t* tuple, rec_t* rec, ulint n_fields, mem_heap_t* heap);
 
-void						rec_validate(rec_t* rec);
+ibool						rec_validate(rec_t* rec);
 void						rec_print(rec_t* rec);
 ulint						rec_sprintf(char* buf, ulint buf_len, rec_t* rec);
 
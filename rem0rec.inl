@@ -510,6 +510,77 @@ UNIV_INLINE ulint rec_fold(rec_t* rec, ulint n_fields, ulint n_bytes, dulint tre
 	return fold;
 }
 
+UNIV_INLINE ulint rec_offs_get_n_alloc(const ulint* offsets)
+{
+	ut_ad(offsets);
+	return offsets[0];
+}
+
+UNIV_INLINE void rec_offs_set_n_alloc(ulint* offsets, ulint n_alloc)
+{
+	ut_ad(offsets && n_alloc > REC_OFFS_HEADER_SIZE);
+	offsets[0] = n_alloc;
+}
+
+/*offsetsѾ*/
+UNIV_INLINE ulint rec_offs_n_fields(const ulint* offsets)
+{
+	ut_ad(offsets);
+	ut_ad(offsets[1] + REC_OFFS_HEADER_SIZE <= offsets[0]);
+
+	return offsets[1];
+}
+
+/*ͨrec_get_offsetsõƫƻõnеλúͳ,¼ͷ*/
+UNIV_INLINE byte* rec_offs_get_nth_field(rec_t* rec, const ulint* offsets, ulint n, ulint* len)
+{
+	ulint	offs;
+	ulint	end;
+
+	ut_ad(rec && len);
+	ut_ad(n < rec_offs_n_fields(offsets));
+
+	offs = (n == 0) ? 0 : (offsets[REC_OFFS_HEADER_SIZE + n - 1] & REC_OFFS_MASK);
+	end = offsets[REC_OFFS_HEADER_SIZE + n];
+
+	if(end & REC_OFFS_SQL_NULL)
+		*len = UNIV_SQL_NULL;
+	else
+		*len = (end & REC_OFFS_MASK) - offs;
+
+	return rec + offs;
+}
+
+UNIV_INLINE ibool rec_offs_nth_extern(const ulint* offsets, ulint n)
+{
+	ut_ad(n < rec_offs_n_fields(offsets));
+
+	if(offsets[REC_OFFS_HEADER_SIZE + n] & REC_OFFS_EXTERNAL)
+		return TRUE;
+
+	return FALSE;
+}
+
+/*offsetsǷrecƫ,ֻut_adʹ*/
+UNIV_INLINE ibool rec_offs_validate(rec_t* rec, const ulint* offsets)
+{
+	ulint	n;
+	ulint	len;
+	ulint	offs_len;
+	ulint	i;
+
+	n = rec_offs_n_fields(offsets);
+	if(n > rec_get_n_fields(rec))
+		return FALSE;
+
+	for(i = 0; i < n; i ++){
+		if(rec_get_nth_field(rec, i, &len) != rec_offs_get_nth_field(rec, offsets, i, &offs_len) || len != offs_len)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
 /*ڴе߼¼ת¼rec_t*/
 UNIV_INLINE rec_t* rec_convert_dtuple_to_rec(byte* destination, dtuple_t* dtuple)
 {
@@ -179,8 +179,8 @@ static ulint row_ins_clust_index_entry_by_modify(ulint mode, btr_cur_t* cursor,
 	mem_heap_free(heap);
 }
 
-/*¼ʱΨһΨһ*/
-static ibool row_ins_dupl_error_with_rec(rec_t* rec, dtuple_t* entry, dict_index_t* index)
+/*¼ʱΨһΨһ,offsetsrecƫ*/
+static ibool row_ins_dupl_error_with_rec(rec_t* rec, const ulint* offsets, dtuple_t* entry, dict_index_t* index)
 {
 	ulint	matched_fields;
 	ulint	matched_bytes;
@@ -192,7 +192,7 @@ static ibool row_ins_dupl_error_with_rec(rec_t* rec, dtuple_t* entry, dict_index
 	matched_fields = 0;
 	matched_bytes = 0;
 	/*Ƚentryrecͬݵ*/
-	cmp_dtuple_rec_with_match(entry, rec, &matched_fields, &matched_bytes);
+	cmp_dtuple_rec_with_match(entry, rec, offsets, &matched_fields, &matched_bytes);
 	if(matched_fields < n_unique) /*Ѿвһ*/
 		return FALSE;
 
@@ -534,11 +534,18 @@ static ulint row_ins_scan_sec_index_for_duplicate(dict_index_t* index, dtuple_t*
 	ulint		i;
 	int		cmp;
 	ulint		n_fields_cmp;
+	ulint		matched_fields;
+	ulint		matched_bytes;
 	rec_t*		rec;
 	btr_pcur_t	pcur;
 	ulint		err		= DB_SUCCESS;
 	ibool		moved;
 	mtr_t		mtr;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets		= offsets_;
+
+	rec_offs_init(offsets_);
 
 	n_unique = dict_index_get_n_unique(index);
 
@@ -565,9 +572,14 @@ static ulint row_ins_scan_sec_index_for_duplicate(dict_index_t* index, dtuple_t*
 		if (rec == page_get_supremum_rec(buf_frame_align(rec)))
 			goto next_rec;
 
-		cmp = cmp_dtuple_rec(entry, rec);
+		/*ȽϺظ鹲һνƫ*/
+		offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(entry), offsets, &heap);
+
+		matched_fields = 0;
+		matched_bytes = 0;
+		cmp = cmp_dtuple_rec_with_match(entry, rec, offsets, &matched_fields, &matched_bytes);
 		if(cmp == 0){
-			if (row_ins_dupl_error_with_rec(rec, entry, index)){ /*ֵظ*/
+			if (row_ins_dupl_error_with_rec(rec, offsets, entry, index)){ /*ֵظ*/
 				err = DB_DUPLICATE_KEY; 
 				thr_get_trx(thr)->error_info = index;
 				break;
@@ -582,20 +594,28 @@ next_rec:
 	mtr_commit(&mtr);
 	dtuple_set_n_fields_cmp(entry, n_fields_cmp);
 
+	if(heap != NULL)
+		mem_heap_free(heap);
+
 	return err;
 }
 
 /*ۼϵļֵظ*/
 static ulint row_ins_duplicate_error_in_clust(btr_cur_t* cursor, dtuple_t* entry, que_thr_t* thr, mtr_t* mtr)
 {
-	ulint	err;
+	ulint	err		= DB_SUCCESS;
 	rec_t*	rec;
 	page_t*	page;
 	ulint	n_unique;
+	mem_heap_t*	heap	= NULL;
+	ulint	offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*	offsets		= offsets_;
 
 	trx_t*	trx	= thr_get_trx(thr);
 	UT_NOT_USED(mtr);
 
+	rec_offs_init(offsets_);
+
 	ut_a(cursor->index->type & DICT_CLUSTERED);
 	ut_ad(cursor->index->type & DICT_UNIQUE);
 
@@ -608,11 +628,13 @@ static ulint row_ins_duplicate_error_in_clust(btr_cur_t* cursor, dtuple_t* entry
 			/*s-lock,ֹǰ仯*/
 			err = row_ins_set_shared_rec_lock(rec, cursor->index, thr);
 			if(err != DB_SUCCESS)
-				return err;
+				goto func_exit;
 
-			if (row_ins_dupl_error_with_rec(rec, entry, cursor->index)) { /*ֵظ*/
+			offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(entry), offsets, &heap);
+			if (row_ins_dupl_error_with_rec(rec, offsets, entry, cursor->index)) { /*ֵظ*/
 				trx->error_info = cursor->index;
-				return DB_DUPLICATE_KEY;
+				err = DB_DUPLICATE_KEY;
+				goto func_exit;
 			}
 		}
 	}
@@ -624,18 +646,24 @@ static ulint row_ins_duplicate_error_in_clust(btr_cur_t* cursor, dtuple_t* entry
 		if (rec != page_get_supremum_rec(page)){
 			err = row_ins_set_shared_rec_lock(rec, cursor->index, thr);
 			if(err != DB_SUCCESS)
-				return err;
+				goto func_exit;
 
-			if (row_ins_dupl_error_with_rec(rec, entry, cursor->index)) { /*ֵظ*/
+			offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(entry), offsets, &heap);
+			if (row_ins_dupl_error_with_rec(rec, offsets, entry, cursor->index)) { /*ֵظ*/
 				trx->error_info = cursor->index;
-				return(DB_DUPLICATE_KEY);
+				err = DB_DUPLICATE_KEY;
+				goto func_exit;
 			}
 		}
 
 		ut_a(!(cursor->index->type & DICT_CLUSTERED));
 	}
 
-	return DB_SUCCESS;
+func_exit:
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return err;
 }
 
 /*ж޸һ¼ǲһµļ¼*/
@@ -779,6 +807,115 @@ ulint row_ins_index_entry(dict_index_t* index, dtuple_t* entry, ulint* ext_vec,
 	return row_ins_index_entry_low(BTR_MODIFY_TREE, index, entry,ext_vec, n_ext_vec, thr);
 }
 
+/*Ѱۼźentries뵽ۼСͬһҶҳϵentryһB-treeλһmtr,
+ֻҳ²Ҳλ,һentryڵǰҳʱύmtrӸڵ¶λ
+ֵм¼ͬҳռ䲻߼¼̫entryrow_ins_index_entry롣
+شʱ*n_doneǳentry,ߴ(ȴ)ԺԴ*/
+ulint row_ins_clust_index_entries_batch(dict_index_t* index, dtuple_t** entries, ulint n_entries, ulint* n_done, que_thr_t* thr)
+{
+	btr_cur_t	cursor;
+	page_t*		page;
+	rec_t*		last_rec;
+	rec_t*		insert_rec;
+	big_rec_t*	big_rec;
+	dtuple_t*	entry;
+	ulint		n_unique;
+	ulint		up_match;
+	ulint		up_bytes;
+	ulint		low_match;
+	ulint		low_bytes;
+	ibool		positioned	= FALSE;
+	ibool		fast;
+	ulint		err;
+	mtr_t		mtr;
+
+	ut_ad(index->type & DICT_CLUSTERED);
+
+	n_unique = dict_index_get_n_unique(index);
+	cursor.thr = thr;
+
+	/*ԼʱÿһжҪԼ,߿·*/
+	fast = (UT_LIST_GET_FIRST(index->table->foreign_list) == NULL);
+
+	while(*n_done < n_entries){
+		entry = entries[*n_done];
+
+		if(!fast || rec_get_converted_size(entry) >= page_get_free_space_of_empty() / 2)
+			goto slow_path;
+
+		if(positioned){
+			/*entryҳһ¼СұߵҶҳʱ,λһҳ*/
+			page = btr_cur_get_page(&cursor);
+			last_rec = page_rec_get_prev(page_get_supremum_rec(page));
+
+			if(btr_page_get_next(page, &mtr) != FIL_NULL
+				&& (last_rec == page_get_infimum_rec(page) || cmp_dtuple_rec(entry, last_rec) >= 0)){
+				mtr_commit(&mtr);
+				positioned = FALSE;
+			}
+			else{
+				up_match = 0;
+				up_bytes = 0;
+				low_match = 0;
+				low_bytes = 0;
+
+				page_cur_search_with_match(page, entry, PAGE_CUR_LE, &up_match, &up_bytes,
+					&low_match, &low_bytes, btr_cur_get_page_cur(&cursor));
+
+				cursor.up_match = up_match;
+				cursor.up_bytes = up_bytes;
+				cursor.low_match = low_match;
+				cursor.low_bytes = low_bytes;
+				/*ҳ¶λcursor->foldentry,ò밴BTR_CUR_HASHȥӦhash*/
+				cursor.flag = BTR_CUR_BINARY;
+			}
+		}
+
+		if(!positioned){
+			log_free_check();
+
+			mtr_start(&mtr);
+			btr_cur_search_to_nth_level(index, 0, entry, PAGE_CUR_LE, BTR_MODIFY_LEAF, &cursor, 0, &mtr);
+			positioned = TRUE;
+		}
+
+		/*ֵеļ¼ͬ:ظ,ҲҪѱɾǵļ¼Ļ,ͨ·*/
+		if(cursor.up_match >= n_unique || cursor.low_match >= n_unique)
+			goto slow_path;
+
+		err = btr_cur_optimistic_insert(0, &cursor, entry, &insert_rec, &big_rec, thr, &mtr);
+		ut_ad(big_rec == NULL);
+
+		if(err == DB_SUCCESS){
+			(*n_done) ++;
+			continue;
+		}
+
+		mtr_commit(&mtr);
+		positioned = FALSE;
+
+		if(err != DB_FAIL) /*ȴȴɵߴentry*/
+			return err;
+
+slow_path:
+		if(positioned){
+			mtr_commit(&mtr);
+			positioned = FALSE;
+		}
+
+		err = row_ins_index_entry(index, entry, NULL, 0, thr);
+		if(err != DB_SUCCESS)
+			return err;
+
+		(*n_done) ++;
+	}
+
+	if(positioned)
+		mtr_commit(&mtr);
+
+	return DB_SUCCESS;
+}
+
 /*rowеֵentryõentry*/
 UNIV_INLINE void row_ins_index_entry_set_vals(dtuple_t* entry, dtuple_t* row)
 {
@@ -897,6 +1034,10 @@ ulint row_ins(ins_node_t* node, que_thr_t* thr)
 		node->index = dict_table_get_next_index(node->index);
 		node->entry = UT_LIST_GET_NEXT(tuple_list, node->entry);
 	}
+
+	node->state = INS_NODE_ALLOC_ROW_ID;
+
+	return DB_SUCCESS;
 }
 
 /*ִһ¼е*/
@@ -938,7 +1079,7 @@ que_thr_t* row_ins_step(que_thr_t* thr)
 			goto error_handling;
 		/*¼trx_id*/
 		node->trx_id = trx->id;
-same_trx
+same_trx:
 		node->state = INS_NODE_ALLOC_ROW_ID;
 		if (node->ins_type == INS_SEARCHED) {
 			sel_node->state = SEL_NODE_OPEN;
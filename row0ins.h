@@ -58,6 +58,8 @@ ulint						row_ins_index_entry_low(ulint mode, dict_index_t* index, dtuple_t* en
 
 ulint						row_ins_index_entry(dict_index_t* index, dtuple_t* entry, ulint* ext_vec, ulint n_ext_vec, que_thr_t* thr);
 
+ulint						row_ins_clust_index_entries_batch(dict_index_t* index, dtuple_t** entries, ulint n_entries, ulint* n_done, que_thr_t* thr);
+
 ulint						row_ins(ins_node_t* node, que_thr_t* thr);
 
 que_thr_t*					row_ins_step(que_thr_t* thr);
@@ -0,0 +1,887 @@
+#include "row0merge.h"
+
+#include "ut0mem.h"
+#include "ut0bh.h"
+#include "mach0data.h"
+#include "mem0mem.h"
+#include "rem0rec.h"
+#include "rem0cmp.h"
+#include "page0page.h"
+#include "page0cur.h"
+#include "btr0btr.h"
+#include "btr0pcur.h"
+#include "dict0dict.h"
+#include "row0row.h"
+#include "trx0trx.h"
+#include "buf0flu.h"
+#include "os0file.h"
+#include "srv0srv.h"
+
+/*ʱļдĵλ,һ¼Խblock*/
+#define ROW_MERGE_BLOCK_SIZE	(4 * UNIV_PAGE_SIZE)
+/*blockÿ¼ǰͷ:2ֽڵextra size2ֽڵļ¼,Ϊ0ʾblockûм¼*/
+#define ROW_MERGE_REC_HEADER	4
+/*һ˹鲢ͬʱ鲢run,runʱȹ鲢ɽٵrunһ*/
+#define ROW_MERGE_FANIN			64
+/*򻺳м¼Сȹ,ȷ¼ָĴС*/
+#define ROW_MERGE_MIN_REC_SIZE	16
+/*bulk loadB-tree߶*/
+#define ROW_MERGE_MAX_LEVELS	32
+
+/*ʱļеһrun,block*/
+typedef struct row_merge_run_struct
+{
+	ulint			first_block;
+	ulint			n_blocks;
+}row_merge_run_t;
+
+/*ڴе򻺳,¼Ѿתrecʽ*/
+typedef struct row_merge_buf_struct
+{
+	mem_heap_t*		heap;
+	rec_t**			recs;
+	rec_t**			aux;			/*鲢õĸ*/
+	ulint			n_recs;
+	ulint			max_recs;
+	ulint			data_size;
+}row_merge_buf_t;
+
+/*˳дʱļ,ÿдһblock*/
+typedef struct row_merge_writer_struct
+{
+	os_file_t		fd;
+	byte*			block;
+	ulint			used;
+	ulint			block_no;		/*һҪдblock*/
+}row_merge_writer_t;
+
+/*˳һrun*/
+typedef struct row_merge_reader_struct
+{
+	os_file_t		fd;
+	byte*			block;
+	ulint			pos;
+	ulint			next_block;
+	ulint			end_block;
+	rec_t*			rec;			/*ǰ¼,ָblockڲ,NULLʾrunѾ*/
+}row_merge_reader_t;
+
+/*k·鲢ʱbinary heapеԪ*/
+typedef struct row_merge_heap_elem_struct
+{
+	rec_t*			rec;
+	dict_index_t*	index;
+	ulint			reader_no;
+}row_merge_heap_elem_t;
+
+/*ԵϽB-tree״̬,ÿһֻұߵҳ*/
+typedef struct row_merge_bulk_struct
+{
+	trx_t*			trx;
+	dict_index_t*	index;
+	dict_tree_t*	tree;
+	ulint			space;
+	ulint			fill_limit;								/*ҳм¼ݴﵽֽԺʼһҳ*/
+	ulint			n_levels;
+	ulint			first_page_no[ROW_MERGE_MAX_LEVELS];	/*ÿһߵҳ*/
+	ulint			page_no[ROW_MERGE_MAX_LEVELS];			/*ÿһҳ*/
+	ulint			last_rec_offs[ROW_MERGE_MAX_LEVELS];	/*ҳļ¼ҳƫ,0ʾҳǿյ*/
+	byte*			node_ptr_buf[ROW_MERGE_MAX_LEVELS];		/*뵽һnode pointerĻ*/
+	mem_heap_t*		heap;
+	byte*			prev_buf;
+	rec_t*			prev_rec;								/*һҶӲļ¼,ΨһԼ*/
+	ulint*			page_nos;								/*ҳ,ύǰֻҪЩҳˢ*/
+	ulint			n_pages;
+	ulint			pages_size;
+}row_merge_bulk_t;
+
+/*һȫ״̬*/
+typedef struct row_merge_struct
+{
+	dict_index_t*		index;
+	row_merge_buf_t		buf;
+	os_file_t			fd[2];			/*˹鲢ʱʱļΪ*/
+	row_merge_writer_t	writer;
+	row_merge_run_t*	runs;			/*fd[0]еrun*/
+	ulint				n_runs;
+	ulint				runs_size;
+	row_merge_bulk_t	bulk;
+}row_merge_t;
+
+static ulint row_merge_bulk_insert(row_merge_bulk_t* bulk, ulint level, rec_t* rec);
+
+/*binary heapıȽϺ,ѶСļ¼*/
+static int row_merge_heap_cmp(const void* p1, const void* p2)
+{
+	const row_merge_heap_elem_t* e1 = (const row_merge_heap_elem_t*)p1;
+	const row_merge_heap_elem_t* e2 = (const row_merge_heap_elem_t*)p2;
+
+	return cmp_rec_rec(e1->rec, e2->rec, e1->index);
+}
+
+/*˳鲢recs[low, high)*/
+static void row_merge_sort_low(rec_t** recs, rec_t** aux, ulint low, ulint high, dict_index_t* index)
+{
+	ulint	mid;
+	ulint	i;
+	ulint	j;
+	ulint	k;
+
+	if(high - low < 2)
+		return;
+
+	mid = (low + high) / 2;
+	row_merge_sort_low(recs, aux, low, mid, index);
+	row_merge_sort_low(recs, aux, mid, high, index);
+
+	i = low;
+	j = mid;
+	for(k = low; k < high; k ++){
+		if(j >= high || (i < mid && cmp_rec_rec(recs[i], recs[j], index) <= 0))
+			aux[k] = recs[i ++];
+		else
+			aux[k] = recs[j ++];
+	}
+
+	ut_memcpy(recs + low, aux + low, (high - low) * sizeof(rec_t*));
+}
+
+static void row_merge_buf_init(row_merge_buf_t* buf)
+{
+	buf->heap = mem_heap_create(UNIV_PAGE_SIZE);
+	buf->max_recs = ut_max(srv_sort_buf_size / ROW_MERGE_MIN_REC_SIZE, 1);
+	buf->recs = ut_malloc(buf->max_recs * sizeof(rec_t*));
+	buf->aux = ut_malloc(buf->max_recs * sizeof(rec_t*));
+	buf->n_recs = 0;
+	buf->data_size = 0;
+}
+
+static void row_merge_buf_free(row_merge_buf_t* buf)
+{
+	mem_heap_free(buf->heap);
+	ut_free(buf->recs);
+	ut_free(buf->aux);
+}
+
+static void row_merge_buf_empty(row_merge_buf_t* buf)
+{
+	mem_heap_empty(buf->heap);
+	buf->n_recs = 0;
+	buf->data_size = 0;
+}
+
+/*entryתrecʽ򻺳,ʱFALSEյĻܷһ¼*/
+static ibool row_merge_buf_add(row_merge_buf_t* buf, dtuple_t* entry)
+{
+	ulint	size;
+	byte*	ptr;
+
+	size = rec_get_converted_size(entry);
+	if(buf->n_recs > 0 && (buf->n_recs >= buf->max_recs || buf->data_size + size > srv_sort_buf_size))
+		return FALSE;
+
+	ptr = mem_heap_alloc(buf->heap, size);
+	buf->recs[buf->n_recs ++] = rec_convert_dtuple_to_rec(ptr, entry);
+	buf->data_size += size;
+
+	return TRUE;
+}
+
+/*writerĵǰblockдʱļ*/
+static ibool row_merge_write_block(row_merge_writer_t* writer)
+{
+	ib_uint64_t	offs;
+	ibool		ret;
+
+	/*blockʣĿռܷһ¼ͷʱдһΪ0Ľ*/
+	if(writer->used + ROW_MERGE_REC_HEADER <= ROW_MERGE_BLOCK_SIZE)
+		memset(writer->block + writer->used, 0, ROW_MERGE_REC_HEADER);
+
+	offs = (ib_uint64_t)writer->block_no * ROW_MERGE_BLOCK_SIZE;
+	ret = os_file_write((char*)"innodb_merge_tmp", writer->fd, writer->block,
+		(ulint)(offs & 0xFFFFFFFF), (ulint)(offs >> 32), ROW_MERGE_BLOCK_SIZE);
+
+	writer->block_no ++;
+	writer->used = 0;
+
+	return ret;
+}
+
+static ibool row_merge_write_rec(row_merge_writer_t* writer, rec_t* rec)
+{
+	ulint size;
+
+	size = rec_get_size(rec);
+	ut_a(size + 2 * ROW_MERGE_REC_HEADER <= ROW_MERGE_BLOCK_SIZE);
+
+	if(writer->used + ROW_MERGE_REC_HEADER + size > ROW_MERGE_BLOCK_SIZE && !row_merge_write_block(writer))
+		return FALSE;
+
+	mach_write_to_2(writer->block + writer->used, rec_get_extra_size(rec));
+	mach_write_to_2(writer->block + writer->used + 2, size);
+	ut_memcpy(writer->block + writer->used + ROW_MERGE_REC_HEADER, rec_get_start(rec), size);
+
+	writer->used += ROW_MERGE_REC_HEADER + size;
+
+	return TRUE;
+}
+
+/*writerдrun,run->first_blockڿʼдrunʱ*/
+static ibool row_merge_writer_end_run(row_merge_writer_t* writer, row_merge_run_t* run)
+{
+	if(writer->used > 0 && !row_merge_write_block(writer))
+		return FALSE;
+
+	run->n_blocks = writer->block_no - run->first_block;
+
+	return TRUE;
+}
+
+static void row_merge_reader_init(row_merge_reader_t* reader, os_file_t fd, byte* block, row_merge_run_t* run)
+{
+	reader->fd = fd;
+	reader->block = block;
+	reader->pos = ROW_MERGE_BLOCK_SIZE;		/*һζ¼ʱװrunĵһblock*/
+	reader->next_block = run->first_block;
+	reader->end_block = run->first_block + run->n_blocks;
+	reader->rec = NULL;
+}
+
+/*runеһ¼reader->rec*/
+static void row_merge_reader_next(row_merge_reader_t* reader)
+{
+	ib_uint64_t	offs;
+	ulint		size;
+
+	for(;;){
+		if(reader->pos + ROW_MERGE_REC_HEADER <= ROW_MERGE_BLOCK_SIZE){
+			size = mach_read_from_2(reader->block + reader->pos + 2);
+			if(size != 0){
+				reader->rec = reader->block + reader->pos + ROW_MERGE_REC_HEADER + mach_read_from_2(reader->block + reader->pos);
+				reader->pos += ROW_MERGE_REC_HEADER + size;
+				return;
+			}
+		}
+
+		if(reader->next_block >= reader->end_block){
+			reader->rec = NULL;
+			return;
+		}
+
+		offs = (ib_uint64_t)reader->next_block * ROW_MERGE_BLOCK_SIZE;
+		os_file_read(reader->fd, reader->block, (ulint)(offs & 0xFFFFFFFF), (ulint)(offs >> 32), ROW_MERGE_BLOCK_SIZE);
+
+		reader->next_block ++;
+		reader->pos = 0;
+	}
+}
+
+/*runĩβһrun*/
+static void row_merge_push_run(row_merge_run_t** runs, ulint* n_runs, ulint* runs_size, row_merge_run_t* run)
+{
+	row_merge_run_t* new_runs;
+
+	if(*n_runs == *runs_size){
+		*runs_size = (*runs_size == 0) ? 16 : 2 * (*runs_size);
+		new_runs = ut_malloc(*runs_size * sizeof(row_merge_run_t));
+		if(*runs != NULL){
+			ut_memcpy(new_runs, *runs, *n_runs * sizeof(row_merge_run_t));
+			ut_free(*runs);
+		}
+		*runs = new_runs;
+	}
+
+	(*runs)[(*n_runs) ++] = *run;
+}
+
+/*򻺳źΪһrunдfd[0]*/
+static ulint row_merge_buf_write_run(row_merge_t* merge)
+{
+	row_merge_buf_t*	buf = &(merge->buf);
+	row_merge_run_t		run;
+	ulint				i;
+
+	if(merge->fd[0] < 0){
+		merge->fd[0] = os_file_create_tmpfile();
+		if(merge->fd[0] < 0)
+			return DB_ERROR;
+
+		merge->writer.fd = merge->fd[0];
+		merge->writer.block_no = 0;
+		merge->writer.used = 0;
+	}
+
+	row_merge_sort_low(buf->recs, buf->aux, 0, buf->n_recs, merge->index);
+
+	run.first_block = merge->writer.block_no;
+	for(i = 0; i < buf->n_recs; i ++){
+		if(!row_merge_write_rec(&(merge->writer), buf->recs[i]))
+			return DB_OUT_OF_FILE_SPACE;
+	}
+
+	if(!row_merge_writer_end_run(&(merge->writer), &run))
+		return DB_OUT_OF_FILE_SPACE;
+
+	row_merge_push_run(&(merge->runs), &(merge->n_runs), &(merge->runs_size), &run);
+	row_merge_buf_empty(buf);
+
+	return DB_SUCCESS;
+}
+
+/*˳ɨۼ,Ϊÿûбɾļ¼¼򻺳,ʱдһrun*/
+static ulint row_merge_read_clustered_index(row_merge_t* merge, dict_table_t* table)
+{
+	dict_index_t*	clust_index;
+	btr_pcur_t		pcur;
+	mtr_t			mtr;
+	mem_heap_t*		row_heap;
+	rec_t*			rec;
+	dtuple_t*		row;
+	dtuple_t*		entry;
+	ulint			err = DB_SUCCESS;
+
+	clust_index = dict_table_get_first_index(table);
+	row_heap = mem_heap_create(UNIV_PAGE_SIZE);
+
+	mtr_start(&mtr);
+	btr_pcur_open_at_index_side(TRUE, clust_index, BTR_SEARCH_LEAF, &pcur, TRUE, &mtr);
+
+	while(btr_pcur_move_to_next(&pcur, &mtr)){
+		rec = btr_pcur_get_rec(&pcur);
+		if(!page_rec_is_user_rec(rec) || rec_get_deleted_flag(rec))
+			continue;
+
+		row = row_build(ROW_COPY_POINTERS, rec, clust_index, row_heap);
+		entry = row_build_index_entry(row, merge->index, row_heap);
+
+		if(!row_merge_buf_add(&(merge->buf), entry)){
+			/*:дrun֮ǰͷҳlatch,дصԭļ¼*/
+			btr_pcur_store_position(&pcur, &mtr);
+			mtr_commit(&mtr);
+
+			err = row_merge_buf_write_run(merge);
+
+			mtr_start(&mtr);
+			btr_pcur_restore_position(BTR_SEARCH_LEAF, &pcur, &mtr);
+			if(err != DB_SUCCESS)
+				break;
+
+			/*ͷlatchڼҳܱ,entryеָѾʧЧ,¹*/
+			mem_heap_empty(row_heap);
+			rec = btr_pcur_get_rec(&pcur);
+			row = row_build(ROW_COPY_POINTERS, rec, clust_index, row_heap);
+			entry = row_build_index_entry(row, merge->index, row_heap);
+
+			ut_a(row_merge_buf_add(&(merge->buf), entry));
+		}
+
+		mem_heap_empty(row_heap);
+	}
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	mem_heap_free(row_heap);
+
+	return err;
+}
+
+static void row_merge_bulk_init(row_merge_bulk_t* bulk, trx_t* trx, dict_index_t* index)
+{
+	ulint fill_factor;
+
+	fill_factor = ut_max(ut_min(srv_fill_factor, 100), 10);
+
+	bulk->trx = trx;
+	bulk->index = index;
+	bulk->tree = dict_index_get_tree(index);
+	bulk->space = dict_tree_get_space(bulk->tree);
+	bulk->fill_limit = page_get_free_space_of_empty() / 100 * fill_factor;
+	bulk->n_levels = 0;
+	bulk->heap = mem_heap_create(UNIV_PAGE_SIZE);
+	bulk->prev_buf = ut_malloc(UNIV_PAGE_SIZE);
+	bulk->prev_rec = NULL;
+	bulk->page_nos = NULL;
+	bulk->n_pages = 0;
+	bulk->pages_size = 0;
+}
+
+static void row_merge_bulk_free(row_merge_bulk_t* bulk)
+{
+	ulint i;
+
+	for(i = 0; i < bulk->n_levels; i ++)
+		ut_free(bulk->node_ptr_buf[i]);
+
+	mem_heap_free(bulk->heap);
+	ut_free(bulk->prev_buf);
+
+	if(bulk->page_nos != NULL)
+		ut_free(bulk->page_nos);
+}
+
+/*¼һ·ҳ*/
+static void row_merge_bulk_push_page(row_merge_bulk_t* bulk, ulint page_no)
+{
+	ulint* new_page_nos;
+
+	if(bulk->n_pages == bulk->pages_size){
+		bulk->pages_size = (bulk->pages_size == 0) ? 64 : 2 * bulk->pages_size;
+		new_page_nos = ut_malloc(bulk->pages_size * sizeof(ulint));
+		if(bulk->page_nos != NULL){
+			ut_memcpy(new_page_nos, bulk->page_nos, bulk->n_pages * sizeof(ulint));
+			ut_free(bulk->page_nos);
+		}
+		bulk->page_nos = new_page_nos;
+	}
+
+	bulk->page_nos[bulk->n_pages ++] = page_no;
+}
+
+/*Ϊlevelһҳ,prev_page_noĺ档ҳķдredo,ҳеļ¼д*/
+static ulint row_merge_bulk_alloc_page(row_merge_bulk_t* bulk, ulint level, ulint prev_page_no)
+{
+	page_t*	page;
+	page_t*	prev_page;
+	ulint	page_no;
+	mtr_t	mtr;
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_tree_get_lock(bulk->tree), &mtr);
+
+	page = btr_page_alloc(bulk->tree, (prev_page_no == FIL_NULL) ? 0 : prev_page_no + 1, FSP_UP, level, &mtr);
+	if(page == NULL){
+		mtr_commit(&mtr);
+		return FIL_NULL;
+	}
+
+	buf_page_dbg_add_level(page, SYNC_TREE_NODE_NEW);
+
+	page_create(page, &mtr);
+	btr_page_set_index_id(page, bulk->tree->id, &mtr);
+	btr_page_set_level(page, level, &mtr);
+	btr_page_set_next(page, FIL_NULL, &mtr);
+	btr_page_set_prev(page, prev_page_no, &mtr);
+
+	page_no = buf_frame_get_page_no(page);
+
+	if(prev_page_no != FIL_NULL){
+		prev_page = btr_page_get(bulk->space, prev_page_no, RW_X_LATCH, &mtr);
+		btr_page_set_next(prev_page, page_no, &mtr);
+	}
+
+	mtr_commit(&mtr);
+
+	row_merge_bulk_push_page(bulk, page_no);
+
+	return page_no;
+}
+
+/*ָlevelpage_noҳnode pointer뵽level + 1,recpage_noҳĵһ¼,ΪNULLʱҳ϶ȡ*/
+static ulint row_merge_bulk_insert_node_ptr(row_merge_bulk_t* bulk, ulint level, ulint page_no, rec_t* rec)
+{
+	dtuple_t*	node_ptr;
+	page_t*		page;
+	mtr_t		mtr;
+
+	mtr_start(&mtr);
+	if(rec == NULL){
+		page = btr_page_get(bulk->space, page_no, RW_S_LATCH, &mtr);
+		rec = page_rec_get_next(page_get_infimum_rec(page));
+	}
+
+	node_ptr = dict_tree_build_node_ptr(bulk->tree, rec, page_no, bulk->heap, level);
+	rec = rec_convert_dtuple_to_rec(bulk->node_ptr_buf[level], node_ptr);
+	mtr_commit(&mtr);
+
+	mem_heap_empty(bulk->heap);
+
+	return row_merge_bulk_insert(bulk, level + 1, rec);
+}
+
+/*rec׷ӵlevelҳĩβҳݴﵽfill_limitʱʼһҳ,
+ҳnode pointerһ,һ㲻ʱΪĵһҳnode pointer*/
+static ulint row_merge_bulk_insert(row_merge_bulk_t* bulk, ulint level, rec_t* rec)
+{
+	page_t*		page;
+	page_cur_t	cur;
+	rec_t*		ins_rec;
+	ulint		page_no;
+	ulint		size;
+	ulint		err;
+	mtr_t		mtr;
+
+	ut_a(level < ROW_MERGE_MAX_LEVELS);
+
+	if(level == bulk->n_levels){ /*һ㻹ûҳ*/
+		page_no = row_merge_bulk_alloc_page(bulk, level, FIL_NULL);
+		if(page_no == FIL_NULL)
+			return DB_OUT_OF_FILE_SPACE;
+
+		bulk->first_page_no[level] = page_no;
+		bulk->page_no[level] = page_no;
+		bulk->last_rec_offs[level] = 0;
+		bulk->node_ptr_buf[level] = ut_malloc(UNIV_PAGE_SIZE);
+		bulk->n_levels ++;
+	}
+
+	size = rec_get_size(rec);
+
+	mtr_start(&mtr);
+	/*ҳеļ¼дredo,ɺύ֮ǰЩҳˢ*/
+	mtr_set_log_mode(&mtr, MTR_LOG_NONE);
+
+	page = btr_page_get(bulk->space, bulk->page_no[level], RW_X_LATCH, &mtr);
+	buf_page_dbg_add_level(page, SYNC_TREE_NODE_NEW);
+
+	if(bulk->last_rec_offs[level] != 0
+		&& (page_get_data_size(page) + size > bulk->fill_limit || size > page_get_max_insert_size(page, 1))){
+		mtr_commit(&mtr);
+
+		page_no = row_merge_bulk_alloc_page(bulk, level, bulk->page_no[level]);
+		if(page_no == FIL_NULL)
+			return DB_OUT_OF_FILE_SPACE;
+
+		if(level + 1 == bulk->n_levels){
+			err = row_merge_bulk_insert_node_ptr(bulk, level, bulk->first_page_no[level], NULL);
+			if(err != DB_SUCCESS)
+				return err;
+		}
+
+		bulk->page_no[level] = page_no;
+		bulk->last_rec_offs[level] = 0;
+
+		err = row_merge_bulk_insert_node_ptr(bulk, level, page_no, rec);
+		if(err != DB_SUCCESS)
+			return err;
+
+		mtr_start(&mtr);
+		mtr_set_log_mode(&mtr, MTR_LOG_NONE);
+
+		page = btr_page_get(bulk->space, page_no, RW_X_LATCH, &mtr);
+		buf_page_dbg_add_level(page, SYNC_TREE_NODE_NEW);
+	}
+
+	if(bulk->last_rec_offs[level] == 0)
+		page_cur_set_before_first(page, &cur);
+	else
+		page_cur_position(page + bulk->last_rec_offs[level], &cur);
+
+	ins_rec = page_cur_rec_insert(&cur, rec, &mtr);
+	if(ins_rec == NULL){ /*ҳҲŲ¼*/
+		mtr_commit(&mtr);
+		return DB_TOO_BIG_RECORD;
+	}
+
+	/*ҶӲߵĵһ¼һС¼*/
+	if(level > 0 && bulk->last_rec_offs[level] == 0 && bulk->page_no[level] == bulk->first_page_no[level])
+		btr_set_min_rec_mark(ins_rec, &mtr);
+
+	if(level == 0)
+		page_update_max_trx_id(page, bulk->trx->id);
+
+	bulk->last_rec_offs[level] = ins_rec - page;
+
+	mtr_commit(&mtr);
+
+	return DB_SUCCESS;
+}
+
+/*Ψһа˳ڵ¼Ƿظ,ΨһкSQL NULLļ¼ظ*/
+static ibool row_merge_is_dup(rec_t* rec1, rec_t* rec2, dict_index_t* index)
+{
+	ulint	n_unique;
+	ulint	matched_fields	= 0;
+	ulint	matched_bytes	= 0;
+	ulint	len;
+	ulint	i;
+	ibool	ret		= FALSE;
+	mem_heap_t*	heap	= NULL;
+	ulint	offsets1_[REC_OFFS_SMALL_SIZE];
+	ulint	offsets2_[REC_OFFS_SMALL_SIZE];
+	ulint*	offsets1;
+	ulint*	offsets2;
+
+	rec_offs_init(offsets1_);
+	rec_offs_init(offsets2_);
+
+	n_unique = dict_index_get_n_unique(index);
+	offsets2 = rec_get_offsets(rec2, n_unique, offsets2_, &heap);
+
+	for(i = 0; i < n_unique; i ++){
+		rec_offs_get_nth_field(rec2, offsets2, i, &len);
+		if(len == UNIV_SQL_NULL)
+			goto func_exit;
+	}
+
+	offsets1 = rec_get_offsets(rec1, n_unique, offsets1_, &heap);
+	cmp_rec_rec_with_match(rec1, rec2, offsets1, offsets2, index, &matched_fields, &matched_bytes);
+
+	ret = (matched_fields >= n_unique);
+
+func_exit:
+	if(heap != NULL)
+		mem_heap_free(heap);
+
+	return ret;
+}
+
+/*˳һҶӼ¼*/
+static ulint row_merge_bulk_add(row_merge_bulk_t* bulk, rec_t* rec)
+{
+	ulint err;
+
+	if((bulk->index->type & DICT_UNIQUE) && bulk->prev_rec != NULL && row_merge_is_dup(bulk->prev_rec, rec, bulk->index))
+		return DB_DUPLICATE_KEY;
+
+	err = row_merge_bulk_insert(bulk, 0, rec);
+	if(err == DB_SUCCESS)
+		bulk->prev_rec = rec_copy(bulk->prev_buf, rec);
+
+	return err;
+}
+
+/*߲Ψһһҳļ¼rootҳ,rootҳpage_no¼ֵвܸı*/
+static ulint row_merge_bulk_finish(row_merge_bulk_t* bulk)
+{
+	page_t*	root;
+	page_t*	top_page;
+	ulint	top;
+	mtr_t	mtr;
+
+	if(bulk->n_levels == 0) /*ǿյ*/
+		return DB_SUCCESS;
+
+	top = bulk->n_levels - 1;
+	ut_a(bulk->page_no[top] == bulk->first_page_no[top]);
+
+	mtr_start(&mtr);
+	mtr_x_lock(dict_tree_get_lock(bulk->tree), &mtr);
+
+	root = btr_root_get(bulk->tree, &mtr);
+	ut_a(page_get_n_recs(root) == 0);
+
+	top_page = btr_page_get(bulk->space, bulk->page_no[top], RW_X_LATCH, &mtr);
+	buf_page_dbg_add_level(top_page, SYNC_TREE_NODE_NEW);
+
+	btr_page_set_level(root, top, &mtr);
+	page_copy_rec_list_end_to_created_page(root, top_page, page_get_infimum_rec(top_page), &mtr);
+
+	if(top > 0)
+		btr_set_min_rec_mark(page_rec_get_next(page_get_infimum_rec(root)), &mtr);
+	else
+		page_update_max_trx_id(root, bulk->trx->id);
+
+	btr_page_free_low(bulk->tree, top_page, top, &mtr);
+
+	mtr_commit(&mtr);
+
+	return DB_SUCCESS;
+}
+
+/*k·鲢runs[0, n_runs):writerΪNULLʱwriterϵһrun,˳bulk*/
+static ulint row_merge_runs(row_merge_t* merge, row_merge_run_t* runs, ulint n_runs, row_merge_writer_t* writer, row_merge_run_t* out_run)
+{
+	row_merge_reader_t*		readers;
+	row_merge_reader_t*		reader;
+	row_merge_heap_elem_t	elem;
+	byte*					blocks;
+	ib_bh_t*				heap;
+	ulint					err = DB_SUCCESS;
+	ulint					i;
+
+	readers = ut_malloc(n_runs * sizeof(row_merge_reader_t));
+	blocks = ut_malloc(n_runs * ROW_MERGE_BLOCK_SIZE);
+	heap = ib_bh_create(row_merge_heap_cmp, sizeof(row_merge_heap_elem_t), n_runs);
+
+	elem.index = merge->index;
+	for(i = 0; i < n_runs; i ++){
+		row_merge_reader_init(readers + i, merge->fd[0], blocks + i * ROW_MERGE_BLOCK_SIZE, runs + i);
+		row_merge_reader_next(readers + i);
+
+		if(readers[i].rec != NULL){
+			elem.rec = readers[i].rec;
+			elem.reader_no = i;
+			ib_bh_push(heap, &elem);
+		}
+	}
+
+	if(writer != NULL)
+		out_run->first_block = writer->block_no;
+
+	while(!ib_bh_is_empty(heap)){
+		elem = *(row_merge_heap_elem_t*)ib_bh_first(heap);
+		ib_bh_pop(heap);
+
+		/*elem.recָreaderblock,readerһ¼֮ǰ*/
+		if(writer != NULL){
+			if(!row_merge_write_rec(writer, elem.rec)){
+				err = DB_OUT_OF_FILE_SPACE;
+				break;
+			}
+		}
+		else{
+			err = row_merge_bulk_add(&(merge->bulk), elem.rec);
+			if(err != DB_SUCCESS)
+				break;
+		}
+
+		reader = readers + elem.reader_no;
+		row_merge_reader_next(reader);
+		if(reader->rec != NULL){
+			elem.rec = reader->rec;
+			ib_bh_push(heap, &elem);
+		}
+	}
+
+	if(err == DB_SUCCESS && writer != NULL && !row_merge_writer_end_run(writer, out_run))
+		err = DB_OUT_OF_FILE_SPACE;
+
+	ib_bh_free(heap);
+	ut_free(blocks);
+	ut_free(readers);
+
+	return err;
+}
+
+/*runROW_MERGE_FANINʱ,ÿROW_MERGE_FANINrun鲢һдһʱļ,ֱʣµrunһ˹鲢*/
+static ulint row_merge_reduce_runs(row_merge_t* merge)
+{
+	row_merge_run_t*	new_runs;
+	row_merge_run_t		run;
+	ulint				n_new_runs;
+	ulint				new_runs_size;
+	ulint				n;
+	ulint				i;
+	ulint				err;
+	os_file_t			fd;
+
+	while(merge->n_runs > ROW_MERGE_FANIN){
+		if(merge->fd[1] < 0){
+			merge->fd[1] = os_file_create_tmpfile();
+			if(merge->fd[1] < 0)
+				return DB_ERROR;
+		}
+
+		/*ļԭѾû,ͷʼ*/
+		merge->writer.fd = merge->fd[1];
+		merge->writer.block_no = 0;
+		merge->writer.used = 0;
+
+		new_runs = NULL;
+		n_new_runs = 0;
+		new_runs_size = 0;
+
+		for(i = 0; i < merge->n_runs; i += n){
+			n = ut_min(ROW_MERGE_FANIN, merge->n_runs - i);
+
+			err = row_merge_runs(merge, merge->runs + i, n, &(merge->writer), &run);
+			if(err != DB_SUCCESS){
+				if(new_runs != NULL)
+					ut_free(new_runs);
+				return err;
+			}
+
+			row_merge_push_run(&new_runs, &n_new_runs, &new_runs_size, &run);
+		}
+
+		ut_free(merge->runs);
+		merge->runs = new_runs;
+		merge->n_runs = n_new_runs;
+		merge->runs_size = new_runs_size;
+
+		fd = merge->fd[0];
+		merge->fd[0] = merge->fd[1];
+		merge->fd[1] = fd;
+	}
+
+	return DB_SUCCESS;
+}
+
+ibool row_merge_table_is_empty(dict_table_t* table)
+{
+	btr_pcur_t	pcur;
+	mtr_t		mtr;
+	ibool		empty;
+
+	mtr_start(&mtr);
+	btr_pcur_open_at_index_side(TRUE, dict_table_get_first_index(table), BTR_SEARCH_LEAF, &pcur, TRUE, &mtr);
+
+	empty = !btr_pcur_move_to_next_user_rec(&pcur, &mtr);
+
+	btr_pcur_close(&pcur);
+	mtr_commit(&mtr);
+
+	return empty;
+}
+
+ulint row_merge_build_index(trx_t* trx, dict_table_t* table, dict_index_t* index)
+{
+	row_merge_t	merge;
+	ulint		err;
+	ulint		i;
+
+	ut_ad(!(index->type & DICT_CLUSTERED));
+	ut_ad(!mutex_own(&(dict_sys->mutex)));
+
+	merge.index = index;
+	merge.fd[0] = -1;
+	merge.fd[1] = -1;
+	merge.writer.block = ut_malloc(ROW_MERGE_BLOCK_SIZE);
+	merge.runs = NULL;
+	merge.n_runs = 0;
+	merge.runs_size = 0;
+
+	row_merge_buf_init(&(merge.buf));
+	row_merge_bulk_init(&(merge.bulk), trx, index);
+
+	err = row_merge_read_clustered_index(&merge, table);
+	if(err != DB_SUCCESS)
+		goto func_exit;
+
+	if(merge.n_runs == 0){ /*м¼򻺳,Ҫʱļ*/
+		row_merge_sort_low(merge.buf.recs, merge.buf.aux, 0, merge.buf.n_recs, index);
+
+		for(i = 0; i < merge.buf.n_recs; i ++){
+			err = row_merge_bulk_add(&(merge.bulk), merge.buf.recs[i]);
+			if(err != DB_SUCCESS)
+				goto func_exit;
+		}
+	}
+	else{
+		if(merge.buf.n_recs > 0){
+			err = row_merge_buf_write_run(&merge);
+			if(err != DB_SUCCESS)
+				goto func_exit;
+		}
+
+		err = row_merge_reduce_runs(&merge);
+		if(err != DB_SUCCESS)
+			goto func_exit;
+
+		err = row_merge_runs(&merge, merge.runs, merge.n_runs, NULL, NULL);
+		if(err != DB_SUCCESS)
+			goto func_exit;
+	}
+
+	err = row_merge_bulk_finish(&(merge.bulk));
+
+func_exit:
+	/*ҳļ¼ûдredo,ύ֮ǰֻ·ҳˢ,ҳдǰȰredoˢҳlsn*/
+	if(merge.bulk.n_pages > 0)
+		buf_flush_pages(merge.bulk.space, merge.bulk.page_nos, merge.bulk.n_pages);
+
+	row_merge_bulk_free(&(merge.bulk));
+	row_merge_buf_free(&(merge.buf));
+	ut_free(merge.writer.block);
+
+	if(merge.runs != NULL)
+		ut_free(merge.runs);
+
+	for(i = 0; i < 2; i ++){
+		if(merge.fd[i] >= 0)
+			os_file_close(merge.fd[i]);
+	}
+
+	return err;
+}
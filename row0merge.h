@@ -0,0 +1,17 @@
+#ifndef __row0merge_h_
+#define __row0merge_h_
+
+#include "univ.h"
+#include "dict0types.h"
+#include "trx0types.h"
+
+/*ݵı:ɨۼ,¼ֶдʱļ,·鲢Ժ
+˳ԵB-treeҳ,btr_cur_optimistic_insert/btr_page_split_and_insert
+indexǸոմĿ,߳бX֤߱ڼû߳޸,Ҳdict_sys->mutex*/
+ulint			row_merge_build_index(trx_t* trx, dict_table_t* table, dict_index_t* index);
+
+/*ľۼǷûκμ¼,Ѿɾļ¼*/
+ibool			row_merge_table_is_empty(dict_table_t* table);
+
+#endif
+
@@ -18,11 +18,13 @@ Created 9/17/2000 Heikki Tuuri
 #include "dict0dict.h"
 #include "dict0crea.h"
 #include "dict0load.h"
+#include "dict0boot.h"
 #include "trx0roll.h"
 #include "trx0purge.h"
 #include "lock0lock.h"
 #include "rem0cmp.h"
 #include "log0log.h"
+#include "row0merge.h"
 
 /* A dummy variable used to fool the compiler */
 ibool	row_mysql_identically_false	= FALSE;
@@ -355,6 +357,9 @@ row_create_prebuilt(
 		prebuilt->fetch_cache[i] = NULL;
 	}
 
+	prebuilt->fetch_cache_size = 0;
+	prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_INIT;
+	prebuilt->fetch_cache_first = 0;
 	prebuilt->n_fetch_cached = 0;
 
 	prebuilt->blob_heap = NULL;
@@ -372,8 +377,6 @@ row_prebuilt_free(
 /*==============*/
 	row_prebuilt_t*	prebuilt)	/* in, own: prebuilt struct */
 {
-	ulint	i;
-
 	if (prebuilt->magic_n != ROW_PREBUILT_ALLOCATED) {
 		fprintf(stderr,
 		"InnoDB: Error: trying to free a corrupt\n"
@@ -414,10 +417,8 @@ row_prebuilt_free(
 		mem_heap_free(prebuilt->old_vers_heap);
 	}
 	
-	for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-		if (prebuilt->fetch_cache[i] != NULL) {
-			mem_free(prebuilt->fetch_cache[i]);
-		}
+	if (prebuilt->fetch_cache[0] != NULL) {
+		mem_free(prebuilt->fetch_cache[0]);
 	}
 
 	dict_table_decrement_handle_count(prebuilt->table);
@@ -750,6 +751,327 @@ run_again:
 	return((int) err);
 }
 
+/*************************************************************************
+Copies a converted row to a heap, so that the row buffers of the prebuilt
+insert node can be reused for the next row. */
+static
+dtuple_t*
+row_mysql_copy_row(
+/*===============*/
+				/* out, own: copy of row */
+	dtuple_t*	row,	/* in: row */
+	mem_heap_t*	heap)	/* in: memory heap */
+{
+	dtuple_t*	copy;
+	dfield_t*	field;
+	ulint		n_fields;
+	ulint		i;
+
+	n_fields = dtuple_get_n_fields(row);
+	copy = dtuple_create(heap, n_fields);
+
+	for (i = 0; i < n_fields; i++) {
+		field = dtuple_get_nth_field(copy, i);
+
+		dfield_copy(field, dtuple_get_nth_field(row, i));
+
+		if (dfield_get_len(field) != UNIV_SQL_NULL) {
+			dfield_set_data(field,
+				mem_heap_dup(heap, dfield_get_data(field),
+						dfield_get_len(field)),
+				dfield_get_len(field));
+		}
+	}
+
+	return(copy);
+}
+
+/*************************************************************************
+Compares two index entries on their first n fields. */
+static
+int
+row_mysql_cmp_entries(
+/*==================*/
+				/* out: 1, 0, -1 if e1 is greater, equal,
+				less than e2 */
+	dtuple_t*	e1,	/* in: index entry */
+	dtuple_t*	e2,	/* in: index entry */
+	ulint		n)	/* in: number of fields to compare */
+{
+	ulint	i;
+	int	ret;
+
+	for (i = 0; i < n; i++) {
+		ret = cmp_dfield_dfield(dtuple_get_nth_field(e1, i),
+					dtuple_get_nth_field(e2, i));
+		if (ret != 0) {
+
+			return(ret);
+		}
+	}
+
+	return(0);
+}
+
+/*************************************************************************
+Sorts the clustered index entries of a multi-row insert with a stable
+merge sort; the rows are permuted together with their entries. */
+static
+void
+row_mysql_sort_entries(
+/*===================*/
+	dtuple_t**	entries,/* in/out: clustered index entries */
+	dtuple_t**	rows,	/* in/out: rows of the entries */
+	dtuple_t**	aux,	/* in: work array of 2 * (high - low) */
+	ulint		n_cmp,	/* in: number of fields to compare */
+	ulint		low,	/* in: start of the range */
+	ulint		high)	/* in: end of the range, not included */
+{
+	ulint	mid;
+	ulint	i;
+	ulint	j;
+	ulint	k;
+	ulint	n;
+
+	if (high - low < 2) {
+
+		return;
+	}
+
+	mid = (low + high) / 2;
+
+	row_mysql_sort_entries(entries, rows, aux, n_cmp, low, mid);
+	row_mysql_sort_entries(entries, rows, aux, n_cmp, mid, high);
+
+	if (row_mysql_cmp_entries(entries[mid - 1], entries[mid], n_cmp)
+	    <= 0) {
+		/* Already in order */
+
+		return;
+	}
+
+	n = high - low;
+	i = low;
+	j = mid;
+
+	for (k = 0; k < n; k++) {
+		if (j >= high
+		    || (i < mid && row_mysql_cmp_entries(entries[i],
+						entries[j], n_cmp) <= 0)) {
+			aux[k] = entries[i];
+			aux[n + k] = rows[i];
+			i++;
+		} else {
+			aux[k] = entries[j];
+			aux[n + k] = rows[j];
+			j++;
+		}
+	}
+
+	for (k = 0; k < n; k++) {
+		entries[low + k] = aux[k];
+		rows[low + k] = aux[n + k];
+	}
+}
+
+/*************************************************************************
+Does a multi-row insert for MySQL. The rows are converted and sorted on
+the clustered index key, so that consecutive rows mostly land on the same
+leaf page: the clustered index inserts are then done with one tree
+descent and one mini-transaction per leaf page. The secondary index
+entries are inserted row by row afterwards. All the rows share one
+savepoint: if any of them fails, the whole array is rolled back. */
+
+int
+row_insert_array_for_mysql(
+/*=======================*/
+					/* out: error code or DB_SUCCESS */
+	byte**		mysql_recs,	/* in: rows in the MySQL format */
+	ulint		n_recs,		/* in: number of rows */
+	row_prebuilt_t*	prebuilt)	/* in: prebuilt struct in MySQL
+					handle */
+{
+	trx_savept_t	savept;
+	que_thr_t*	thr;
+	ulint		err;
+	ibool		was_lock_wait;
+	mem_heap_t*	heap;
+	dtuple_t**	rows;
+	dtuple_t**	entries;
+	dtuple_t*	entry;
+	dict_index_t*	clust_index;
+	dict_index_t*	index;
+	ulint		n_done;
+	ulint		i;
+	trx_t*		trx 		= prebuilt->trx;
+	ins_node_t*	node		= prebuilt->ins_node;
+	dict_table_t*	table		= prebuilt->table;
+
+	ut_ad(trx);
+	ut_ad(trx->mysql_thread_id == os_thread_get_curr_id());
+
+	if (n_recs == 0) {
+
+		return(DB_SUCCESS);
+	}
+
+	if (prebuilt->magic_n != ROW_PREBUILT_ALLOCATED) {
+		fprintf(stderr,
+		"InnoDB: Error: trying to free a corrupt\n"
+		"InnoDB: table handle. Magic n %lu, table name %s\n",
+		prebuilt->magic_n, prebuilt->table->name);
+
+		mem_analyze_corruption((byte*)prebuilt);
+
+		ut_a(0);
+	}
+
+	if (srv_created_new_raw || srv_force_recovery) {
+		fprintf(stderr,
+		"InnoDB: A new raw disk partition was initialized or\n"
+		"InnoDB: innodb_force_recovery is on: we do not allow\n"
+		"InnoDB: database modifications by the user. Shut down\n"
+		"InnoDB: mysqld and edit my.cnf so that newraw is replaced\n"
+		"InnoDB: with raw, and innodb_force_... is removed.\n");
+
+		return(DB_ERROR);
+	}
+
+	trx->op_info = "inserting";
+
+	trx_start_if_not_started(trx);
+
+	if (node == NULL) {
+		row_get_prebuilt_insert_row(prebuilt);
+		node = prebuilt->ins_node;
+	}
+
+	clust_index = dict_table_get_first_index(table);
+
+	heap = mem_heap_create(1024);
+
+	rows = (dtuple_t**)mem_heap_alloc(heap, 4 * n_recs * sizeof(dtuple_t*));
+	entries = rows + n_recs;
+
+	savept = trx_savept_take(trx);
+
+	thr = que_fork_get_first_thr(prebuilt->ins_graph);
+
+	que_thr_move_to_run_state_for_mysql(thr, trx);
+
+lock_again:
+	/* Set the IX lock on the table as row_ins_step would do it for
+	the first row of the statement */
+
+	if (!UT_DULINT_EQ(trx->id, node->trx_id)) {
+		trx_write_trx_id(node->trx_id_buf, trx->id);
+
+		err = lock_table(0, table, LOCK_IX, thr);
+
+		if (err != DB_SUCCESS) {
+			trx->error_state = err;
+
+			goto handle_error;
+		}
+
+		node->trx_id = trx->id;
+	}
+
+	prebuilt->sql_stat_start = FALSE;
+	node->state = INS_NODE_ALLOC_ROW_ID;
+
+	/* Convert the rows; the row id is allocated here because the
+	clustered index entries are sorted before they are inserted */
+
+	for (i = 0; i < n_recs; i++) {
+		row_mysql_convert_row_to_innobase(node->row, prebuilt,
+							mysql_recs[i]);
+
+		if (!(clust_index->type & DICT_UNIQUE)) {
+			dict_sys_write_row_id(node->row_id_buf,
+						dict_sys_get_new_row_id());
+		}
+
+		rows[i] = row_mysql_copy_row(node->row, heap);
+		entries[i] = row_build_index_entry(rows[i], clust_index, heap);
+	}
+
+	row_mysql_sort_entries(entries, rows, entries + n_recs,
+			dict_index_get_n_unique(clust_index), 0, n_recs);
+
+	n_done = 0;
+	index = clust_index;
+	i = 0;
+
+run_again:
+	if (index == clust_index) {
+		err = row_ins_clust_index_entries_batch(clust_index, entries,
+							n_recs, &n_done, thr);
+		if (err != DB_SUCCESS) {
+			trx->error_state = err;
+
+			goto handle_error;
+		}
+
+		index = dict_table_get_next_index(clust_index);
+	}
+
+	while (index != NULL) {
+		for (; i < n_recs; i++) {
+			entry = row_build_index_entry(rows[i], index, heap);
+
+			err = row_ins_index_entry(index, entry, NULL, 0, thr);
+
+			if (err != DB_SUCCESS) {
+				trx->error_state = err;
+
+				goto handle_error;
+			}
+		}
+
+		index = dict_table_get_next_index(index);
+		i = 0;
+	}
+
+	que_thr_stop_for_mysql_no_error(thr, trx);
+
+	mem_heap_free(heap);
+
+	table->stat_n_rows += n_recs;
+
+	srv_n_rows_inserted += n_recs;
+
+	if (table->stat_n_rows < n_recs) {
+		/* Avoid wrap-over */
+		table->stat_n_rows = ULINT_MAX;
+	}
+
+	row_update_statistics_if_needed(table);
+	trx->op_info = "";
+
+	return(DB_SUCCESS);
+
+handle_error:
+	que_thr_stop_for_mysql(thr);
+
+	was_lock_wait = row_mysql_handle_errors(&err, trx, thr, &savept);
+
+	if (was_lock_wait) {
+		if (!UT_DULINT_EQ(trx->id, node->trx_id)) {
+
+			goto lock_again;
+		}
+
+		goto run_again;
+	}
+
+	mem_heap_free(heap);
+
+	trx->op_info = "";
+
+	return((int) err);
+}
+
 /*************************************************************************
 Builds a dummy query graph used in selects. */
 
@@ -1380,9 +1702,76 @@ row_create_table_for_mysql(
 }
 
 /*************************************************************************
-Does an index creation operation for MySQL. TODO: currently failure
-to create an index results in dropping the whole table! This is no problem
-currently as all indexes must be created at the same time as the table. */
+Sets an exclusive lock on a table before a new index is built on it.
+The lock wait is done without the dictionary mutex: the caller must not
+hold it. */
+static
+ulint
+row_lock_table_for_create_index(
+/*============================*/
+				/* out: error code or DB_SUCCESS */
+	dict_table_t*	table,	/* in: table to lock */
+	trx_t*		trx)	/* in: transaction handle */
+{
+	mem_heap_t*	heap;
+	que_t*		graph;
+	que_thr_t*	thr;
+	sel_node_t*	node;
+	ulint		err;
+	ibool		was_lock_wait;
+
+	ut_ad(!mutex_own(&(dict_sys->mutex)));
+
+	trx->op_info = (char *) "setting table lock for creating index";
+
+	/* The lock module call needs a query thread: use a dummy
+	select graph as row_search_for_mysql does */
+
+	heap = mem_heap_create(512);
+
+	node = sel_node_create(heap);
+
+	graph = que_node_get_parent(
+			pars_complete_graph_for_exec(node, trx, heap));
+	graph->state = QUE_FORK_ACTIVE;
+
+	thr = que_fork_get_first_thr(graph);
+
+	que_thr_move_to_run_state_for_mysql(thr, trx);
+
+run_again:
+	trx_start_if_not_started(trx);
+
+	err = lock_table(0, table, LOCK_X, thr);
+
+	trx->error_state = err;
+
+	if (err != DB_SUCCESS) {
+		que_thr_stop_for_mysql(thr);
+
+		was_lock_wait = row_mysql_handle_errors(&err, trx, thr, NULL);
+
+		if (was_lock_wait) {
+			goto run_again;
+		}
+	} else {
+		que_thr_stop_for_mysql_no_error(thr, trx);
+	}
+
+	que_graph_free(graph);
+
+	trx->op_info = (char *) "";
+
+	return(err);
+}
+
+/*************************************************************************
+Does an index creation operation for MySQL. If the table already contains
+rows, a failure removes only the new index: the creation is rolled back
+to a savepoint and the index is removed from the dictionary cache. TODO:
+otherwise failure to create an index results in dropping the whole table!
+This is no problem as then the index is created at the same time as the
+table. */
 
 int
 row_create_index_for_mysql(
@@ -1393,12 +1782,20 @@ row_create_index_for_mysql(
 {
 	ind_node_t*	node;
 	mem_heap_t*	heap;
+	mem_heap_t*	name_heap;
 	que_thr_t*	thr;
+	dict_table_t*	table;
+	char*		table_name;
+	char*		index_name;
+	ulint		index_type;
 	ulint		namelen;
 	ulint		keywordlen;
 	ulint		err;
 	ulint		i;
 	ulint		j;
+	ibool		build	= FALSE;
+	ulint		n_indexes = 0;
+	trx_savept_t	savept;
 	
 	ut_ad(mutex_own(&(dict_sys->mutex)));
 	ut_ad(trx->mysql_thread_id == os_thread_get_curr_id());
@@ -1407,7 +1804,19 @@ row_create_index_for_mysql(
 
 	trx_start_if_not_started(trx);
 
+	/* The index object is freed when it is added to the dictionary
+	cache: keep copies of the names */
+
+	name_heap = mem_heap_create(512);
+
 	namelen = ut_strlen(index->table_name);
+	table_name = mem_heap_alloc(name_heap, namelen + 1);
+	ut_memcpy(table_name, index->table_name, namelen + 1);
+
+	index_name = mem_heap_alloc(name_heap, ut_strlen(index->name) + 1);
+	ut_memcpy(index_name, index->name, ut_strlen(index->name) + 1);
+
+	index_type = index->type;
 
 	keywordlen = ut_strlen("_recover_innodb_tmp_table");
 
@@ -1416,6 +1825,8 @@ row_create_index_for_mysql(
 				index->table_name + namelen - keywordlen,
  				"_recover_innodb_tmp_table", keywordlen)) {
 
+		mem_heap_free(name_heap);
+
 		return(DB_SUCCESS);
 	}
 
@@ -1442,6 +1853,48 @@ row_create_index_for_mysql(
 		}
 	}
 
+	if (!(index_type & DICT_CLUSTERED)) {
+		table = dict_table_get_low(table_name);
+
+		if (table != NULL
+		    && (table->n_mysql_handles_opened > 0
+			|| !row_merge_table_is_empty(table))) {
+
+			/* Other transactions may use the table: lock it
+			exclusively before the new index becomes visible
+			to them. The dictionary mutex is not held during
+			the lock wait; the caller's X-latch on
+			dict_foreign_key_check_lock keeps other dictionary
+			operations from dropping the table meanwhile */
+
+			mutex_exit(&(dict_sys->mutex));
+
+			err = row_lock_table_for_create_index(table, trx);
+
+			mutex_enter(&(dict_sys->mutex));
+
+			if (err != DB_SUCCESS) {
+				mem_heap_free(name_heap);
+
+				trx->op_info = (char *) "";
+
+				return((int) err);
+			}
+
+			trx->op_info = (char *) "creating index";
+
+			build = !row_merge_table_is_empty(table);
+		}
+	}
+
+	if (build) {
+		/* Remember where the index creation starts, so that a
+		failure can be undone without dropping the table */
+
+		n_indexes = UT_LIST_GET_LEN(table->indexes);
+		savept = trx_savept_take(trx);
+	}
+
 	heap = mem_heap_create(512);
 
 	trx->dict_operation = TRUE;
@@ -1458,19 +1911,58 @@ row_create_index_for_mysql(
 
 	que_graph_free((que_t*) que_node_get_parent(thr));
 
+	if (err == DB_SUCCESS && build) {
+		/* The table already contains rows: fill the new
+		secondary index with a sorted bulk load instead of
+		inserting the entries one by one. The table lock keeps
+		other transactions out, so the dictionary mutex is
+		released for the duration of the build. The index
+		definition stays uncommitted until the caller commits,
+		so a crash during the build rolls it back */
+
+		table = dict_table_get_low(table_name);
+		index = dict_table_get_index(table, index_name);
+
+		mutex_exit(&(dict_sys->mutex));
+
+		err = row_merge_build_index(trx, table, index);
+
+		mutex_enter(&(dict_sys->mutex));
+	}
+
 error_handling:
-	if (err != DB_SUCCESS) {
+	if (err != DB_SUCCESS && build) {
+		/* The table holds rows: undo only the index creation.
+		Rolling back the insert into SYS_INDEXES frees the index
+		tree; the new index is the last one in the cache */
+
+		trx->error_state = DB_SUCCESS;
+
+		trx_general_rollback_for_mysql(trx, TRUE, &savept);
+
+		table = dict_table_get_low(table_name);
+
+		if (UT_LIST_GET_LEN(table->indexes) > n_indexes) {
+			dict_index_remove_from_cache(table,
+					UT_LIST_GET_LAST(table->indexes));
+		}
+
+		trx->error_state = DB_SUCCESS;
+
+	} else if (err != DB_SUCCESS) {
 		/* We have special error handling here */
 		
 		trx->error_state = DB_SUCCESS;
 
 		trx_general_rollback_for_mysql(trx, FALSE, NULL);
 
-		row_drop_table_for_mysql(index->table_name, trx, TRUE);
+		row_drop_table_for_mysql(table_name, trx, TRUE);
 
 		trx->error_state = DB_SUCCESS;
 	}
 	
+	mem_heap_free(name_heap);
+
 	trx->op_info = (char *) "";
 
 	return((int) err);
@@ -1904,7 +2396,7 @@ row_drop_table_for_mysql(
 	graph->fork_type = QUE_FORK_MYSQL_INTERFACE;
 
 	/* Prevent purge from running while we are dropping the table */
-	rw_lock_s_lock(&(purge_sys->purge_is_running));
+	rw_lock_x_lock(&(purge_sys->purge_is_running));
 
 	table = dict_table_get_low(name);
 
@@ -1987,7 +2479,7 @@ row_drop_table_for_mysql(
 		}
 	}
 funct_exit:	
-	rw_lock_s_unlock(&(purge_sys->purge_is_running));
+	rw_lock_x_unlock(&(purge_sys->purge_is_running));
 
 	if (!has_dict_mutex) {
 		mutex_exit(&(dict_sys->mutex));
@@ -2318,6 +2810,8 @@ row_scan_and_check_index(
 {
 	mem_heap_t*	heap;
 	dtuple_t*	prev_entry = NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
 	ulint		matched_fields;
 	ulint		matched_bytes;
 	byte*		buf;
@@ -2333,6 +2827,8 @@ row_scan_and_check_index(
 	
 	buf = mem_alloc(UNIV_PAGE_SIZE);
 	heap = mem_heap_create(100);
+
+	rec_offs_init(offsets_);
 	
 	/* Make a dummy template in prebuilt, which we will use
 	in scanning the index entries */
@@ -2369,7 +2865,9 @@ loop:
 		matched_fields = 0;
 		matched_bytes = 0;
 	
-		cmp = cmp_dtuple_rec_with_match(prev_entry, rec,
+		/*offsets_ʱheapз,heapÿһֶᱻ*/
+		offsets = rec_get_offsets(rec, dtuple_get_n_fields_cmp(prev_entry), offsets_, &heap);
+		cmp = cmp_dtuple_rec_with_match(prev_entry, rec, offsets,
 						&matched_fields,
 						&matched_bytes);
 		contains_null = FALSE;
@@ -154,6 +154,19 @@ row_insert_for_mysql(
 	row_prebuilt_t*	prebuilt);	/* in: prebuilt struct in MySQL
 					handle */
 /*************************************************************************
+Does a multi-row insert for MySQL. The rows are sorted on the clustered
+index key and inserted into the clustered index in one batch; the whole
+array is undone if one of the rows fails. */
+
+int
+row_insert_array_for_mysql(
+/*=======================*/
+					/* out: error code or DB_SUCCESS */
+	byte**		mysql_recs,	/* in: rows in the MySQL format */
+	ulint		n_recs,		/* in: number of rows */
+	row_prebuilt_t*	prebuilt);	/* in: prebuilt struct in MySQL
+					handle */
+/*************************************************************************
 Builds a dummy query graph used in selects. */
 
 void
@@ -362,7 +375,14 @@ struct mysql_row_templ_struct {
 					it is an unsigned integer type */
 };
 
-#define MYSQL_FETCH_CACHE_SIZE		8
+/* Maximum number of rows in fetch_cache */
+#define MYSQL_FETCH_CACHE_SIZE		64
+/* Number of rows cached in the first batch; the batch size is doubled
+after each full batch up to MYSQL_FETCH_CACHE_SIZE rows */
+#define MYSQL_FETCH_CACHE_INIT		8
+/* Upper limit for the memory of fetch_cache, so that wide rows are
+cached in smaller batches */
+#define MYSQL_FETCH_CACHE_MAX_BYTES	(64 * 1024)
 /* After fetching this many rows, we start caching them in fetch_cache */
 #define MYSQL_FETCH_CACHE_THRESHOLD	4
 
@@ -465,9 +485,17 @@ struct row_prebuilt_struct {
 					fetch many rows from the same cursor:
 					it saves CPU time to fetch them in a
 					batch; we reserve mysql_row_len
-					bytes for each such row */
+					bytes for each such row; the rows
+					are allocated in one block pointed
+					to by fetch_cache[0] */
+	ulint		fetch_cache_size;/* number of rows allocated in
+					fetch_cache, or 0 */
+	ulint		fetch_cache_limit;/* number of rows to cache in the
+					current batch */
 	ulint		fetch_cache_first;/* position of the first not yet
-					fetched row in fetch_cache */
+					fetched row in fetch_cache; when the
+					cache is empty, the number of rows
+					in the previous batch */
 	ulint		n_fetch_cached;	/* number of not yet fetched rows
 					in fetch_cache */
 	mem_heap_t*	blob_heap;	/* in SELECTS BLOB fie lds are copied
@@ -24,7 +24,10 @@ purge_node_t* row_purge_node_create(que_thr_t* parent, mem_heap_t* heap)
 	node = mem_heap_alloc(heap, sizeof(purge_node_t));
 	node->common.type = QUE_NODE_PURGE;
 	node->common.parent = parent;
-	node->heap = heap;
+	/*node->heapÿpurgeһundo recͻ,graphheap*/
+	node->heap = mem_heap_create(256);
+	node->recs = NULL;
+	node->n_recs = 0;
 
 	return node;
 }
@@ -324,19 +327,19 @@ static ibool row_purge_parse_undo_rec(purge_node_t* node, ibool* updated_extern,
 	mutex_enter(&(dict_sys->mutex));
 	/*ԱĶȡ*/
 	node->table = dict_table_get_on_id(table_id, thr_get_trx(thr));
-	rw_lock_x_lock(&(purge_sys->purge_is_running));
+	rw_lock_s_lock(&(purge_sys->purge_is_running));
 
 	mutex_exit(&(dict_sys->mutex));
 
 	if (node->table == NULL){
-		rw_lock_x_unlock(&(purge_sys->purge_is_running));
+		rw_lock_s_unlock(&(purge_sys->purge_is_running));
 		return FALSE;
 	}
 
 	/*þۼ*/
 	clust_index = dict_table_get_first_index(node->table);
 	if(clust_index == NULL){ /*ۼڣ*/
-		rw_lock_x_unlock(&(purge_sys->purge_is_running));
+		rw_lock_s_unlock(&(purge_sys->purge_is_running));
 		return FALSE;
 	}
 
@@ -345,7 +348,7 @@ static ibool row_purge_parse_undo_rec(purge_node_t* node, ibool* updated_extern,
 	/*update vector*/
 	ptr = trx_undo_update_rec_get_update(ptr, clust_index, type, trx_id, roll_ptr, info_bits, node->heap, &(node->update));
 
-	if(!cmpl_info & UPD_NODE_NO_ORD_CHANGE){
+	if(!(cmpl_info & UPD_NODE_NO_ORD_CHANGE)){
 		/*undo update rec(ptr)жȡһм¼洢row*/
 		ptr = trx_undo_rec_get_partial_row(ptr, clust_index, &(node->row), node->heap);
 	}
@@ -353,23 +356,12 @@ static ibool row_purge_parse_undo_rec(purge_node_t* node, ibool* updated_extern,
 	return TRUE;
 }
 
-/*undo recpurge*/
-static ulint row_purge(purge_node_t* node, que_thr_t* thr)
+/*node->undo_recpurge,ɺͷpurge arrayеĲλ*/
+static void row_purge_rec(purge_node_t* node, que_thr_t* thr)
 {
-	dulint	roll_ptr;
 	ibool	purge_needed;
 	ibool	updated_extern;
 
-	ut_ad(node && thr);
-
-	/*һpurge undo rec*/
-	node->undo_rec = trx_purge_fetch_next_rec(&roll_ptr, &(node->reservation), node->heap);
-	if(node->undo_rec == NULL){
-		thr->run_node = que_node_get_parent(node);
-		return DB_SUCCESS;
-	}
-
-	node->roll_ptr = roll_ptr;
 	if(node->undo_rec == &trx_purge_dummy_rec)
 		purge_needed = FALSE;
 	else /*undo updage rec¼*/
@@ -388,17 +380,58 @@ static ulint row_purge(purge_node_t* node, que_thr_t* thr)
 		if(node->found_clust)
 			btr_pcur_close(&(node->pcur));
 
-		rw_lock_x_unlock(&(purge_sys->purge_is_running));		
+		rw_lock_s_unlock(&(purge_sys->purge_is_running));		
 	}
 
 	trx_purge_rec_release(node->reservation);
 	mem_heap_empty(node->heap);
-	
+}
+
+/*undo recpurge*/
+static ulint row_purge(purge_node_t* node, que_thr_t* thr)
+{
+	dulint	roll_ptr;
+
+	ut_ad(node && thr);
+
+	/*һpurge undo rec*/
+	node->undo_rec = trx_purge_fetch_next_rec(&roll_ptr, &(node->reservation), node->heap);
+	if(node->undo_rec == NULL){
+		thr->run_node = que_node_get_parent(node);
+		return DB_SUCCESS;
+	}
+
+	node->roll_ptr = roll_ptr;
+	row_purge_rec(node, thr);
+
 	thr->run_node = node;
 
 	return DB_SUCCESS;
 }
 
+/*purge coordinator䵽thrӦpurge nodeϵһundo rec,undo recĿcoordinatorͷ*/
+void row_purge_batch(que_thr_t* thr)
+{
+	purge_node_t*		node;
+	trx_purge_rec_t*	prec;
+	ulint				i;
+
+	node = thr->child;
+	ut_ad(que_node_get_type(node) == QUE_NODE_PURGE);
+
+	for(i = 0; i < node->n_recs; i++){
+		prec = node->recs + i;
+
+		node->undo_rec = prec->undo_rec;
+		node->roll_ptr = prec->roll_ptr;
+		node->reservation = prec->cell;
+
+		row_purge_rec(node, thr);
+	}
+
+	node->n_recs = 0;
+}
+
 /*purge̲*/
 que_thr_t* row_purge_step(que_thr_t* thr)
 {
@@ -31,6 +31,9 @@ struct purge_node_struct
 	dtuple_t*				row;
 	dict_index_t*			index;
 	mem_heap_t*				heap;
+
+	trx_purge_rec_t*		recs;		/*coordinator䵽nodeһundo rec*/
+	ulint					n_recs;
 };
 
 /*һpurge que node*/
@@ -39,6 +42,9 @@ purge_node_t*	row_purge_node_create(que_thr_t* parent, mem_heap_t* heap);
 /*purge que threadִ*/
 que_thr_t*		row_purge_step(que_thr_t* thr);
 
+/*purge thrӦpurge nodeϷ䵽һundo rec*/
+void			row_purge_batch(que_thr_t* thr);
+
 #endif
 
 
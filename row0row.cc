@@ -105,10 +105,14 @@ dtuple_t* row_build(ulint type, rec_t* rec ,dict_index_t* index, mem_heap_t* hea
 	ulint		row_len;
 	byte*		buf; 
 	ulint		i;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
 
 	ut_ad(index && rec && heap);
 	ut_ad(index->type & DICT_CLUSTERED);
 
+	rec_offs_init(offsets_);
+
 	if(type != ROW_COPY_POINTERS){
 		buf = mem_heap_alloc(heap, rec_get_size(rec));
 		rec = rec_copy(buf, rec);
@@ -124,12 +128,15 @@ dtuple_t* row_build(ulint type, rec_t* rec ,dict_index_t* index, mem_heap_t* hea
 
 	ut_ad(n_fields == rec_get_n_fields(rec));
 
+	/*һνеƫ,жʱoffsetsheapз*/
+	offsets = rec_get_offsets(rec, ULINT_UNDEFINED, offsets_, &heap);
+
 	for(i = 0; i < n_fields; i ++){
 		col = dict_field_get_col(dict_index_get_nth_field(index, i));
 		dfield = dtuple_get_nth_field(row, dict_col_get_no(col));
-		field = rec_get_nth_field(rec, i, &len);
+		field = rec_offs_get_nth_field(rec, offsets, i, &len);
 		/*BLOBеĿ*/
-		if (type == ROW_COPY_ALSO_EXTERNALS && rec_get_nth_field_extern_bit(rec, i))
+		if (type == ROW_COPY_ALSO_EXTERNALS && rec_offs_nth_extern(offsets, i))
 			field = btr_rec_copy_externally_stored_field(rec, i, &len, heap);
 
 		dfield_set_data(dfield, field, len);
@@ -151,9 +158,13 @@ dtuple_t* row_rec_to_index_entry(ulint type, dict_index_t* index, rec_t* rec, me
 	ulint		len;
 	ulint		rec_len;
 	byte*		buf;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
 
 	ut_ad(rec && heap && index);
 
+	rec_offs_init(offsets_);
+
 	/* Take a copy of rec to heap */
 	if (type == ROW_COPY_DATA) {
 		buf = mem_heap_alloc(heap, rec_get_size(rec));
@@ -169,9 +180,11 @@ dtuple_t* row_rec_to_index_entry(ulint type, dict_index_t* index, rec_t* rec, me
 	dict_index_copy_types(entry, index, rec_len);
 	dtuple_set_info_bits(entry, rec_get_info_bits(rec));
 
+	offsets = rec_get_offsets(rec, ULINT_UNDEFINED, offsets_, &heap);
+
 	for (i = 0; i < rec_len; i++) {
 		dfield = dtuple_get_nth_field(entry, i);
-		field = rec_get_nth_field(rec, i, &len);
+		field = rec_offs_get_nth_field(rec, offsets, i, &len);
 
 		dfield_set_data(dfield, field, len);
 	}
@@ -230,6 +243,10 @@ dtuple_t* row_build_row_ref(ulint type, dict_index_t* index, rec_t* rec, mem_hea
 			ut_memcpy(dfield_get_data(dfield), table->mix_id_buf, table->mix_id_len);
 		}
 	}
+
+	ut_ad(dtuple_check_typed(ref));
+
+	return ref;
 }
 
 /*row_build_row_refƣڲΪdtupleռ
@@ -235,6 +235,12 @@ row_sel_fetch_columns(
 	ulint		field_no;
 	byte*		data;
 	ulint		len;
+	mem_heap_t*	heap		= NULL;
+	ulint		offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*		offsets;
+
+	rec_offs_init(offsets_);
+	offsets = rec_get_offsets(rec, ULINT_UNDEFINED, offsets_, &heap);
 	
 	if (index->type & DICT_CLUSTERED) {
 		index_type = SYM_CLUST_FIELD_NO;
@@ -247,7 +253,8 @@ row_sel_fetch_columns(
 
 		if (field_no != ULINT_UNDEFINED) {
 	
-			data = rec_get_nth_field(rec, field_no, &len);
+			data = rec_offs_get_nth_field(rec, offsets, field_no,
+									&len);
 			
 			if (column->copy_val) {
 				eval_node_copy_and_alloc_val(column, data,
@@ -260,6 +267,10 @@ row_sel_fetch_columns(
 
 		column = UT_LIST_GET_NEXT(col_var_list, column);
 	}
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
 }
 
 /*************************************************************************
@@ -877,7 +888,7 @@ row_sel_try_search_shortcut(
 	ut_ad(node->read_view);
 	ut_ad(plan->unique_search);
 	ut_ad(!plan->must_get_clust);
-	ut_ad(rw_lock_own(&btr_search_latch, RW_LOCK_SHARED));
+	ut_ad(rw_lock_own(btr_search_get_latch(index), RW_LOCK_SHARED));
 	
 	row_sel_open_pcur(node, plan, TRUE, mtr);
 
@@ -953,6 +964,9 @@ row_sel(
 	rec_t*		old_vers;
 	rec_t*		clust_rec;
 	ibool		search_latch_locked;
+	rw_lock_t*	search_latch = NULL;	/* the adaptive hash index
+					partition latch held when
+					search_latch_locked is TRUE */
 	ibool		consistent_read;
 	
 		/* The following flag becomes TRUE when we are doing a
@@ -1033,11 +1047,22 @@ table_loop:
 
 	if (consistent_read && plan->unique_search && !plan->pcur_is_open
 						&& !plan->must_get_clust) {
+		if (search_latch_locked
+		    && search_latch != btr_search_get_latch(plan->index)) {
+			/* The latch we hold is for the partition of the
+			previous table in the join */
+
+			rw_lock_s_unlock(search_latch);
+
+			search_latch_locked = FALSE;
+		}
+
 		if (!search_latch_locked) {
-			rw_lock_s_lock(&btr_search_latch);
+			search_latch = btr_search_get_latch(plan->index);
+			rw_lock_s_lock(search_latch);
 
 			search_latch_locked = TRUE;
-		} else if (btr_search_latch.writer_is_wait_ex) {
+		} else if (rw_lock_get_writer(search_latch) == RW_LOCK_WAIT_EX) {
 
 			/* There is an x-latch request waiting: release the
 			s-latch for a moment; as an s-latch here is often
@@ -1046,8 +1071,8 @@ table_loop:
 			from acquiring an s-latch for a long time, lowering
 			performance significantly in multiprocessors. */
 
-			rw_lock_s_unlock(&btr_search_latch);
-			rw_lock_s_lock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
+			rw_lock_s_lock(search_latch);
 		}
 
 		found_flag = row_sel_try_search_shortcut(node, plan, &mtr);
@@ -1070,7 +1095,7 @@ table_loop:
 	}
 
 	if (search_latch_locked) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(search_latch);
 
 		search_latch_locked = FALSE;
 	}
@@ -1474,7 +1499,7 @@ next_table_no_mtr:
 		thr->run_node = que_node_get_parent(node);
 
 		if (search_latch_locked) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
 		}
 		
 		return(DB_SUCCESS);
@@ -1520,7 +1545,7 @@ table_exhausted_no_mtr:
 			thr->run_node = que_node_get_parent(node);
 
 			if (search_latch_locked) {
-				rw_lock_s_unlock(&btr_search_latch);
+				rw_lock_s_unlock(search_latch);
 			}
 		
 			return(DB_SUCCESS);
@@ -1531,7 +1556,7 @@ table_exhausted_no_mtr:
 		thr->run_node = que_node_get_parent(node);
 
 		if (search_latch_locked) {
-			rw_lock_s_unlock(&btr_search_latch);
+			rw_lock_s_unlock(search_latch);
 		}
 		
 		return(DB_SUCCESS);
@@ -2025,6 +2050,9 @@ row_sel_store_mysql_rec(
 {
 	mysql_row_templ_t*	templ;
 	mem_heap_t*		extern_field_heap	= NULL;
+	mem_heap_t*		heap			= NULL;
+	ulint			offsets_[REC_OFFS_NORMAL_SIZE];
+	ulint*			offsets;
 	byte*			data;
 	ulint			len;
 	byte*			blob_buf;
@@ -2032,6 +2060,12 @@ row_sel_store_mysql_rec(
 	
 	ut_ad(prebuilt->mysql_template);
 
+	/* Decode the field offsets of rec once instead of parsing the
+	record header again for every column of the template */
+
+	rec_offs_init(offsets_);
+	offsets = rec_get_offsets(rec, ULINT_UNDEFINED, offsets_, &heap);
+
 	if (prebuilt->blob_heap != NULL) {
 		mem_heap_free(prebuilt->blob_heap);
 		prebuilt->blob_heap = NULL;
@@ -2045,9 +2079,10 @@ row_sel_store_mysql_rec(
 
 		templ = prebuilt->mysql_template + i;
 
-		data = rec_get_nth_field(rec, templ->rec_field_no, &len);
+		data = rec_offs_get_nth_field(rec, offsets, templ->rec_field_no,
+									&len);
 
-		if (rec_get_nth_field_extern_bit(rec, templ->rec_field_no)) {
+		if (rec_offs_nth_extern(offsets, templ->rec_field_no)) {
 
 			/* Copy an externally stored field to the temporary
 			heap */
@@ -2112,6 +2147,10 @@ row_sel_store_mysql_rec(
 			}
 		}
 	} 
+
+	if (heap != NULL) {
+		mem_heap_free(heap);
+	}
 }
 
 /*************************************************************************
@@ -2349,9 +2388,9 @@ row_sel_pop_cached_row_for_mysql(
 	prebuilt->n_fetch_cached--;
 	prebuilt->fetch_cache_first++;
 
-	if (prebuilt->n_fetch_cached == 0) {
-		prebuilt->fetch_cache_first = 0;
-	}
+	/* When the cache becomes empty, fetch_cache_first is left to
+	the size of the batch: row_search_for_mysql uses it to see if
+	the batch ended at the end of the result set */
 }
 
 /************************************************************************
@@ -2363,18 +2402,32 @@ row_sel_push_cache_row_for_mysql(
 	row_prebuilt_t*	prebuilt,	/* in: prebuilt struct */
 	rec_t*		rec)		/* in: record to push */
 {
+	ulint	n;
 	ulint	i;
 
-	ut_ad(prebuilt->n_fetch_cached < MYSQL_FETCH_CACHE_SIZE);
+	ut_ad(prebuilt->n_fetch_cached < prebuilt->fetch_cache_limit);
 	ut_a(!prebuilt->templ_contains_blob);
 
 	if (prebuilt->fetch_cache[0] == NULL) {
-		/* Allocate memory for the fetch cache */
+		/* Allocate memory for the fetch cache in one block: wide
+		rows get fewer slots, but at least MYSQL_FETCH_CACHE_INIT */
 
-		for (i = 0; i < MYSQL_FETCH_CACHE_SIZE; i++) {
-			prebuilt->fetch_cache[i] = mem_alloc(
-						prebuilt->mysql_row_len);
+		n = MYSQL_FETCH_CACHE_MAX_BYTES
+				/ ut_max(prebuilt->mysql_row_len, 1);
+		n = ut_max(n, MYSQL_FETCH_CACHE_INIT);
+		n = ut_min(n, MYSQL_FETCH_CACHE_SIZE);
+
+		prebuilt->fetch_cache[0] = mem_alloc(
+					n * prebuilt->mysql_row_len);
+
+		for (i = 1; i < n; i++) {
+			prebuilt->fetch_cache[i] = prebuilt->fetch_cache[0]
+					+ i * prebuilt->mysql_row_len;
 		}
+
+		prebuilt->fetch_cache_size = n;
+		prebuilt->fetch_cache_limit = ut_min(
+				prebuilt->fetch_cache_limit, n);
 	}
 
 	ut_ad(prebuilt->fetch_cache_first == 0);
@@ -2531,6 +2584,7 @@ row_search_for_mysql(
 		prebuilt->n_rows_fetched = 0;
 		prebuilt->n_fetch_cached = 0;
 		prebuilt->fetch_cache_first = 0;
+		prebuilt->fetch_cache_limit = MYSQL_FETCH_CACHE_INIT;
 
 		if (prebuilt->sel_graph == NULL) {
 			/* Build a dummy select query graph */
@@ -2567,15 +2621,25 @@ row_search_for_mysql(
 			return(DB_SUCCESS);
 		}
 
-		if (prebuilt->fetch_cache_first > 0
-		    && prebuilt->fetch_cache_first < MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->fetch_cache_first > 0) {
+			if (prebuilt->fetch_cache_first
+			    < prebuilt->fetch_cache_limit) {
 
-		    	/* The previous returned row was popped from the fetch
-		    	cache, but the cache was not full at the time of the
-		    	popping: no more rows can exist in the result set */
-		    
-			trx->op_info = "";
-		    	return(DB_RECORD_NOT_FOUND);
+		    		/* The previous returned row was popped from
+		    		the fetch cache, but the batch was not full:
+		    		no more rows can exist in the result set */
+
+				trx->op_info = "";
+		    		return(DB_RECORD_NOT_FOUND);
+			}
+
+			/* The previous batch was full: the scan is long
+			enough to cache a bigger batch this time */
+
+			prebuilt->fetch_cache_first = 0;
+			prebuilt->fetch_cache_limit = ut_min(
+					2 * prebuilt->fetch_cache_limit,
+					prebuilt->fetch_cache_size);
 		}
 		
 		prebuilt->n_rows_fetched++;
@@ -2632,7 +2696,17 @@ row_search_for_mysql(
 			let us try a search shortcut through the hash
 			index */
 			
-			if (btr_search_latch.writer != RW_LOCK_NOT_LOCKED) {
+			if (trx->has_search_latch
+			    && trx->search_latch
+			       != btr_search_get_latch(index)) {
+				/* We hold the latch of another adaptive
+				hash index partition from a previous call */
+
+				trx_search_latch_release_if_reserved(trx);
+			}
+
+			if (rw_lock_get_writer(btr_search_get_latch(index))
+			    != RW_LOCK_NOT_LOCKED) {
 			        /* There is an x-latch request: release
 				a possible s-latch to reduce starvation
 				and wait for BTR_SEA_TIMEOUT rounds before
@@ -2640,7 +2714,7 @@ row_search_for_mysql(
 				MySQL */
 
 				if (trx->has_search_latch) {
-			        	rw_lock_s_unlock(&btr_search_latch);
+			        	rw_lock_s_unlock(trx->search_latch);
 					trx->has_search_latch = FALSE;
 				}
 
@@ -2650,7 +2724,8 @@ row_search_for_mysql(
 			}
 #ifndef UNIV_SEARCH_DEBUG			
 			if (!trx->has_search_latch) {
-				rw_lock_s_lock(&btr_search_latch);
+				trx->search_latch = btr_search_get_latch(index);
+				rw_lock_s_lock(trx->search_latch);
 				trx->has_search_latch = TRUE;
 			}
 #endif
@@ -2673,7 +2748,7 @@ row_search_for_mysql(
 
 					trx->search_latch_timeout--;
 
-			        	rw_lock_s_unlock(&btr_search_latch);
+			        	rw_lock_s_unlock(trx->search_latch);
 					trx->has_search_latch = FALSE;
 				}    	
 				
@@ -2692,7 +2767,7 @@ row_search_for_mysql(
 
 					trx->search_latch_timeout--;
 
-			        	rw_lock_s_unlock(&btr_search_latch);
+			        	rw_lock_s_unlock(trx->search_latch);
 					trx->has_search_latch = FALSE;
 				}
 
@@ -2706,7 +2781,7 @@ row_search_for_mysql(
 	}
 no_shortcut:	
 	if (trx->has_search_latch) {
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(trx->search_latch);
 		trx->has_search_latch = FALSE;
 	}			
 
@@ -2959,7 +3034,7 @@ rec_loop:
 
 		row_sel_push_cache_row_for_mysql(prebuilt, rec);
 
-		if (prebuilt->n_fetch_cached == MYSQL_FETCH_CACHE_SIZE) {
+		if (prebuilt->n_fetch_cached == prebuilt->fetch_cache_limit) {
 			
 			goto got_row;
 		}
@@ -54,7 +54,7 @@ UNIV_INLINE void upd_field_set_field_no(upd_field_t* upd_field, ulint field_no,
 UNIV_INLINE void row_upd_rec_sys_fields(rec_t* rec, dict_index_t* index, trx_t* trx, dulint roll_ptr)
 {
 	ut_ad(index->type & DICT_CLUSTERED);
-	ut_ad(!buf_block_align(rec)->is_hashed || rw_lock_own(&btr_search_latch, RW_LOCK_EX));
+	ut_ad(!buf_block_align(rec)->is_hashed || rw_lock_own(btr_search_get_latch(index), RW_LOCK_EX));
 
 	row_set_rec_trx_id(rec, index, trx->id);
 	row_set_rec_roll_ptr(rec, index, roll_ptr);
@@ -1,5 +1,6 @@
 #include "srv0srv.h"
 #include "ut0mem.h"
+#include "ut0rnd.h"
 #include "os0proc.h"
 #include "mem0mem.h"
 #include "mem0pool.h"
@@ -18,6 +19,7 @@
 #include "trx0purge.h"
 #include "ibuf0ibuf.h"
 #include "buf0flu.h"
+#include "ul0crc32.h"
 #include "btr0sea.h"
 #include "dict0load.h"
 #include "srv0start.h"
@@ -54,6 +56,8 @@ ulint	srv_n_log_files		= ULINT_MAX;
 ulint	srv_log_file_size	= ULINT_MAX;	/* size in database pages */ 
 ibool	srv_log_archive_on	= TRUE;
 ulint	srv_log_buffer_size	= ULINT_MAX;	/* size in database pages */ 
+/*mtrύʱֻlog_sys->mutexԤlsn,־mutex֮Ⲣн*/
+ibool	srv_log_parallel_copy	= FALSE;
 ulint	srv_flush_log_at_trx_commit = 1;
 
 byte	srv_latin1_ordering[256]={
@@ -94,6 +98,42 @@ byte	srv_latin1_ordering[256]={
 ibool	srv_use_native_aio	= FALSE;
 
 ulint	srv_pool_size		= ULINT_MAX;
+/*ʵ,ҳ(space, offset)ɢеʵ*/
+ulint	srv_buf_pool_instances	= 1;
+/*Ӧhashķ,index idɢе,ÿжlatch*/
+ulint	srv_adaptive_hash_index_parts = 8;
+/*lock_sysϣķƬ(2),ÿƬжmutex*/
+ulint	srv_lock_rec_hash_parts = 16;
+/*ԤĴֵ,һ64pageôpage˳ʹԤһ*/
+ulint	srv_read_ahead_threshold = 56;
+/*ָʱӦredo־߳,1ʾֻڻָ߳Ӧ*/
+ulint	srv_recv_apply_threads = 4;
+/*ҳchecksum㷨,BUF_CHECKSUM_ALGORITHM_*,ҳʱָʽʶ
+Ĭþɵ㷨,дҳɰ汾Ȼܶ,CRC32Ҫʽ*/
+ulint	srv_checksum_algorithm	= BUF_CHECKSUM_ALGORITHM_INNODB;
+/*purge߳(coordinator),undo rectable id䵽߳,1ʾֻcoordinatorԼpurge*/
+ulint	srv_n_purge_threads = 4;
+/*purge coordinatorÿһhistory listжȡundo rec*/
+ulint	srv_purge_batch_size = 300;
+/*ϵͳռrollback segmentĸ(TRX_SYS_N_RSEGS),ѯʽ䵽rseg*/
+ulint	srv_n_rollback_segs = 128;
+/*ÿܳܵҳд,master threadˢ̺Ӧˢ̶Ϊ*/
+ulint	srv_io_capacity = 200;
+/*ǷredoٶȺcheckpoint ageÿӦˢҳ*/
+ibool	srv_adaptive_flushing = TRUE;
+/*page cleanerΪÿbuffer poolʵάֵfree block(LRUβֱûblock)*/
+ulint	srv_LRU_scan_depth = 1024;
+/*ǷԭӲռ,ֻҪŶʱųsrv_conc_mutexֻʱ,
+ûԭӲƽ̨srv_conc_mutex*/
+#ifdef HAVE_ATOMIC_BUILTINS
+ibool	srv_conc_lock_free = TRUE;
+#else
+ibool	srv_conc_lock_free = FALSE;
+#endif
+/*ʱڴ򻺳ֽ,Ժźļ¼дʱļ*/
+ulint	srv_sort_buf_size = 1048576;
+/*ʱÿB-treeҳİٷֱ,ԤĿռԺĲ,Ϸ*/
+ulint	srv_fill_factor = 100;
 ulint	srv_mem_pool_size	= ULINT_MAX;
 ulint	srv_lock_table_size	= ULINT_MAX;
 ulint	srv_n_file_io_threads	= ULINT_MAX;
@@ -117,6 +157,17 @@ lint	srv_conc_n_threads	= 0;
 
 ulint	srv_conc_n_waiting_threads = 0;	
 
+/*ΪȴеĴܵĵȴʱһεȴʱ(΢),srv_conc_mutex*/
+ulint	srv_conc_n_waits = 0;
+ullint	srv_conc_wait_time_us = 0;
+ulint	srv_conc_max_wait_us = 0;
+
+/*Ŷ֮ǰĴ*/
+#define SRV_CONC_MAX_SPIN_ROUNDS	64
+
+/*Ӧ:ڼȵ,ûеȵͼ*/
+static ulint	srv_conc_spin_rounds = SRV_CONC_MAX_SPIN_ROUNDS / 4;
+
 typedef struct srv_conc_slot_struct
 {
 	os_event_t	event;
@@ -747,13 +798,151 @@ void srv_general_init()
 	sync_init();
 	mem_init(srv_mem_pool_size);
 	thr_local_init();
+	/*ѡCRC32ʵ,CPU֧SSE4.2ʱӲָ*/
+	ut_crc32_init();
+}
+
+#ifdef HAVE_ATOMIC_BUILTINS
+/*srv_conc_n_threadsûдﵽsrv_thread_concurrencyʱԭӵռһ*/
+static ibool srv_conc_try_reserve()
+{
+	lint n;
+
+	for(;;){
+		n = srv_conc_n_threads;
+		if(n >= (lint)srv_thread_concurrency)
+			return FALSE;
+
+		if(os_compare_and_swap_lint(&srv_conc_n_threads, n, n + 1))
+			return TRUE;
+	}
+}
+
+/*һȴеһûбѵ߳*/
+static void srv_conc_wake_next()
+{
+	srv_conc_slot_t* slot;
+
+	os_fast_mutex_lock(&srv_conc_mutex);
+
+	slot = UT_LIST_GET_FIRST(srv_conc_queue);
+	while(slot != NULL && slot->wait_ended)
+		slot = UT_LIST_GET_NEXT(srv_conc_queue, slot);
+
+	/*ѾûŶӵ߳,Ǹ߳˳ʱٻ*/
+	if(slot != NULL && srv_conc_try_reserve()){
+		slot->wait_ended = TRUE;
+		os_event_set(slot->event);
+	}
+
+	os_fast_mutex_unlock(&srv_conc_mutex);
+}
+#endif /* HAVE_ATOMIC_BUILTINS */
+
+/*¼һŶӵȴʱ,߳srv_conc_mutex*/
+static void srv_conc_note_wait(ullint start_us)
+{
+	ulint wait_us;
+
+	wait_us = (ulint)(ut_time_us(NULL) - start_us);
+
+	srv_conc_n_waits ++;
+	srv_conc_wait_time_us += wait_us;
+	if(wait_us > srv_conc_max_wait_us)
+		srv_conc_max_wait_us = wait_us;
+}
+
+#ifdef HAVE_ATOMIC_BUILTINS
+/*ģʽĽ:ԭӵռ,ʧܺٽFIFOеȴ*/
+static void srv_conc_enter_innodb_lock_free(trx_t* trx)
+{
+	srv_conc_slot_t*	slot;
+	ulint				spin_rounds;
+	ibool				reserved;
+	ullint				start_us;
+	ulint				i;
+
+	spin_rounds = srv_conc_spin_rounds;
+	for(i = 0; ; i ++){
+		if(srv_conc_try_reserve()){
+			if(i > 0 && srv_conc_spin_rounds < SRV_CONC_MAX_SPIN_ROUNDS)
+				srv_conc_spin_rounds ++;
+
+			goto entered;
+		}
+
+		if(i >= spin_rounds)
+			break;
+
+		ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+	}
+
+	/*ûеȵ,´һЩ*/
+	srv_conc_spin_rounds = ut_max(srv_conc_spin_rounds / 2, 1);
+
+	/*ͷsearch latch*/
+	if(trx->has_search_latch)
+		trx_search_latch_release_if_reserved(trx);
+
+	os_fast_mutex_lock(&srv_conc_mutex);
+
+	/*ҵһõslot*/
+	for(i = 0; i < OS_THREAD_MAX_N; i ++){
+		slot = srv_conc_slots + i;
+		if(!slot->reserved)
+			break;
+	}
+	/*ûпеslot,ֱӽ*/
+	if(i >= OS_THREAD_MAX_N){
+		os_atomic_increment_lint(&srv_conc_n_threads, 1);
+		trx->declared_to_be_inside_innodb = TRUE;
+		trx->n_tickets_to_enter_innodb = 0;
+
+		os_fast_mutex_unlock(&srv_conc_mutex);
+		return ;
+	}
+
+	slot->reserved = TRUE;
+	slot->wait_ended = FALSE;
+	UT_LIST_ADD_LAST(srv_conc_queue, srv_conc_queue, slot);
+	os_event_reset(slot->event);
+	os_atomic_increment_ulint(&srv_conc_n_waiting_threads, 1);
+
+	/*Ӻټһ:֮ǰ˳߳̿ȴ,*/
+	reserved = srv_conc_try_reserve();
+	if(reserved)
+		slot->wait_ended = TRUE;
+
+	os_fast_mutex_unlock(&srv_conc_mutex);
+
+	start_us = ut_time_us(NULL);
+	if(!reserved)
+		os_event_wait(slot->event);
+
+	os_fast_mutex_lock(&srv_conc_mutex);
+
+	/*黹slot,Ѿɻռ*/
+	os_atomic_decrement_ulint(&srv_conc_n_waiting_threads, 1);
+	slot->reserved = FALSE;
+	UT_LIST_REMOVE(srv_conc_queue, srv_conc_queue, slot);
+
+	if(!reserved)
+		srv_conc_note_wait(start_us);
+
+	os_fast_mutex_unlock(&srv_conc_mutex);
+
+entered:
+	trx->declared_to_be_inside_innodb = TRUE;
+	trx->n_tickets_to_enter_innodb = SRV_FREE_TICKETS_TO_ENTER;
 }
+#endif /* HAVE_ATOMIC_BUILTINS */
 
 /*粢̹߳࣬һos wait eventһ߳ϣFIFOнеȴ*/
 void srv_conc_enter_innodb(trx_t* trx)
 {
 	ibool				has_slept	= FALSE;
 	srv_conc_slot_t*	slot;
+	ullint				start_us;
 	ulint				i;
 
 	/**500ϵ̲߳ȴж*/
@@ -765,6 +954,13 @@ void srv_conc_enter_innodb(trx_t* trx)
 		return;
 	}
 
+#ifdef HAVE_ATOMIC_BUILTINS
+	if(srv_conc_lock_free){
+		srv_conc_enter_innodb_lock_free(trx);
+		return;
+	}
+#endif
+
 retry:
 	os_fast_mutex_lock(&srv_conc_mutex);
 	/*ûдﵽ߳*/
@@ -817,6 +1013,7 @@ retry:
 
 	/*ִеȴ*/
 	os_fast_mutex_unlock(&srv_conc_mutex);
+	start_us = ut_time_us(NULL);
 	os_event_wait(slot->event);
 	os_fast_mutex_lock(&srv_conc_mutex); /*os mutexΪos wait eventʱܳҪspin mutexΪһȴ*/
 
@@ -824,6 +1021,7 @@ retry:
 	srv_conc_n_waiting_threads--;
 	slot->reserved = FALSE;
 	UT_LIST_REMOVE(srv_conc_queue, srv_conc_queue, slot);
+	srv_conc_note_wait(start_us);
 
 	trx->declared_to_be_inside_innodb = TRUE;
 	trx->n_tickets_to_enter_innodb = SRV_FREE_TICKETS_TO_ENTER;
@@ -836,6 +1034,15 @@ void srv_conc_force_enter_innodb(trx_t* trx)
 	if (srv_thread_concurrency >= 500)
 		return;
 
+#ifdef HAVE_ATOMIC_BUILTINS
+	if(srv_conc_lock_free){
+		os_atomic_increment_lint(&srv_conc_n_threads, 1);
+		trx->declared_to_be_inside_innodb = TRUE;
+		trx->n_tickets_to_enter_innodb = 0;
+		return;
+	}
+#endif
+
 	os_fast_mutex_lock(&srv_conc_mutex);
 
 	srv_conc_n_threads++;
@@ -856,6 +1063,19 @@ void srv_conc_force_exit_innodb(trx_t* trx)
 	if (trx->declared_to_be_inside_innodb == FALSE)
 		return;
 
+#ifdef HAVE_ATOMIC_BUILTINS
+	if(srv_conc_lock_free){
+		trx->declared_to_be_inside_innodb = FALSE;
+		trx->n_tickets_to_enter_innodb = 0;
+
+		/*ԭӼfull barrier,͵ȴӺټ,ᶪʧ*/
+		os_atomic_decrement_lint(&srv_conc_n_threads, 1);
+		if(srv_conc_n_waiting_threads > 0)
+			srv_conc_wake_next();
+		return;
+	}
+#endif
+
 	os_fast_mutex_lock(&srv_conc_mutex);
 
 	srv_conc_n_threads--;
@@ -1125,7 +1345,7 @@ void srv_sprintf_innodb_monitor(char* buf, ulint len)
 	buf = buf + strlen(buf);
 	ut_a(buf < buf_end + 1500);
 	/*ӦhashϢ*/
-	ha_print_info(buf, buf_end, btr_search_sys->hash_index);
+	btr_search_print_info(buf, buf_end);
 	buf = buf + strlen(buf);
 	ut_a(buf < buf_end + 1500);
 
@@ -1161,6 +1381,11 @@ void srv_sprintf_innodb_monitor(char* buf, ulint len)
 		"%ld queries inside InnoDB, %ld queries in queue; main thread: %s\n",
 		srv_conc_n_threads, srv_conc_n_waiting_threads,
 		srv_main_thread_op_info);
+	buf += sprintf(buf,
+		"%lu queue waits, avg wait %lu us, max wait %lu us\n",
+		srv_conc_n_waits,
+		srv_conc_n_waits > 0 ? (ulint)(srv_conc_wait_time_us / srv_conc_n_waits) : 0,
+		srv_conc_max_wait_us);
 	buf += sprintf(buf,
 		"Number of rows inserted %lu, updated %lu, deleted %lu, read %lu\n",
 		srv_n_rows_inserted, 
@@ -1347,6 +1572,9 @@ void srv_wake_master_thread()
 	mutex_exit(&kernel_mutex);
 }
 
+/*srv_io_capacityİٷֱ,Ϊ1ҳ*/
+#define SRV_PCT_IO(p)	(ut_max(srv_io_capacity * (p) / 100, 1))
+
 /*master thread߳庯*/
 void* srv_master_thread(void* arg)
 {
@@ -1379,14 +1607,14 @@ void* srv_master_thread(void* arg)
 
 loop:
 	srv_main_thread_op_info = "reserving kernel mutex";
-	n_ios_very_old = log_sys->n_log_ios + buf_pool->n_pages_read + buf_pool->n_pages_written; /*IO*/
+	n_ios_very_old = log_sys->n_log_ios + buf_pool_get_n_pages_io(); /*IO*/
 
 	mutex_enter(&kernel_mutex);
 	old_activity_count = srv_activity_count; /*ѭǰ̵߳Ĵ*/
 	mutex_exit(&kernel_mutex);
 
 	for(i = 0; i < 10; i++){
-		n_ios_old = log_sys->n_log_ios + buf_pool->n_pages_read + buf_pool->n_pages_written;
+		n_ios_old = log_sys->n_log_ios + buf_pool_get_n_pages_io();
 		srv_main_thread_op_info = (char*)"sleeping"; /*sleep 1*/
 		os_thread_sleep(1000000);
 
@@ -1404,7 +1632,7 @@ loop:
 		log_flush_to_disk();
 
 		n_pend_ios = buf_get_n_pending_ios() + log_sys->n_pending_writes;
-		n_ios = log_sys->n_log_ios + buf_pool->n_pages_read + buf_pool->n_pages_written;
+		n_ios = log_sys->n_log_ios + buf_pool_get_n_pages_io();
 		if(n_pend_ios < 3 && n_ios - n_ios_old < 10){ /*־̺ѭʼsleepǰ1֮IO*/
 			srv_main_thread_op_info = (char*)"doing insert buffer merge";
 			ibuf_contract_for_n_pages(TRUE, 5); /*insert bufferݹ鲢,鲢5ҳݵ*/
@@ -1431,10 +1659,10 @@ loop:
 		printf("Master thread wakes up!\n");
 
 	n_pend_ios = buf_get_n_pending_ios() + log_sys->n_pending_writes;
-	n_ios = log_sys->n_log_ios + buf_pool->n_pages_read + buf_pool->n_pages_written;
+	n_ios = log_sys->n_log_ios + buf_pool_get_n_pages_io();
 	if(n_pend_ios < 3 && n_ios - n_ios_very_old < 200){ /*ִеIO<3ͱloopɵIO < 200, buffer poolpageˢ*/
 		srv_main_thread_op_info = "flushing buffer pool pages";
-		buf_flush_batch(BUF_FLUSH_LIST, 50, ut_dulint_max);
+		buf_flush_list(SRV_PCT_IO(25), ut_dulint_max);
 
 		srv_main_thread_op_info = "flushing log";
 		log_flush_up_to(ut_dulint_max, LOG_WAIT_ONE_GROUP);
@@ -1482,7 +1710,7 @@ background_loop:
 	srv_main_thread_op_info = (char*)"";
 	/*buffer poolҳˢ*/
 	srv_main_thread_op_info = (char*)"flushing buffer pool pages";
-	n_pages_flushed = buf_flush_batch(BUF_FLUSH_LIST, 10, ut_dulint_max);
+	n_pages_flushed = buf_flush_list(SRV_PCT_IO(5), ut_dulint_max);
 
 	/*ÿ10뽨һcheckpoint*/
 	srv_main_thread_op_info = (char*)"making checkpoint";
@@ -1529,7 +1757,7 @@ background_loop:
 
 	/*flush buffer pool*/
 	srv_main_thread_op_info = (char*)"flushing buffer pool pages";
-	n_pages_flushed = buf_flush_batch(BUF_FLUSH_LIST, 100, ut_dulint_max);
+	n_pages_flushed = buf_flush_list(SRV_PCT_IO(50), ut_dulint_max);
 	srv_main_thread_op_info = (char*)"reserving kernel mutex";
 
 	mutex_enter(&kernel_mutex);
@@ -1540,7 +1768,7 @@ background_loop:
 	mutex_exit(&kernel_mutex);
 	/*ȴpageˢ*/
 	srv_main_thread_op_info = "waiting for buffer pool flush to end";
-	buf_flush_wait_batch_end(BUF_FLUSH_LIST);
+	buf_flush_wait_batch_end(NULL, BUF_FLUSH_LIST);
 	/*checkpoint*/
 	srv_main_thread_op_info = (char*)"making checkpoint";
 	log_checkpoint(TRUE, FALSE);
@@ -41,6 +41,7 @@ extern ulint	srv_n_log_files;
 extern ulint	srv_log_file_size;
 extern ibool	srv_log_archive_on;
 extern ulint	srv_log_buffer_size;
+extern ibool	srv_log_parallel_copy;
 extern ulint	srv_flush_log_at_trx_commit;
 
 extern byte		srv_latin1_ordering[256];
@@ -48,6 +49,21 @@ extern byte		srv_latin1_ordering[256];
 extern ibool	srv_use_native_aio;		
 
 extern ulint	srv_pool_size;
+extern ulint	srv_buf_pool_instances;
+extern ulint	srv_adaptive_hash_index_parts;
+extern ulint	srv_lock_rec_hash_parts;
+extern ulint	srv_read_ahead_threshold;
+extern ulint	srv_recv_apply_threads;
+extern ulint	srv_checksum_algorithm;
+extern ulint	srv_n_purge_threads;
+extern ulint	srv_purge_batch_size;
+extern ulint	srv_n_rollback_segs;
+extern ulint	srv_io_capacity;
+extern ibool	srv_adaptive_flushing;
+extern ulint	srv_LRU_scan_depth;
+extern ibool	srv_conc_lock_free;
+extern ulint	srv_sort_buf_size;
+extern ulint	srv_fill_factor;
 extern ulint	srv_mem_pool_size;
 extern ulint	srv_lock_table_size;
 
@@ -150,6 +166,7 @@ extern ulint	srv_n_threads_active[];
 #define SRV_UNIX_O_DSYNC     2
 #define SRV_UNIX_LITTLESYNC  3
 #define SRV_UNIX_NOSYNC      4
+#define SRV_UNIX_O_DIRECT    5
 
 #define SRV_FORCE_IGNORE_CORRUPT	1
 #define SRV_FORCE_NO_BACKGROUND		2
@@ -23,6 +23,7 @@
 #include "trx0trx.h"
 #include "dict0boot.h"
 #include "trx0sys.h"
+#include "trx0rseg.h"
 #include "dict0crea.h"
 #include "btr0btr.h"
 #include "btr0pcur.h"
@@ -566,7 +567,7 @@ static ulint open_or_create_data_files(ibool* create_new_db, dulint* min_flushed
 /*latch߳庯latchesľ״̬*/
 static ulint test_measure_cont(void* arg)
 {
-	ulint	i, j;
+	ulint	i, j, k;
 	ulint	pcount, kcount, s_scount, s_xcount, s_mcount, lcount;
 
 	fprintf(stderr, "Starting contention measurement\n");
@@ -588,20 +589,24 @@ static ulint test_measure_cont(void* arg)
 			if (kernel_mutex.lock_word)
 				kcount++;
 
-			if (buf_pool->mutex.lock_word)
-				pcount++;
+			for (k = 0; k < buf_pool_instances; k++) {
+				if (buf_pool_from_array(k)->mutex.lock_word)
+					pcount++;
+			}
 
 			if (log_sys->mutex.lock_word)
 				lcount++;
 
-			if (btr_search_latch.reader_count)
-				s_scount++;
+			for (k = 0; k < btr_search_sys->n_parts; k++) {
+				if (rw_lock_get_reader_count(btr_search_latches + k))
+					s_scount++;
 
-			if (btr_search_latch.writer != RW_LOCK_NOT_LOCKED)
-				s_xcount++;
+				if (rw_lock_get_writer(btr_search_latches + k) != RW_LOCK_NOT_LOCKED)
+					s_xcount++;
 
-			if (btr_search_latch.mutex.lock_word)
-				s_mcount++;
+				if (rw_lock_get_waiters(btr_search_latches + k))
+					s_mcount++;
+			}
 		}
 
 		fprintf(stderr, "Mutex res. l %lu, p %lu, k %lu s x %lu s s %lu s mut %lu of %lu\n", lcount, pcount, kcount, s_xcount, s_scount, s_mcount, j);
@@ -645,6 +650,8 @@ int innobase_start_or_create_for_mysql()
 		srv_unix_file_flush_method = SRV_UNIX_LITTLESYNC;
 	else if (0 == ut_strcmp(srv_unix_file_flush_method_str, "nosync"))
 		srv_unix_file_flush_method = SRV_UNIX_NOSYNC;
+	else if (0 == ut_strcmp(srv_unix_file_flush_method_str, "O_DIRECT"))
+		srv_unix_file_flush_method = SRV_UNIX_O_DIRECT;
 	else{
 		fprintf(stderr, "InnoDB: Unrecognized value %s for innodb_flush_method\n", srv_unix_file_flush_method_str);
 		return(DB_ERROR);
@@ -660,12 +667,12 @@ int innobase_start_or_create_for_mysql()
 	if(srv_n_file_io_threads > SRV_MAX_N_IO_THREADS)
 		srv_n_file_io_threads = SRV_MAX_N_IO_THREADS;
 
-	/*4߳ģ첽IO*/
+	/*4̴߳첽IO,ûlinux native aioʱֻģaio*/
+#if !defined(LINUX_NATIVE_AIO)
 	os_aio_use_native_aio = FALSE;
+#endif
 	srv_n_file_io_threads = 4;
 
-	os_aio_use_native_aio = FALSE;
-
 	/*ʼAIOģ*/
 	if (!os_aio_use_native_aio) /*ģAIOsegmentϵͳAIO8*/
 		os_aio_init(8 * SRV_N_PENDING_IOS_PER_THREAD * srv_n_file_io_threads, srv_n_file_io_threads, SRV_MAX_N_PENDING_SYNC_IOS);
@@ -676,7 +683,7 @@ int innobase_start_or_create_for_mysql()
 	fil_init(SRV_MAX_N_OPEN_FILES);
 
 	/*ʼbuffer pool*/
-	buf_pool_init(srv_pool_size, srv_pool_size);
+	buf_pool_init(srv_pool_size, srv_pool_size, srv_buf_pool_instances);
 	/*ʼռ*/
 	fsp_init();
 	/*ʼredo log*/
@@ -826,6 +833,9 @@ int innobase_start_or_create_for_mysql()
 		mtr_commit(&mtr);
 	}
 
+	/*rollback segment,ɢrseg->mutexľ*/
+	trx_rseg_create_rsegs(srv_n_rollback_segs);
+
 	if(recv_needed_recovery){
 		ut_print_timestamp(stderr);
 		fprintf(stderr, " InnoDB: Flushing modified pages from the buffer pool...\n");
@@ -852,6 +862,10 @@ int innobase_start_or_create_for_mysql()
 	if(srv_measure_contention){
 		/* os_thread_create(&test_measure_cont, NULL, thread_ids + SRV_MAX_N_IO_THREADS); */
 	}
+#ifdef UNIV_LOG_DEBUG
+	/*Աlog block checksum㷨ĺʱ*/
+	/* log_block_checksum_measure(100); */
+#endif
 	/*lockʱ߳*/
 	os_thread_create(&srv_lock_timeout_and_monitor_thread, NULL, thread_ids + 2 + SRV_MAX_N_IO_THREADS);	
 	/*߳*/
@@ -869,6 +883,10 @@ int innobase_start_or_create_for_mysql()
 	if (err != DB_SUCCESS)
 		return((int)DB_ERROR);
 
+	/*page cleaner߳,LRUβflush listĺ̨ˢ*/
+	buf_flush_page_cleaner_event = os_event_create(NULL);
+	os_thread_create(&buf_flush_page_cleaner_thread, NULL, thread_ids + 4 + SRV_MAX_N_IO_THREADS);
+
 	/*master߳*/
 	os_thread_create(&srv_master_thread, NULL, thread_ids + 1 + SRV_MAX_N_IO_THREADS);
 
@@ -22,6 +22,7 @@ int				innobase_shutdown_for_mysql();
 
 extern	ibool	srv_startup_is_before_trx_rollback_phase;
 extern	ibool	srv_is_being_shut_down;
+extern	ulint	srv_shutdown_state;
 
 #endif
 
@@ -8,7 +8,7 @@ struct sync_cell_struct
 	void*			wait_object;
 	
 	mutex_t*		old_wait_mutex;
-	rw_lock_t*		old_wait_lock;
+	rw_lock_t*		old_wait_rw_lock;
 	
 	ulint			request_type;		/*lock type*/
 	
@@ -19,7 +19,7 @@ struct sync_cell_struct
 	ibool			waiting;			/*thread*/
 
 	ibool			event_set;			
-	os_event_t		evet;				/*cellź*/
+	os_event_t		event;				/*cellź*/
 	time_t			reservation_time;
 };
 
@@ -103,7 +103,7 @@ sync_array_t* sync_array_create(ulint n_cells, ulint protection)
 	for(i = 0; i < n_cells; i++){ 
 		cell = sync_array_get_nth_cell(arr, i);
 		cell->wait_object = NULL;
-		cell->event_ = os_event_create(NULL);
+		cell->event = os_event_create(NULL);
 		cell->event_set = FALSE;
 	}
 
@@ -266,10 +266,12 @@ static void sync_array_cell_print(char* buf, sync_cell_t* cell)
 		"Last time reserved in file %s line %lu, waiters flag %lu\n",
 			mutex->file_name, mutex->line, mutex->waiters);
 
-	} else if (type == RW_LOCK_EX || type == RW_LOCK_SHARED) {
+	} else if (type == RW_LOCK_EX || type == RW_LOCK_WAIT_EX || type == RW_LOCK_SHARED) {
 
 		if (type == RW_LOCK_EX) {
 			buf += sprintf(buf, "X-lock on");
+		} else if (type == RW_LOCK_WAIT_EX) {
+			buf += sprintf(buf, "X-lock (wait_ex) on");
 		} else {
 			buf += sprintf(buf, "S-lock on");
 		}
@@ -279,11 +281,11 @@ static void sync_array_cell_print(char* buf, sync_cell_t* cell)
 		buf += sprintf(buf,
 			" RW-latch at %lx created in file %s line %lu\n",
 			(ulint)rwlock, rwlock->cfile_name, rwlock->cline);
-		if (rwlock->writer != RW_LOCK_NOT_LOCKED) {
+		if (rw_lock_get_writer(rwlock) != RW_LOCK_NOT_LOCKED) {
 			buf += sprintf(buf,
 			"a writer (thread id %lu) has reserved it in mode",
 				os_thread_pf(rwlock->writer_thread));
-			if (rwlock->writer == RW_LOCK_EX) {
+			if (rw_lock_get_writer(rwlock) == RW_LOCK_EX) {
 				buf += sprintf(buf, " exclusive\n");
 			} else {
 				buf += sprintf(buf, " wait exclusive\n");
@@ -291,8 +293,8 @@ static void sync_array_cell_print(char* buf, sync_cell_t* cell)
 		}
 		
 		buf += sprintf(buf,
-				"number of readers %lu, waiters flag %lu\n",
-				rwlock->reader_count, rwlock->waiters);
+				"number of readers %lu, waiters flag %lu, lock_word: %lx\n",
+				rw_lock_get_reader_count(rwlock), rwlock->waiters, (ulint)rwlock->lock_word);
 	
 		buf += sprintf(buf,
 				"Last time read locked in file %s line %lu\n",
@@ -471,11 +473,17 @@ static ibool sync_arr_cell_can_wake_up(sync_cell_t* cell)
 		if(rw_lock_get_writer(lock) == RW_LOCK_NOT_LOCKED)
 			return TRUE;
 	}
+	else if(cell->request_type == RW_LOCK_WAIT_EX){
+		lock = cell->wait_object;
+		/*S-latchȫͷţRW_LOCK_WAIT_EXwriterԻx-latch*/
+		if(rw_lock_get_reader_count(lock) == 0)
+			return TRUE;
+	}
 
 	return FALSE;
 }
 /*ͷһarray cellԪ,Զͷsync_array_wait_eventźţcellʹõʱ򣬻reset_event*/
-static ibool sync_array_free_cell(sync_array_t* arr, ulint index)
+void sync_array_free_cell(sync_array_t* arr, ulint index)
 {
 	sync_cell_t* cell;
 	sync_array_enter(arr);
@@ -505,6 +513,7 @@ void sync_array_signal_object(sync_array_t* arr, void* object)
 	while(count < arr->n_reserved){ /*ռõcell,ͳһsignal*/
 		cell = sync_array_get_nth_cell(arr, i);
 		if(cell->wait_object != NULL){
+			count ++;
 			if(cell->wait_object == object)
 				sync_cell_event_set(cell);
 		}
@@ -30,29 +30,52 @@ UNIV_INLINE ulint rw_lock_get_waiters(rw_lock_t* lock)
 	return (lock->waiters);
 }
 
-UNIV_INLINE void rw_lock_set_waiters(rw_lock_t* lock, ulint flag)
+/*߳ڵȴlatch,sync_array_reserve_cell֮ٴγԻlatch֮ǰ*/
+UNIV_INLINE void rw_lock_set_waiter_flag(rw_lock_t* lock)
 {
-	lock->waiters = flag;
+#ifdef HAVE_ATOMIC_BUILTINS
+	os_compare_and_swap_ulint(&(lock->waiters), 0, 1);
+#else
+	lock->waiters = 1;
+#endif
 }
 
-UNIV_INLINE ulint rw_lock_get_writer(rw_lock_t* lock)
+/*waitersʶ,޸lock_word֮*/
+UNIV_INLINE void rw_lock_reset_waiter_flag(rw_lock_t* lock)
 {
-	return lock->writer;
+#ifdef HAVE_ATOMIC_BUILTINS
+	os_compare_and_swap_ulint(&(lock->waiters), 1, 0);
+#else
+	lock->waiters = 0;
+#endif
 }
 
-UNIV_INLINE void rw_lock_set_writer(rw_lock_t* lock, ulint flag)
+/*ͨlock_wordwriter״̬*/
+UNIV_INLINE ulint rw_lock_get_writer(rw_lock_t* lock)
 {
-	lock->writer = flag;
+	lint lock_word = lock->lock_word;
+
+	if(lock_word > 0) /*лֻS-latch*/
+		return RW_LOCK_NOT_LOCKED;
+	else if(lock_word == 0 || lock_word <= -X_LOCK_DECR) /*x-latchߵݹx-latch*/
+		return RW_LOCK_EX;
+	else{ /*S-latchδͷţwriterڵȴ*/
+		ut_ad(lock_word > -X_LOCK_DECR);
+		return RW_LOCK_WAIT_EX;
+	}
 }
 
+/*ͨlock_wordS-latchĸ*/
 UNIV_INLINE ulint rw_lock_get_reader_count(rw_lock_t* lock)
 {
-	return lock->reader_count;
-}
+	lint lock_word = lock->lock_word;
 
-UNIV_INLINE void rw_lock_set_reader_count(rw_lock_t* lock, ulint count)
-{
-	lock->reader_count = count;
+	if(lock_word > 0) /*ûwriter*/
+		return (ulint)(X_LOCK_DECR - lock_word);
+	else if(lock_word < 0 && lock_word > -X_LOCK_DECR) /*writerRW_LOCK_WAIT_EX*/
+		return (ulint)(-lock_word);
+
+	return 0;
 }
 
 UNIV_INLINE mutex_t* rw_lock_get_mutex(rw_lock_t* lock)
@@ -60,35 +83,102 @@ UNIV_INLINE mutex_t* rw_lock_get_mutex(rw_lock_t* lock)
 	return &(lock->mutex);
 }
 
+/*ͬһ߳X-latch lock*/
 UNIV_INLINE ulint rw_lock_get_x_lock_count(rw_lock_t* lock)
 {
-	return lock->writer_count;
+	lint lock_copy = lock->lock_word;
+
+	if(lock_copy != 0 && lock_copy > -X_LOCK_DECR)
+		return 0;
+
+	return (lock_copy == 0) ? 1 : (ulint)(2 - (lock_copy + X_LOCK_DECR) / X_LOCK_DECR);
 }
 
-UNIV_INLINE ibool rw_lock_s_lock_low(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
+/*lock_word > 0,lock_wordȥamountTRUE,򷵻FALSES-latchamount = 1, X-latchamount = X_LOCK_DECR*/
+UNIV_INLINE ibool rw_lock_lock_word_decr(rw_lock_t* lock, ulint amount)
 {
-	ut_ad(mutex_own(rw_get_mutex(lock)));
+#ifdef HAVE_ATOMIC_BUILTINS
+	lint local_lock_word = lock->lock_word;
 
-	if(lock->writer == RW_LOCK_NOT_LOCKED){
-		lock->reader_count ++;
-#ifdef UNIV_SYNC_DEBUG /*жǷ*/
-		rw_lock_add_debug_info(lock, pass, RW_LOCK_SHARED, file_name, line);
-#endif
-		lock->last_s_file_name = file_name;
-		lock->last_s_line = line;
-		return TRUE;
+	while(local_lock_word > 0){
+		if(os_compare_and_swap_lint(&(lock->lock_word), local_lock_word, local_lock_word - (lint)amount))
+			return TRUE;
+
+		local_lock_word = lock->lock_word;
 	}
 
 	return FALSE;
+#else
+	ibool success = FALSE;
+
+	mutex_enter(rw_lock_get_mutex(lock));
+	if(lock->lock_word > 0){
+		lock->lock_word -= amount;
+		success = TRUE;
+	}
+	mutex_exit(rw_lock_get_mutex(lock));
+
+	return success;
+#endif
+}
+
+/*lock_wordamountؼֵ֮*/
+UNIV_INLINE lint rw_lock_lock_word_incr(rw_lock_t* lock, ulint amount)
+{
+#ifdef HAVE_ATOMIC_BUILTINS
+	return os_atomic_increment_lint(&(lock->lock_word), (lint)amount);
+#else
+	lint local_lock_word;
+
+	mutex_enter(rw_lock_get_mutex(lock));
+	lock->lock_word += amount;
+	local_lock_word = lock->lock_word;
+	mutex_exit(rw_lock_get_mutex(lock));
+
+	return local_lock_word;
+#endif
+}
+
+/*x-latch̹߳recursive = TRUEʾ߳̿Եݹx-latchwriter_threadrecursive֮ǰɼ*/
+UNIV_INLINE void rw_lock_set_writer_id_and_recursion_flag(rw_lock_t* lock, ibool recursive)
+{
+	os_thread_id_t curr_thread = os_thread_get_curr_id();
+
+#ifdef HAVE_ATOMIC_BUILTINS
+	os_thread_id_t local_thread = lock->writer_thread;
+	/*CASmemory barrier֤writer_threadrecursiveд*/
+	if(!os_compare_and_swap_thread_id(&(lock->writer_thread), local_thread, curr_thread))
+		lock->writer_thread = curr_thread;
+	lock->recursive = recursive;
+#else
+	mutex_enter(rw_lock_get_mutex(lock));
+	lock->writer_thread = curr_thread;
+	lock->recursive = recursive;
+	mutex_exit(rw_lock_get_mutex(lock));
+#endif
 }
 
+UNIV_INLINE ibool rw_lock_s_lock_low(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
+{
+	/*writerռûߵȴܻS-latch*/
+	if(!rw_lock_lock_word_decr(lock, 1))
+		return FALSE;
+
+#ifdef UNIV_SYNC_DEBUG /*жǷ*/
+	rw_lock_add_debug_info(lock, pass, RW_LOCK_SHARED, file_name, line);
+#endif
+	lock->last_s_file_name = file_name;
+	lock->last_s_line = line;
+
+	return TRUE;
+}
 
+/*ȷûֱ߳̾ӻS-latch*/
 UNIV_INLINE void rw_lock_s_lock_direct(rw_lock_t* lock, char* file_name, ulint line)
 {
-	ut_ad(lock->writer == RW_LOCK_NOT_LOCKED);
-	ut_ad(rw_lock_get_reader_count(lock) == 0);
+	ut_ad(lock->lock_word == X_LOCK_DECR);
 
-	lock->reader_count ++;
+	lock->lock_word --;
 	lock->last_s_file_name = file_name;
 	lock->last_s_line = line;
 
@@ -100,12 +190,11 @@ UNIV_INLINE void rw_lock_s_lock_direct(rw_lock_t* lock, char* file_name, ulint l
 UNIV_INLINE void rw_lock_x_lock_direct(rw_lock_t* lock, char* file_name, ulint line)
 {
 	ut_ad(rw_lock_validate(lock));
-	ut_ad(rw_lock_get_reader_count(lock) == 0);
-	ut_ad(lock->writer == RW_LOCK_NOT_LOCKED);
+	ut_ad(lock->lock_word == X_LOCK_DECR);
 
-	rw_lock_set_writer(lock, RW_LOCK_EX);
+	lock->lock_word -= X_LOCK_DECR;
 	lock->writer_thread = os_thread_get_curr_id();
-	lock->writer_count ++;
+	lock->recursive = TRUE;
 	lock->pass = 0;
 
 	lock->last_x_file_name = file_name;
@@ -118,14 +207,11 @@ UNIV_INLINE void rw_lock_x_lock_direct(rw_lock_t* lock, char* file_name, ulint l
 
 UNIV_INLINE void rw_lock_s_lock_func(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
 {
+#ifdef UNIV_SYNC_DEBUG
 	ut_ad(!rw_lock_own(lock, RW_LOCK_SHARED));
+#endif
 
-	mutex_enter(rw_lock_get_mutex(lock));
-	if(rw_lock_s_lock_low(lock, pass, file_name, line)){
-		mutex_exit(rw_lock_get_mutex(lock));
-	}
-	else{
-		mutex_exit(rw_lock_get_mutex(lock));
+	if(!rw_lock_s_lock_low(lock, pass, file_name, line)){
 		/*ռ*/
 		rw_lock_s_lock_spin(lock, pass, file_name, line);
 	}
@@ -133,69 +219,60 @@ UNIV_INLINE void rw_lock_s_lock_func(rw_lock_t* lock, ulint pass, char* file_nam
 
 UNIV_INLINE ibool rw_lock_s_lock_func_nowait(rw_lock_t* lock, char* file_name, ulint line)
 {
-	ibool success = FALSE;
-
-	mutex_enter(rw_lock_get_mutex(lock));
-	if(lock->writer == RW_LOCK_NOT_LOCKED){
-		lock->reader_count ++;
-#ifdef UNIV_SYNC_DEBUG
-		rw_lock_add_debug_info(lock, 0, RW_LOCK_SHARED, file_name, line);
-#endif
-		lock->last_s_file_name = file_name;
-		lock->last_s_line = line;
-		success = TRUE;
-	}
-
-	mutex_exit(rw_lock_get_mutex(lock));
-
-	return success;
+	return rw_lock_s_lock_low(lock, 0, file_name, line);
 }
 
 UNIV_INLINE ibool rw_lock_x_lock_func_nowait(rw_lock_t* lock, char* file_name, ulint line)
 {
-	ibool success = FALSE;
+	ibool success;
+
+#ifdef HAVE_ATOMIC_BUILTINS
+	success = os_compare_and_swap_lint(&(lock->lock_word), X_LOCK_DECR, 0);
+#else
+	success = FALSE;
 	mutex_enter(rw_lock_get_mutex(lock));
-	
-	/*ûs-latchʹòҲlatchnot_locked,x-latch֧ͬһ̶߳εݹlock*/
-	if((rw_lock_get_reader_count(lock) == 0) && ((rw_lock_get_writer(lock) == RW_LOCK_NOT_LOCKED) 
-		|| ((rw_lock_get_writer(lock) == RW_LOCK_EX) && lock->pass == 0 && os_thread_eq(lock->writer_thread, os_thread_get_curr_id())))){
-			rw_lock_set_writer(lock, RW_LOCK_EX);			/*latch״̬*/
-			lock->writer_thread = os_thread_get_curr_id();	/*߳id*/
-			lock->writer_count++;							/**/
-			lock->pass = 0;
-#ifdef UNIV_SYNC_DEBUG
-			rw_lock_add_debug_info(lock, 0, RW_LOCK_EX, file_name, line);
+	if(lock->lock_word == X_LOCK_DECR){
+		lock->lock_word = 0;
+		success = TRUE;
+	}
+	mutex_exit(rw_lock_get_mutex(lock));
 #endif
-			lock->last_x_file_name = file_name;
-			lock->last_x_line = line;
 
-			success = TRUE;
+	if(success)
+		rw_lock_set_writer_id_and_recursion_flag(lock, TRUE);
+	else if(lock->recursive && os_thread_eq(lock->writer_thread, os_thread_get_curr_id())){
+		/*ͬһ̵߳ݹx-latch,̳߳x-latchʱ̲߳޸lock_word*/
+		lock->lock_word -= X_LOCK_DECR;
+		ut_ad(((-lock->lock_word) % X_LOCK_DECR) == 0);
 	}
+	else
+		return FALSE;
 
-	mutex_exit(rw_lock_get_mutex(lock));
+	lock->pass = 0;
+#ifdef UNIV_SYNC_DEBUG
+	rw_lock_add_debug_info(lock, 0, RW_LOCK_EX, file_name, line);
+#endif
+	lock->last_x_file_name = file_name;
+	lock->last_x_line = line;
 
 	ut_ad(rw_lock_validate(lock));
-	return success;
+	return TRUE;
 }
 
-UNIV_INLINE void rw_lock_s_unlock_func(rw_lock_t* lock)
+UNIV_INLINE void rw_lock_s_unlock_func(rw_lock_t* lock
+#ifdef UNIV_SYNC_DEBUG
+	, ulint pass
+#endif
+)
 {
-	mutex_t* mutex = &(lock->mutex);
-	ibool sg = FALSE;
+	ut_ad((lock->lock_word % X_LOCK_DECR) != 0);
 
-	mutex_enter(mutex);
-
-	ut_a(lock->reader_count > 0);
-	lock->reader_count --;
-
-	if (lock->waiters && (lock->reader_count == 0)) {
-		sg = TRUE;
-		rw_lock_set_waiters(lock, 0);
-	}
-	mutex_exit(mutex);
+#ifdef UNIV_SYNC_DEBUG
+	rw_lock_remove_debug_info(lock, pass, RW_LOCK_SHARED);
+#endif
 
-	/*һҪ˳mutexźţռʱ*/
-	if(sg)
+	/*һS-latchͷţwriterRW_LOCK_WAIT_EX,*/
+	if(rw_lock_lock_word_incr(lock, 1) == 0)
 		sync_array_signal_object(sync_primary_wait_array, lock);
 
 	ut_ad(rw_lock_validate(lock));
@@ -206,8 +283,8 @@ UNIV_INLINE void rw_lock_s_unlock_func(rw_lock_t* lock)
 
 UNIV_INLINE void rw_lock_s_unlock_direct(rw_lock_t* lock)
 {
-	ut_ad(lock->reader_count > 0);
-	lock->reader_count --;
+	ut_ad(lock->lock_word < X_LOCK_DECR);
+	lock->lock_word ++;
 
 #ifdef UNIV_SYNC_DEBUG
 	rw_lock_remove_debug_info(lock, 0, RW_LOCK_SHARED);
@@ -220,32 +297,27 @@ UNIV_INLINE void rw_lock_s_unlock_direct(rw_lock_t* lock)
 #endif
 }
 
-UNIV_INLINE void rw_lock_x_unlock_func(rw_lock_t* lock,
+UNIV_INLINE void rw_lock_x_unlock_func(rw_lock_t* lock
 #ifdef UNIV_SYNC_DEBUG
-	ulint pass
+	, ulint pass
 #endif
 )
 {
-	ibool sg = FALSE;
-	mutex_enter(rw_lock_get_mutex(lock));
+	ut_ad((lock->lock_word % X_LOCK_DECR) == 0);
 
-	ut_ad(lock->writer_count > 0);
-	lock->writer_count --;
-	
-	if(lock->writer_count == 0)
-		rw_lock_set_writer(lock, RW_LOCK_NOT_LOCKED);
+	/*һx-latchͷţwriter_threadʧЧ*/
+	if(lock->lock_word == 0)
+		lock->recursive = FALSE;
 
 #ifdef UNIV_SYNC_DEBUG
 	rw_lock_remove_debug_info(lock, pass, RW_LOCK_EX);	
 #endif
 
-	if(lock->waiters> 0 && lock->writer == 0){
-		sg = TRUE;
-		rw_lock_set_waiters(lock, 0);
-	}
-
-	if(sg)
+	/*latchɿУеȴ̣߳*/
+	if(rw_lock_lock_word_incr(lock, X_LOCK_DECR) == X_LOCK_DECR && lock->waiters){
+		rw_lock_reset_waiter_flag(lock);
 		sync_array_signal_object(sync_primary_wait_array, lock);
+	}
 
 	ut_ad(rw_lock_validate(lock));
 #ifdef UNIV_SYNC_PERF_STAT
@@ -253,18 +325,19 @@ UNIV_INLINE void rw_lock_x_unlock_func(rw_lock_t* lock,
 #endif
 }
 
-UNIV_INLINE void rw_lock_s_unlock_direct(rw_lock_t* lock)
+UNIV_INLINE void rw_lock_x_unlock_direct(rw_lock_t* lock)
 {
-	ut_ad(lock->writer_count > 0);
-	lock->writer_count --;
+	ut_ad((lock->lock_word % X_LOCK_DECR) == 0);
 
-	if(lock->writer_count == 0)
-		rw_lock_set_writer(lock, RW_LOCK_NOT_LOCKED);
+	if(lock->lock_word == 0)
+		lock->recursive = FALSE;
 
 #ifdef UNIV_SYNC_DEBUG
 	rw_lock_remove_debug_info(lock, 0, RW_LOCK_EX);
 #endif
 
+	lock->lock_word += X_LOCK_DECR;
+
 	ut_ad(!lock->waiters);
 	ut_ad(rw_lock_validate(lock));
 
@@ -283,21 +356,21 @@ static void rw_lock_debug_free(rw_lock_debug_t* info)
 	mem_free(info);
 }
 
+
 void rw_lock_create_func(rw_lock_t* lock, char* cfile_name, ulint cline)
 {
-	/*mutex*/
+	/*mutex,ûԭӲƽ̨lock_word*/
 	mutex_create(rw_lock_get_mutex(lock));
 	mutex_set_level(rw_lock_get_mutex(lock), SYNC_NO_ORDER_CHECK);
 
 	lock->mutex.cfile_name = cfile_name;
 	lock->mutex.cline = cline;
 
-	rw_lock_set_waiters(lock, 0);
-	rw_lock_set_writer(lock, RW_LOCK_NOT_LOCKED);
-	lock->writer_count = 0;
-	rw_lock_set_reader_count(lock, 0);
+	lock->lock_word = X_LOCK_DECR;
+	lock->waiters = 0;
+	lock->recursive = FALSE;
+	lock->pass = 0;
 
-	lock->writer_is_wait_ex = FALSE;
 	UT_LIST_INIT(lock->debug_list);
 
 	lock->magic_n = RW_LOCK_MAGIC_N;
@@ -318,9 +391,8 @@ void rw_lock_create_func(rw_lock_t* lock, char* cfile_name, ulint cline)
 void rw_lock_free(rw_lock_t* lock)
 {
 	ut_ad(rw_lock_validate(lock));
-	ut_a(rw_lock_get_writer(lock) == RW_LOCK_NOT_LOCKED);
+	ut_a(lock->lock_word == X_LOCK_DECR);
 	ut_a(rw_lock_get_waiters(lock) == 0);
-	ut_a(rw_lock_get_reader_count(lock) == 0);
 	
 	lock->magic_n = 0;
 	mutex_free(rw_lock_get_mutex(lock));
@@ -333,24 +405,17 @@ void rw_lock_free(rw_lock_t* lock)
 /*ڵʹ*/
 ibool rw_lock_validate(rw_lock_t* lock)
 {
+	ulint	waiters;
+	lint	lock_word;
+
 	ut_a(lock);
 
-	mutex_enter(rw_lock_get_mutex(lock));
+	waiters = rw_lock_get_waiters(lock);
+	lock_word = lock->lock_word;
 
 	ut_a(lock->magic_n == RW_LOCK_MAGIC_N);
-	ut_a((rw_lock_get_reader_count(lock) == 0)
-		|| (rw_lock_get_writer(lock) != RW_LOCK_EX));
-
-	ut_a((rw_lock_get_writer(lock) == RW_LOCK_EX)
-		|| (rw_lock_get_writer(lock) == RW_LOCK_WAIT_EX)
-		|| (rw_lock_get_writer(lock) == RW_LOCK_NOT_LOCKED));
-
-	ut_a((rw_lock_get_waiters(lock) == 0)
-		|| (rw_lock_get_waiters(lock) == 1));
-
-	ut_a((lock->writer != RW_LOCK_EX) || (lock->writer_count > 0));
-
-	mutex_exit(rw_lock_get_mutex(lock));
+	ut_a(waiters == 0 || waiters == 1);
+	ut_a(lock_word > -X_LOCK_DECR || (-lock_word) % X_LOCK_DECR == 0);
 
 	return TRUE;
 }
@@ -366,7 +431,7 @@ lock_loop:
 	rw_s_spin_wait_count ++;
 	i = 0;
 	/**/
-	while(rw_lock_get_writer(lock) != RW_LOCK_NOT_LOCKED && i < SYNC_SPIN_ROUNDS){
+	while(lock->lock_word <= 0 && i < SYNC_SPIN_ROUNDS){
 		if(srv_spin_wait_delay)
 			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
 		i ++;
@@ -380,172 +445,171 @@ lock_loop:
 			lock->cfile_name, lock->cline, i);
 	}
 
-	mutex_enter(rw_lock_get_mutex(lock));
 	/*Ի*/
-	if(rw_lock_s_lock_low(lock, pass, file_name, line)){ /*ɹ*/
-		mutex_exit(rw_lock_get_mutex(lock));
+	if(rw_lock_s_lock_low(lock, pass, file_name, line)) /*ɹ*/
 		return;
-	}
-	else{ /*׼cell waiting״̬*/
-		/*sync_array_reserve_cellһϵͳ*/
-		rw_s_system_call_count ++;
-		/*һthread cell*/
-		sync_array_reserve_cell(sync_primary_wait_array, lock, RW_LOCK_SHARED, file_name, line, &index);
-		/*źŵȴ߳*/
-		rw_lock_set_waiters(lock, 1);
-		mutex_exit(rw_lock_get_mutex(lock));
-
-		if(srv_print_latch_waits){
-			printf("Thread %lu OS wait rw-s-lock at %lx cfile %s cline %lu\n",
-				os_thread_pf(os_thread_get_curr_id()), (ulint)lock,
-				lock->cfile_name, lock->cline);
-		}
 
-		rw_s_system_call_count ++;
-		rw_s_os_wait_count++;
-		/*źŵȴ״̬*/
-		sync_array_wait_event(sync_primary_wait_array, index);
+	/*׼cell waiting״̬*/
+	/*sync_array_reserve_cellһϵͳ*/
+	rw_s_system_call_count ++;
+	/*һthread cell*/
+	sync_array_reserve_cell(sync_primary_wait_array, lock, RW_LOCK_SHARED, file_name, line, &index);
+	/*źŵȴ߳*/
+	rw_lock_set_waiter_flag(lock);
+
+	/*waiters֮ٳһΣֹunlockwaiters֮ǰʧź*/
+	if(rw_lock_s_lock_low(lock, pass, file_name, line)){
+		sync_array_free_cell(sync_primary_wait_array, index);
+		return;
+	}
 
-		goto lock_loop;
+	if(srv_print_latch_waits){
+		printf("Thread %lu OS wait rw-s-lock at %lx cfile %s cline %lu\n",
+			os_thread_pf(os_thread_get_curr_id()), (ulint)lock,
+			lock->cfile_name, lock->cline);
 	}
+
+	rw_s_system_call_count ++;
+	rw_s_os_wait_count++;
+	/*źŵȴ״̬*/
+	sync_array_wait_event(sync_primary_wait_array, index);
+
+	goto lock_loop;
 }
 /*ɾx-latchԭ̹߳Լóx-latchĹ*/
 void rw_lock_x_lock_move_ownership(rw_lock_t* lock)
 {
 	ut_ad(rw_lock_is_locked(lock, RW_LOCK_EX));
-	mutex_enter(&(lock->mutex));
 	/*ԭ߳IDóԼ*/
-	lock->writer_thread = os_thread_get_curr_id();
+	rw_lock_set_writer_id_and_recursion_flag(lock, TRUE);
 	lock->pass = 0;
-	mutex_exit(&(lock->mutex));
 }
 
-UNIV_INLINE ulint rw_lock_x_lock_low(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
+/*writerѾlock_wordȥX_LOCK_DECR,ȴʣS-latchȫͷ(lock_wordص0)*/
+UNIV_INLINE void rw_lock_x_lock_wait(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
 {
-	/*һǱ̻߳mutexΪֻеmutex_enter(&(lock->mutex))Żᱻ*/
-	ut_ad(mutex_own(rw_lock_get_mutex(lock)));
+	ulint index;
+	ulint i = 0;
 
-	if (rw_lock_get_writer(lock) == RW_LOCK_NOT_LOCKED){
-		if(rw_lock_get_reader_count(lock) == 0){ /*latchûбռS-latch*/
-			rw_lock_set_waiters(lock, RW_LOCK_EX);
-			lock->writer_count ++;
-			lock->pass = pass;
-#ifdef UNIV_SYNC_DEBUG
-			rw_lock_add_debug_info(lock, pass, RW_LOCK_EX, file_name, line);
-#endif
-			lock->last_x_file_name = file_name;
-			lock->last_x_line = line;
-			return RW_LOCK_EX;
+	ut_ad(lock->lock_word <= 0);
+
+	while(lock->lock_word < 0){
+		if(srv_spin_wait_delay)
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+
+		if(i < SYNC_SPIN_ROUNDS){
+			i ++;
+			continue;
 		}
-		else{ /*״̬s-latch,óWAIT_EX*/
-			rw_lock_set_writer(lock, RW_LOCK_WAIT_EX);
-			lock->writer_thread = os_thread_get_curr_id();
-			lock->pass = pass;
-			lock->writer_is_wait_ex = TRUE;
-#ifdef  UNIV_SYNC_DEBUG
+
+		/*֮S-latchδͷţcellȴ*/
+		rw_x_system_call_count ++;
+		sync_array_reserve_cell(sync_primary_wait_array, lock, RW_LOCK_WAIT_EX, file_name, line, &index);
+		i = 0;
+
+		/*reserve cell֮ټһlock_wordֹʧһS-latchͷʱź*/
+		if(lock->lock_word < 0){
+#ifdef UNIV_SYNC_DEBUG
 			rw_lock_add_debug_info(lock, pass, RW_LOCK_WAIT_EX, file_name, line);
 #endif
-			return RW_LOCK_WAIT_EX;
-		}
-	}
-	/*writerRW_LOCK_WAIT_EX״̬writer_threadǱ̣߳ǰ津*/
-	else if((rw_lock_get_writer(lock) == RW_LOCK_WAIT_EX) && os_thread_eq(lock->writer_thread, os_thread_get_curr_id())){
-		if(rw_lock_get_reader_count(lock) == 0){ /*S-latchͷţʱԻȡx-latch*/
-			rw_lock_set_writer(lock, RW_LOCK_EX);
-			lock->writer_count ++;
-			lock->writer_is_wait_ex = FALSE;
-
+			rw_x_os_wait_count ++;
+			sync_array_wait_event(sync_primary_wait_array, index);
 #ifdef UNIV_SYNC_DEBUG
 			rw_lock_remove_debug_info(lock, pass, RW_LOCK_WAIT_EX);
-			rw_lock_add_debug_info(lock, pass, RW_LOCK_EX, file_name, line);
 #endif
-			lock->last_x_file_name = file_name;
-			lock->last_s_line = line;
-
-			return RW_LOCK_EX;
 		}
-		/*RW_LOCK_WAIT_EX״̬*/
-		return RW_LOCK_WAIT_EX;
+		else
+			sync_array_free_cell(sync_primary_wait_array, index);
+	}
+}
+
+UNIV_INLINE ibool rw_lock_x_lock_low(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
+{
+	if(rw_lock_lock_word_decr(lock, X_LOCK_DECR)){
+		/*lock_wordɹ̳߳Ϊwriter(RW_LOCK_WAIT_EX)*/
+		ut_a(!lock->recursive);
+		rw_lock_set_writer_id_and_recursion_flag(lock, pass ? FALSE : TRUE);
+		/*ȴS-latchȫͷ*/
+		rw_lock_x_lock_wait(lock, pass, file_name, line);
 	}
 	/*latchѾΪx-latchǱ߳ռ,̵ͬ߳ݹռ*/
-	else if((rw_lock_get_writer(lock) == RW_LOCK_EX && os_thread_eq(lock->writer_thread, os_thread_get_curr_id()))
-		&& (lock->pass == 0) && (pass == 0)){
-			lock->writer_count ++;
+	else if(pass == 0 && lock->recursive && os_thread_eq(lock->writer_thread, os_thread_get_curr_id())){
+		lock->lock_word -= X_LOCK_DECR;
+	}
+	else
+		return FALSE;
+
+	lock->pass = pass;
 #ifdef UNIV_SYNC_DEBUG
-			rw_lock_add_debug_info(lock, pass, RW_LOCK_EX, file_name, line);
+	rw_lock_add_debug_info(lock, pass, RW_LOCK_EX, file_name, line);
 #endif
-			lock->last_x_file_name = file_name;
-			lock->last_x_line = line;
-
-			return RW_LOCK_EX;
-	}
+	lock->last_x_file_name = file_name;
+	lock->last_x_line = line;
 
-	/*ϣʾһno lockedlatch*/
-	return RW_LOCK_NOT_LOCKED;
+	return TRUE;
 }
 
 void rw_lock_x_lock_func(rw_lock_t* lock, ulint pass, char* file_name, ulint line)
 {
 	ulint index;
-	ulint state;
 	ulint i;
 
-	ut_ad(&(lock->mutex));
+	ut_ad(rw_lock_validate(lock));
+
+	i = 0;
 
 lock_loop:
-	mutex_enter_fast(&(lock->mutex));
 	/*Ի*/
-	state = rw_lock_x_lock_low(lock, pass, file_name, line);
-	if(state == RW_LOCK_EX)/**/
+	if(rw_lock_x_lock_low(lock, pass, file_name, line))
 		return;
-	else{
-		i = 0;
-		/*ȴ*/
-		while(rw_lock_get_writer(lock) != RW_LOCK_NOT_LOCKED && i < SYNC_SPIN_ROUNDS){
-			if(srv_spin_wait_delay)
-				ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
-			i ++;
-		}
-		if(i == SYNC_SPIN_ROUNDS)
-			os_thread_yield();/*CPUʱƬ*/
-		else{
-			i = 0;
-			ut_error;
-		}
 
-		if(srv_print_latch_waits){
-			printf("Thread %lu spin wait rw-x-lock at %lx cfile %s cline %lu rnds %lu\n",
-				os_thread_pf(os_thread_get_curr_id()), (ulint)lock,
-				lock->cfile_name, lock->cline, i);
-		}
+	rw_x_spin_wait_count ++;
 
-		rw_x_spin_wait_count ++;
+	/*ȴ*/
+	while(lock->lock_word <= 0 && i < SYNC_SPIN_ROUNDS){
+		if(srv_spin_wait_delay)
+			ut_delay(ut_rnd_interval(0, srv_spin_wait_delay));
+		i ++;
+	}
 
-		/*жǷԻ*/
-		mutex_enter(rw_lock_get_mutex(lock));
-		if(state == RW_LOCK_EX){
-			mutex_exit(rw_lock_get_mutex(lock));
-			return ;
-		}
+	if(i == SYNC_SPIN_ROUNDS)
+		os_thread_yield();/*CPUʱƬ*/
+	else
+		goto lock_loop; /*latchѾУ³*/
 
-		rw_x_system_call_count ++;
-		/*뵽һthread cell׼ȴ*/
-		sync_array_reserve_cell(sync_primary_wait_array, lock, RW_LOCK_EX, file_name, line, &index);
-		rw_lock_set_waiters(lock, 1);
-		mutex_exit(rw_lock_get_mutex(lock));
-
-		if (srv_print_latch_waits) {
-			printf("Thread %lu OS wait for rw-x-lock at %lx cfile %s cline %lu\n",
-				os_thread_pf(os_thread_get_curr_id()), (ulint)lock, lock->cfile_name, lock->cline);
-		}
+	if(srv_print_latch_waits){
+		printf("Thread %lu spin wait rw-x-lock at %lx cfile %s cline %lu rnds %lu\n",
+			os_thread_pf(os_thread_get_curr_id()), (ulint)lock,
+			lock->cfile_name, lock->cline, i);
+	}
+
+	/*жǷԻ*/
+	if(rw_lock_x_lock_low(lock, pass, file_name, line))
+		return;
 
-		rw_x_system_call_count++;
-		rw_x_os_wait_count++;
-		/*thread cellźŵȴ*/
-		sync_array_wait_event(sync_primary_wait_array, index);
+	rw_x_system_call_count ++;
+	/*뵽һthread cell׼ȴ*/
+	sync_array_reserve_cell(sync_primary_wait_array, lock, RW_LOCK_EX, file_name, line, &index);
+	rw_lock_set_waiter_flag(lock);
 
-		goto lock_loop;
+	/*waiters֮ٳһΣֹʧź*/
+	if(rw_lock_x_lock_low(lock, pass, file_name, line)){
+		sync_array_free_cell(sync_primary_wait_array, index);
+		return;
 	}
+
+	if (srv_print_latch_waits) {
+		printf("Thread %lu OS wait for rw-x-lock at %lx cfile %s cline %lu\n",
+			os_thread_pf(os_thread_get_curr_id()), (ulint)lock, lock->cfile_name, lock->cline);
+	}
+
+	rw_x_system_call_count++;
+	rw_x_os_wait_count++;
+	/*thread cellźŵȴ*/
+	sync_array_wait_event(sync_primary_wait_array, index);
+
+	i = 0;
+	goto lock_loop;
 }
 
 void rw_lock_debug_mutex_enter(void)
@@ -603,7 +667,7 @@ void rw_lock_remove_debug_info(rw_lock_t* lock, ulint pass, ulint lock_type)
 	rw_lock_debug_t* info;
 
 	ut_ad(lock);
-	if(pass == 0 && lock_type != RW_LOCK_EX)
+	if(pass == 0 && lock_type != RW_LOCK_WAIT_EX)
 		sync_thread_reset_level(lock);
 
 	rw_lock_debug_mutex_enter();
@@ -634,23 +698,24 @@ ibool rw_lock_own(rw_lock_t* lock, ulint lock_type)
 	ut_ad(lock);
 	ut_ad(rw_lock_validate(lock));
 
-#ifdef UNIV_SYNC_DEBUG
+#ifndef UNIV_SYNC_DEBUG
 	ut_error;
 #endif
 
-	mutex_enter(&(lock->mutex));
+	/*debug_listrw_lock_debug_mutex*/
+	rw_lock_debug_mutex_enter();
 
 	info = UT_LIST_GET_FIRST(lock->debug_list);
 	while(info != NULL){
 		/*ҵƥlatch*/
 		if(os_thread_eq(info->thread_id, os_thread_get_curr_id()) && info->pass == 0 && info->lock_type == lock_type){
-			mutex_exit(&(lock->mutex));
+			rw_lock_debug_mutex_exit();
 			return TRUE;
 		}
 		info = UT_LIST_GET_NEXT(list, info);
 	}
 
-	mutex_exit(&(lock->mutex));
+	rw_lock_debug_mutex_exit();
 	return FALSE;
 }
 /*жrw_lockǷlock״̬УаS-latchX-latch״̬*/
@@ -660,21 +725,17 @@ ibool rw_lock_is_locked(rw_lock_t* lock, ulint lock_type)
 	ut_ad(lock);
 	ut_ad(rw_lock_validate(lock));
 
-	mutex_enter(&(lock->mutex));
-
 	if(lock_type == RW_LOCK_SHARED){
-		if(lock->reader_count > 0)
+		if(rw_lock_get_reader_count(lock) > 0)
 			ret = TRUE;
 	}
 	else if(lock_type == RW_LOCK_EX){
-		if(lock->writer == RW_LOCK_EX)
+		if(rw_lock_get_writer(lock) == RW_LOCK_EX)
 			ret = TRUE;
 	}
 	else
 		ut_error;
 
-	mutex_exit(&(lock->mutex));
-
 	return ret;
 }
 
@@ -699,7 +760,7 @@ void rw_lock_list_print_info(void)
 
 		count++;
 
-		mutex_enter(&(lock->mutex));
+		rw_lock_debug_mutex_enter();
 
 		if ((rw_lock_get_writer(lock) != RW_LOCK_NOT_LOCKED)
 			|| (rw_lock_get_reader_count(lock) != 0)
@@ -720,7 +781,7 @@ void rw_lock_list_print_info(void)
 				}
 		}
 
-		mutex_exit(&(lock->mutex));
+		rw_lock_debug_mutex_exit();
 		lock = UT_LIST_GET_NEXT(list, lock);
 	}
 
@@ -794,11 +855,9 @@ ulint rw_lock_n_locked()
 	mutex_enter(&rw_lock_list_mutex);
 	lock = UT_LIST_GET_FIRST(rw_lock_list);
 	while(lock != NULL){
-		mutex_enter(rw_lock_get_mutex(lock));
-		if((rw_lock_get_writer(lock) != RW_LOCK_NOT_LOCKED) || (rw_lock_get_reader_count(lock) != 0))
+		if(lock->lock_word != X_LOCK_DECR)
 			count ++;
 
-		mutex_exit(rw_lock_get_mutex(lock));
 		lock = UT_LIST_GET_NEXT(list, lock);
 	}
 	mutex_exit(&rw_lock_list_mutex);
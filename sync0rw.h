@@ -14,6 +14,14 @@
 
 #define	RW_LOCK_MAGIC_N	22643
 
+/*lock_wordĵλlock_word == X_LOCK_DECRʾlatch,
+  ÿS-latchlock_word1,X-latchlock_wordX_LOCK_DECR:
+  lock_word > 0						лֻS-latch
+  lock_word == 0					x-latch
+  -X_LOCK_DECR < lock_word < 0		S-latchһwriterRW_LOCK_WAIT_EX
+  lock_word <= -X_LOCK_DECR			ͬһ̵߳ݹx-latch*/
+#define X_LOCK_DECR		0x00100000
+
 typedef struct rw_lock_struct		rw_lock_t;
 typedef struct rw_lock_debug_struct rw_lock_debug_t;
 
@@ -58,7 +66,7 @@ extern	ulint			rw_x_exit_count;
 
 #define rw_lock_x_lock(M)			rw_lock_x_lock_func((M), 0, __FILE__, __LINE__)
 #define rw_lock_x_lock_gen(M, P)	rw_lock_x_lock_func((M), (P), __FILE__, __LINE__)
-#define rw_lock_x_lock_nowait(M)	rw_lock_x_lock_func_nowait_func((M), __FILE__, __LINE__)
+#define rw_lock_x_lock_nowait(M)	rw_lock_x_lock_func_nowait((M), __FILE__, __LINE__)
 
 #ifdef UNIV_SYNC_DEBUG
 #define rw_lock_x_unlock(L)			rw_lock_x_unlock_func(L, 0)
@@ -84,12 +92,16 @@ UNIV_INLINE ibool		rw_lock_s_lock_func_nowait(rw_lock_t* lock, char* file_name,
 
 UNIV_INLINE ibool		rw_lock_x_lock_func_nowait(rw_lock_t* lock, char* file_name, ulint line);
 
-UNIV_INLINE void		rw_lock_s_unlock_func(rw_lock_t* lock);
+UNIV_INLINE void		rw_lock_s_unlock_func(rw_lock_t* lock
+#ifdef UNIV_SYNC_DEBUG
+	, ulint pass
+#endif
+);
 
 void					rw_lock_x_lock_func(rw_lock_t* lock, ulint pass, char* file_name, ulint line);
-UNIV_INLINE void		rw_lock_x_unlock_func(rw_lock_t* lock, 
+UNIV_INLINE void		rw_lock_x_unlock_func(rw_lock_t* lock
 #ifdef UNIV_SYNC_DEBUG
-	ulint pass,
+	, ulint pass
 #endif
 );
 
@@ -120,7 +132,7 @@ ibool					rw_lock_is_locked(rw_lock_t* lock, ulint lock_type);
 /*ӡӿԽӿ*/
 ulint					rw_lock_n_locked();
 
-void					rw_lock_list_print_inf();
+void					rw_lock_list_print_info();
 
 void					rw_lock_debug_mutex_enter();
 
@@ -131,17 +143,13 @@ void					rw_lock_debug_print(rw_lock_debug_t* info);
 /*rw_lock_tĶ*/
 struct rw_lock_struct
 {
-	ulint				reader_count;	/*S-LATCHĶ߸,һΪ0ʾS-LATCH*/
-	ulint				writer;			/*X-LATCH״̬ҪRW_LOCK_EXRW_LOCK_WAIT_EXRW_LOCK_NOT_LOCKED
-										RW_LOCK_EXʾһx-latch,RW_LOCK_WAIT_EX״̬ʾһS-LATCH*/
-	os_thread_id_t		writer_thread;	/*X-LATCH߳IDߵһȴΪx-latch߳ID*/
-	ulint				writer_count;	/*ͬһ߳X-latch lock*/
-	
-	mutex_t				mutex;			/*rw_lockṹݵĻ*/
-	ulint				pass;			/*ĬΪ0Ƿ0ʾ߳̿ԽlatchȨתƸ̣߳insert bufferصĵ*/
+	volatile lint		lock_word;		/*latch״̬֣ͨԭӲ޸ģ߸writer״̬x-latchݹ,X_LOCK_DECR*/
+	volatile ulint		waiters;		/*ждڵȴlatch*/
+	volatile ibool		recursive;		/*writer_threadǷЧTRUEʱwriter_threadԵݹx-latch*/
+	volatile os_thread_id_t	writer_thread;	/*X-LATCH߳IDߵһȴΪx-latch߳ID*/
 
-	ulint				waiters;		/*ждڵȴlatch*/
-	ibool				writer_is_wait_ex;
+	mutex_t				mutex;			/*ûԭӲʱlock_wordĻ*/
+	ulint				pass;			/*ĬΪ0Ƿ0ʾ߳̿ԽlatchȨתƸ̣߳insert bufferصĵ*/
 
 	UT_LIST_NODE_T(rw_lock_t) list;
 	UT_LIST_BASE_NODE_T(rw_lock_debug_t) debug_list;
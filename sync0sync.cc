@@ -578,6 +578,22 @@ static ibool sync_thread_levels_contain(sync_level_t* arr, ulint level)
 	return FALSE;
 }
 
+/*̳߳еSYNC_SEARCH_SYS latchĵַǷСlatchӦhashķlatchSYNC_SEARCH_SYS,
+btr_search_x_lock_all(Ҳbtr_search_latchesеĵַ)˳,˳򲻻*/
+static ibool sync_thread_levels_search_ordered(sync_level_t* arr, void* latch)
+{
+	sync_level_t*	slot;
+	ulint			i;
+
+	for(i = 0; i < SYNC_THREAD_N_LEVELS; i ++){
+		slot = sync_thread_levels_get_nth(arr, i);
+		if(slot->latch != NULL && slot->level == SYNC_SEARCH_SYS && (byte*)(slot->latch) >= (byte*)latch)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
 ibool sync_thread_levels_empty_gen(ibool dict_mutex_allowed)
 {
 	sync_level_t*	arr;
@@ -688,7 +704,11 @@ void sync_thread_add_level(void* latch, ulint level)
 	} else if (level == SYNC_BUF_POOL) {
 		ut_a(sync_thread_levels_g(array, SYNC_BUF_POOL));
 	} else if (level == SYNC_SEARCH_SYS) {
-		ut_a(sync_thread_levels_g(array, SYNC_SEARCH_SYS));
+		/*ͬһlevelķlatchַֻ˳*/
+		ut_a((sync_thread_levels_contain(array, SYNC_SEARCH_SYS)
+			&& sync_thread_levels_g(array, SYNC_SEARCH_SYS - 1)
+			&& sync_thread_levels_search_ordered(array, latch))
+			|| sync_thread_levels_g(array, SYNC_SEARCH_SYS));
 	} else if (level == SYNC_TRX_LOCK_HEAP) {
 		ut_a(sync_thread_levels_g(array, SYNC_TRX_LOCK_HEAP));
 	} else if (level == SYNC_REC_LOCK) {
@@ -12,10 +12,15 @@
 #include "trx0rec.h"
 #include "srv0que.h"
 #include "os0thread.h"
+#include "srv0srv.h"
+#include "ut0wqueue.h"
 
 trx_purge_t*	purge_sys = NULL;
 trx_undo_rec_t  trx_purge_dummy_rec;
 
+/*purge worker̵߳id*/
+static os_thread_id_t	trx_purge_worker_ids[TRX_PURGE_MAX_THREADS];
+
 /*trx_idӦǷϵͳУڣTRUE򷵻FALSE*/
 ibool trx_purge_update_undo_must_exist(dulint trx_id)
 {
@@ -80,10 +85,10 @@ static void trx_purge_arr_get_biggest(trx_undo_arr_t* arr, dulint* trx_no, dulin
 
 	for(i = 0; ; i++){
 		cell = trx_undo_arr_get_nth_info(arr, i);
-		if(cell->is_use){
+		if(cell->in_use){
 			n ++;
 			trx_cmp = ut_dulint_cmp(cell->trx_no, pair_trx_no);
-			if(trx_cmp > 0 ||(trx_cmp == 0 && ut_dulint_cmp(cell->trx_no, pair_trx_no) >= 0)){
+			if(trx_cmp > 0 ||(trx_cmp == 0 && ut_dulint_cmp(cell->undo_no, pair_undo_no) >= 0)){
 				pair_trx_no = cell->trx_no;
 				pair_undo_no = cell->undo_no;
 			}
@@ -98,26 +103,108 @@ static void trx_purge_arr_get_biggest(trx_undo_arr_t* arr, dulint* trx_no, dulin
 	}
 }
 
-/*һquery graph,query graphִpurge*/
+/*һquery graph,ÿpurge̶߳Ӧһque thrpurge node*/
 static que_t* trx_purge_graph_build()
 {
-	mem_heap_t*	heap;
-	que_fork_t*	fork;
-	que_thr_t*	thr;
+	mem_heap_t*		heap;
+	que_fork_t*		fork;
+	que_thr_t*		thr;
+	purge_node_t*	node;
+	ulint			i;
 
 	heap = mem_heap_create(512);
 	fork = que_fork_create(NULL, NULL, QUE_FORK_PURGE, heap);
 	fork->trx = purge_sys->trx;
 
-	thr = que_thr_create(fork, heap);
+	purge_sys->thrs = mem_heap_alloc(heap, purge_sys->n_threads * sizeof(que_thr_t*));
+	for(i = 0; i < purge_sys->n_threads; i++){
+		thr = que_thr_create(fork, heap);
+
+		node = row_purge_node_create(thr, heap);
+		node->recs = mem_heap_alloc(heap, purge_sys->batch_size * sizeof(trx_purge_rec_t));
+		thr->child = node;
+
+		purge_sys->thrs[i] = thr;
+	}
 
 	return fork;
 }
 
+/*ib_bhıȽϺ,trx_noС*/
+static int trx_purge_rseg_cmp(const void* p1, const void* p2)
+{
+	return ut_dulint_cmp(((const trx_purge_rseg_t*)p1)->trx_no, ((const trx_purge_rseg_t*)p2)->trx_no);
+}
+
+/*rsegµδpurgeundo log,purge_sys->ib_bh*/
+static void trx_purge_rseg_push(trx_rseg_t* rseg)
+{
+	trx_purge_rseg_t	elem;
+	void*				ptr;
+
+	ut_ad(mutex_own(&(rseg->mutex)));
+	ut_ad(rseg->last_page_no != FIL_NULL);
+
+	elem.trx_no = rseg->last_trx_no;
+	elem.rseg = rseg;
+
+	mutex_enter(&(purge_sys->bh_mutex));
+	ptr = ib_bh_push(purge_sys->ib_bh, &elem);
+	ut_a(ptr != NULL);
+	mutex_exit(&(purge_sys->bh_mutex));
+}
+
+/*޸trx_sys->rseg_history_len,߳еֻǸrsegmutex,ͬrseg֮ҪԭӲߵmutex*/
+UNIV_INLINE void trx_purge_update_history_len(ulint n, ibool inc)
+{
+#ifdef HAVE_ATOMIC_BUILTINS
+	if(inc)
+		os_atomic_increment_ulint(&(trx_sys->rseg_history_len), n);
+	else
+		os_atomic_decrement_ulint(&(trx_sys->rseg_history_len), n);
+#else
+	mutex_enter(&(trx_sys->rseg_history_mutex));
+	if(inc)
+		trx_sys->rseg_history_len += n;
+	else
+		trx_sys->rseg_history_len -= n;
+	mutex_exit(&(trx_sys->rseg_history_mutex));
+#endif
+}
+
+/*purge worker߳,work queueȡcoordinatorque thr,ִpurge nodeϵһundo rec*/
+static void* trx_purge_worker_thread(void* arg)
+{
+	que_thr_t*	thr;
+	ulint		n_pending;
+
+	for(;;){
+		thr = ib_wqueue_wait(purge_sys->wq);
+		row_purge_batch(thr);
+
+#ifdef HAVE_ATOMIC_BUILTINS
+		n_pending = os_atomic_decrement_ulint(&(purge_sys->n_pending), 1);
+#else
+		mutex_enter(&(purge_sys->pending_mutex));
+		n_pending = -- purge_sys->n_pending;
+		mutex_exit(&(purge_sys->pending_mutex));
+#endif
+		/*һɵworkercoordinator*/
+		if(n_pending == 0)
+			os_event_set(purge_sys->batch_done);
+	}
+
+	os_thread_exit(0);
+
+	return NULL;
+}
+
 /*ȫֵpurge system*/
 void trx_purge_sys_create()
 {
 	com_endpoint_t*	com_endpoint;
+	trx_rseg_t*		rseg;
+	ulint			i;
 
 	ut_ad(mutex_own(&kernel_mutex));
 
@@ -140,6 +227,30 @@ void trx_purge_sys_create()
 	purge_sys->heap = mem_heap_create(256);
 	purge_sys->arr = trx_undo_arr_create();
 
+	purge_sys->n_threads = ut_min(ut_max(srv_n_purge_threads, 1), TRX_PURGE_MAX_THREADS);
+	purge_sys->batch_size = ut_max(srv_purge_batch_size, 1);
+	purge_sys->n_pending = 0;
+	mutex_create(&(purge_sys->pending_mutex));
+	mutex_set_level(&(purge_sys->pending_mutex), SYNC_NO_ORDER_CHECK);
+	purge_sys->batch_done = os_event_create(NULL);
+	purge_sys->batch_heap = mem_heap_create(1024);
+	purge_sys->wq = ib_wqueue_create();
+
+	/*ÿrsegib_bhֻһԪ*/
+	purge_sys->ib_bh = ib_bh_create(trx_purge_rseg_cmp, sizeof(trx_purge_rseg_t), TRX_SYS_N_RSEGS);
+	mutex_create(&(purge_sys->bh_mutex));
+	mutex_set_level(&(purge_sys->bh_mutex), SYNC_NO_ORDER_CHECK);
+
+	rseg = UT_LIST_GET_FIRST(trx_sys->rseg_list);
+	while(rseg != NULL){
+		mutex_enter(&(rseg->mutex));
+		if(rseg->last_page_no != FIL_NULL)
+			trx_purge_rseg_push(rseg);
+		mutex_exit(&(rseg->mutex));
+
+		rseg = UT_LIST_GET_NEXT(rseg_list, rseg);
+	}
+
 	com_endpoint = (com_endpoint_t*)purge_sys;
 	purge_sys->sess = sess_open(com_endpoint, (byte*)"purge_system", 13);
 	purge_sys->trx = purge_sys->sess->trx;
@@ -149,6 +260,10 @@ void trx_purge_sys_create()
 	ut_a(trx_start_low(purge_sys->trx, ULINT_UNDEFINED));
 	purge_sys->query = trx_purge_graph_build();
 	purge_sys->view = read_view_oldest_copy_or_open_new(NULL, purge_sys->heap);
+
+	/*purge worker߳,0que thrִtrx_purgecoordinatorԼ*/
+	for(i = 1; i < purge_sys->n_threads; i++)
+		os_thread_create(trx_purge_worker_thread, NULL, trx_purge_worker_ids + i);
 }
 
 /*rseg headerhistroy listupdate undo log*/
@@ -189,6 +304,7 @@ void trx_purge_add_update_undo_to_history(trx_t* trx, page_t* undo_page, mtr_t*
 	}
 	/*undo log뵽rseg headerhistory listͷ*/
 	flst_add_first(rseg_header + TRX_RSEG_HISTORY, undo_header + TRX_UNDO_HISTORY_NODE, mtr);
+	trx_purge_update_history_len(1, TRUE);
 	/*undo log headertrx_id*/
 	mlog_write_dulint(undo_header + TRX_UNDO_TRX_NO, trx->no, MLOG_8BYTES, mtr);
 
@@ -200,6 +316,8 @@ void trx_purge_add_update_undo_to_history(trx_t* trx, page_t* undo_page, mtr_t*
 		rseg->last_offset = undo->hdr_offset;
 		rseg->last_trx_no = trx->no;
 		rseg->last_del_marks = undo->del_marks;
+
+		trx_purge_rseg_push(rseg);
 	}
 }
 
@@ -246,6 +364,7 @@ loop:
 	/*rseg headerhistory listĹϵ*/
 	seg_size = flst_get_len(seg_hdr + TRX_UNDO_PAGE_LIST, &mtr);
 	flst_cut_end(rseg_hdr + TRX_RSEG_HISTORY, log_hdr + TRX_UNDO_HISTORY_NODE, n_removed_logs, &mtr);
+	trx_purge_update_history_len(n_removed_logs, FALSE);
 
 	freed = FALSE;
 	while(!freed){ /*ͷundo log segmentheader page*/
@@ -302,6 +421,7 @@ loop:
 
 	if(cmp >= 0){ /*ɾhistory listӦĽڵ,trx_undo_truncate_startĽڵ㣿*/
 		flst_truncate_end(rseg_hdr + TRX_RSEG_HISTORY, log_hdr + TRX_UNDO_HISTORY_NODE, n_removed_logs, &mtr);
+		trx_purge_update_history_len(n_removed_logs, FALSE);
 		mutex_exit(&(rseg->mutex));	
 		mtr_commit(&mtr);
 		return ;
@@ -406,7 +526,7 @@ static void trx_purge_rseg_get_next_history_log(trx_rseg_t* rseg)
 		purge_sys->n_pages_handled ++;
 
 	prev_log_addr = trx_purge_get_log_from_hist(flst_get_prev_addr(log_hdr + TRX_UNDO_HISTORY_NODE, &mtr));
-	if(prev_log_addr.page == NULL){ /*history listֻ1Ԫڵ*/
+	if(prev_log_addr.page == FIL_NULL){ /*history listֻ1Ԫڵ*/
 		rseg->last_page_no = FIL_NULL;
 		mutex_exit(&(rseg->mutex));
 		mtr_commit(&mtr);
@@ -416,6 +536,7 @@ static void trx_purge_rseg_get_next_history_log(trx_rseg_t* rseg)
 	mutex_exit(&(rseg->mutex));
 	mtr_commit(&mtr);
 
+	mtr_start(&mtr);
 	log_hdr = trx_undo_page_get_s_latched(rseg->space, prev_log_addr.page, &mtr) + prev_log_addr.boffset;
 	trx_no = mach_read_from_8(log_hdr + TRX_UNDO_TRX_NO);
 	del_marks = mach_read_from_2(log_hdr + TRX_UNDO_DEL_MARKS);
@@ -428,53 +549,53 @@ static void trx_purge_rseg_get_next_history_log(trx_rseg_t* rseg)
 	rseg->last_trx_no = trx_no;
 	rseg->last_del_marks = del_marks;
 
+	trx_purge_rseg_push(rseg);
+
 	mutex_exit(&(rseg->mutex));
 }
 
-/*ȷ´purgeʼλ*/
+/*ȷ´purgeʼλ,ib_bhȡδpurgeundo logڵrseg*/
 static void trx_purge_choose_next_log()
 {
-	trx_undo_rec_t*	rec;
-	trx_rseg_t*	rseg;
-	trx_rseg_t*	min_rseg;
-	dulint		min_trx_no;
-	ulint		space;
-	ulint		page_no;
-	ulint		offset;
-	mtr_t		mtr;
+	trx_undo_rec_t*		rec;
+	trx_purge_rseg_t*	elem;
+	trx_rseg_t*			min_rseg;
+	dulint				min_trx_no;
+	ulint				space;
+	ulint				page_no;
+	ulint				offset;
+	ibool				del_marks;
+	mtr_t				mtr;
 
 	ut_ad(mutex_own(&(purge_sys->mutex)));
 	ut_ad(purge_sys->next_stored == FALSE);
 
-	rseg = UT_LIST_GET_FIRST(trx_sys->rseg_list);
-	min_trx_no = ut_dulint_max;
-	min_rseg = NULL;
-
-	while(rseg){
-		mutex_enter(&(rseg->mutex));
+	mutex_enter(&(purge_sys->bh_mutex));
+	elem = ib_bh_first(purge_sys->ib_bh);
+	if(elem == NULL){ /*rseghistory listǿյ*/
+		mutex_exit(&(purge_sys->bh_mutex));
+		return ;
+	}
 
-		if(rseg->last_page_no != FIL_NULL){
-			if(min_rseg == NULL || (ut_dulint_cmp(min_trx_no, rseg->last_trx_no) > 0)){ /*min trxӦrsegϢ*/
-				min_rseg = rseg;
-				min_trx_no = rseg->last_trx_no;
+	min_rseg = elem->rseg;
+	min_trx_no = elem->trx_no;
+	/*rsegһundo logȷʱ(trx_purge_rseg_get_next_history_log)ᱻ·*/
+	ib_bh_pop(purge_sys->ib_bh);
+	mutex_exit(&(purge_sys->bh_mutex));
 
-				space = rseg->space;
-				ut_a(space == 0); /* We assume in purge of externally stored fields that space id == 0 */
+	mutex_enter(&(min_rseg->mutex));
+	ut_ad(min_rseg->last_page_no != FIL_NULL);
+	ut_ad(ut_dulint_cmp(min_rseg->last_trx_no, min_trx_no) == 0);
 
-				page_no = rseg->last_page_no;
-				offset = rseg->last_offset;
-			}
-		}
-
-		mutex_exit(&(rseg->mutex));
-		rseg = UT_LIST_GET_NEXT(rseg_list, rseg);
-	}
-
-	if(min_rseg == NULL)
-		return ;
+	space = min_rseg->space;
+	ut_a(space == 0); /* We assume in purge of externally stored fields that space id == 0 */
+	page_no = min_rseg->last_page_no;
+	offset = min_rseg->last_offset;
+	del_marks = min_rseg->last_del_marks;
+	mutex_exit(&(min_rseg->mutex));
 
 	mtr_start(&mtr);
-	if(!min_rseg->last_del_marks)
+	if(!del_marks)
 		rec = &trx_purge_dummy_rec;
 	else{ /*ȷmin undo log recľ*/
 		rec = trx_undo_get_first_rec(space, page_no, offset, RW_S_LATCH, &mtr);
@@ -656,14 +777,92 @@ void trx_purge_rec_release(trx_undo_inf_t* cell)
 	mutex_exit(&(purge_sys->mutex));
 }
 
-/*purage*/
+/*undo rectable idĸpurge̴߳,ͬһundo recͬһ߳а˳purge*/
+static ulint trx_purge_rec_get_thread_no(trx_undo_rec_t* undo_rec)
+{
+	ulint	type;
+	ulint	cmpl_info;
+	ibool	updated_extern;
+	dulint	undo_no;
+	dulint	table_id;
+
+	if(undo_rec == &trx_purge_dummy_rec || purge_sys->n_threads == 1)
+		return 0;
+
+	trx_undo_rec_get_pars(undo_rec, &type, &cmpl_info, &updated_extern, &undo_no, &table_id);
+
+	return ut_dulint_get_low(table_id) % purge_sys->n_threads;
+}
+
+/*coordinatorȡһundo rec,䵽purge node,purge߳ɺ󷵻رundo recĸ*/
+static ulint trx_purge_run_batch()
+{
+	purge_node_t*		node;
+	trx_purge_rec_t*	prec;
+	trx_undo_rec_t*		undo_rec;
+	trx_undo_inf_t*		cell;
+	dulint				roll_ptr;
+	ulint				n_recs;
+	ulint				n_pending;
+	ulint				i;
+
+	for(i = 0; i < purge_sys->n_threads; i++){
+		node = purge_sys->thrs[i]->child;
+		node->n_recs = 0;
+	}
+
+	for(n_recs = 0; n_recs < purge_sys->batch_size; n_recs++){
+		undo_rec = trx_purge_fetch_next_rec(&roll_ptr, &cell, purge_sys->batch_heap);
+		if(undo_rec == NULL)
+			break;
+
+		node = purge_sys->thrs[trx_purge_rec_get_thread_no(undo_rec)]->child;
+		prec = node->recs + node->n_recs;
+		prec->undo_rec = undo_rec;
+		prec->roll_ptr = roll_ptr;
+		prec->cell = cell;
+		node->n_recs ++;
+	}
+
+	n_pending = 0;
+	for(i = 1; i < purge_sys->n_threads; i++){
+		node = purge_sys->thrs[i]->child;
+		if(node->n_recs > 0)
+			n_pending ++;
+	}
+
+	/*undo recque thrworker߳*/
+	if(n_pending > 0){
+		os_event_reset(purge_sys->batch_done);
+		purge_sys->n_pending = n_pending;
+
+		for(i = 1; i < purge_sys->n_threads; i++){
+			node = purge_sys->thrs[i]->child;
+			if(node->n_recs > 0)
+				ib_wqueue_add(purge_sys->wq, purge_sys->thrs[i], purge_sys->batch_heap);
+		}
+	}
+
+	/*0nodecoordinatorԼpurge*/
+	row_purge_batch(purge_sys->thrs[0]);
+
+	if(n_pending > 0)
+		os_event_wait(purge_sys->batch_done);
+
+	ut_ad(purge_sys->n_pending == 0);
+	mem_heap_empty(purge_sys->batch_heap);
+
+	return n_recs;
+}
+
+/*purge,ÿദ20undo log page*/
 ulint trx_purge()
 {
-	que_thr_t*	thr;
 	ulint		old_pages_handled;
+	ulint		n_recs;
 
 	mutex_enter(&(purge_sys->mutex));
-	if(purge_sys->trx->n_active_thrs > 0){
+	if(purge_sys->n_pending > 0){
 		mutex_exit(&(purge_sys->mutex));
 		ut_a(0);
 		return 0;
@@ -671,7 +870,7 @@ ulint trx_purge()
 
 	rw_lock_x_lock(&(purge_sys->latch));
 
-	mutex_enter(kernel_mutex);
+	mutex_enter(&kernel_mutex);
 
 	/*رչȥpruge view*/
 	read_view_close(purge_sys->view);
@@ -688,15 +887,14 @@ ulint trx_purge()
 	old_pages_handled = purge_sys->n_pages_handled;
 
 	mutex_exit(&(purge_sys->mutex));
-	mutex_enter(&kernel_mutex);
-	/*purge*/
-	thr = que_fork_start_command(purge_sys->query, SESS_COMM_EXECUTE, 0);
-	mutex_exit(&kernel_mutex);
 
 	if(srv_print_thread_releases)
 		printf("Starting purge\n");
 
-	que_run_threads(thr);
+	/*һ˵history listпܻпpurgeundo rec*/
+	do{
+		n_recs = trx_purge_run_batch();
+	}while(n_recs == purge_sys->batch_size);
 
 	/*ӡʼpurgepage*/
 	if(srv_print_thread_releases)
@@ -706,6 +904,24 @@ ulint trx_purge()
 	return purge_sys->n_pages_handled - old_pages_handled;
 }
 
+/*Ѿ䵫ûбpurge,ڼpurgeǷ*/
+ulint trx_purge_get_lag()
+{
+	dulint	max_trx_id;
+	dulint	purge_trx_no;
+
+	max_trx_id = trx_sys->max_trx_id;
+	purge_trx_no = purge_sys->purge_trx_no;
+
+	if(ut_dulint_cmp(max_trx_id, purge_trx_no) <= 0)
+		return 0;
+
+	if(ut_dulint_get_high(max_trx_id) != ut_dulint_get_high(purge_trx_no))
+		return ULINT_MAX;
+
+	return ut_dulint_get_low(max_trx_id) - ut_dulint_get_low(purge_trx_no);
+}
+
 void trx_purge_sys_print()
 {
 	fprintf(stderr, "InnoDB: Purge system view:\n");
@@ -9,6 +9,9 @@
 #include "page0page.h"
 #include "usr0sess.h"
 #include "fil0fil.h"
+#include "os0sync.h"
+#include "ut0wqueue.h"
+#include "ut0bh.h"
 
 extern trx_purge_t*		purge_sys;
 
@@ -17,14 +20,32 @@ extern trx_undo_rec_t	trx_purge_dummy_rec;
 #define TRX_PURGE_ON			1
 #define TRX_STOP_PURGE			2
 
+/*purge߳,coordinator*/
+#define TRX_PURGE_MAX_THREADS	32
+
+/*coordinatorһpurge nodeundo rec*/
+struct trx_purge_rec_struct
+{
+	trx_undo_rec_t*	undo_rec;			/*undo recĿ,purge_sys->batch_heap*/
+	dulint			roll_ptr;
+	trx_undo_inf_t*	cell;				/*purge_sys->arrռõĲλ*/
+};
+
+/*purge_sys->ib_bhеԪ,rsegδpurgeundo logtrx_no*/
+struct trx_purge_rseg_struct
+{
+	dulint			trx_no;
+	trx_rseg_t*		rseg;
+};
+
 struct trx_purge_struct
 {
 	ulint			state;				
 	sess_t*			sess;
 	trx_t*			trx;
 	que_t*			query;
-	rw_lock_t*		purge_is_running;
-	rw_lock_t*		latch;
+	rw_lock_t		purge_is_running;
+	rw_lock_t		latch;
 	read_view_t*	view;
 	mutex_t			mutex;
 
@@ -43,6 +64,18 @@ struct trx_purge_struct
 	trx_undo_arr_t*	arr;
 
 	mem_heap_t*		heap;
+
+	ulint			n_threads;			/*purge߳,0coordinatorԼִ*/
+	ulint			batch_size;			/*ÿһȡundo rec*/
+	que_thr_t**		thrs;				/*ÿpurge߳һque thr,childǸԵpurge node*/
+	ib_wqueue_t*	wq;					/*ַpurge worker̵߳que thr*/
+	ulint			n_pending;			/*лδɵworker*/
+	mutex_t			pending_mutex;		/*ûԭӲʱn_pending*/
+	os_event_t		batch_done;			/*n_pendingΪ0ʱset*/
+	mem_heap_t*		batch_heap;			/*undo recwqڵڴ*/
+
+	ib_bh_t*		ib_bh;				/*history listΪյrsegɵС,ѶһҪpurgerseg*/
+	mutex_t			bh_mutex;			/*ib_bh*/
 };
 
 UNIV_INLINE fil_addr_t			trx_purge_get_log_from_hist(fil_addr_t node_addr);
@@ -59,6 +92,8 @@ void							trx_purge_rec_release(trx_undo_inf_t* cell);
 
 ulint							trx_purge();
 
+ulint							trx_purge_get_lag();
+
 void							trx_purge_sys_print();
 
 #include "trx0purge.inl"
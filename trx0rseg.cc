@@ -70,6 +70,7 @@ static trx_rseg_t* trx_rseg_mem_create(ulint id, ulint space, ulint page_no, mtr
 	trx_ulogf_t*	undo_log_hdr;
 	fil_addr_t		node_addr;
 	ulint			sum_of_undo_sizes;
+	ulint			len;
 
 	ut_ad(mutex_own(&kernel_mutex));
 
@@ -90,7 +91,9 @@ static trx_rseg_t* trx_rseg_mem_create(ulint id, ulint space, ulint page_no, mtr
 	sum_of_undo_sizes = trx_undo_lists_init(rseg);
 	rseg->curr_size = mtr_read_ulint(rseg_header + TRX_RSEG_HISTORY_SIZE, MLOG_4BYTES, mtr) + 1 + sum_of_undo_sizes;
 
-	if(flst_get_len(rseg_header + TRX_RSEG_HISTORY, mtr) > 0){
+	len = flst_get_len(rseg_header + TRX_RSEG_HISTORY, mtr);
+	if(len > 0){
+		trx_sys->rseg_history_len += len;
 		node_addr = trx_purge_get_log_from_hist(flst_get_last(rseg_header + TRX_RSEG_HISTORY, mtr));
 		rseg->last_page_no = node_addr.page;
 		rseg->last_offset = node_addr.boffset;
@@ -147,5 +150,33 @@ trx_rseg_t* trx_rseg_create(ulint space, ulint max_size, ulint* id, mtr_t* mtr)
 	return rseg;
 }
 
+/*ϵͳռвrollback segment,ֱrsegﵽn_rsegs,صǰrsegĸ*/
+ulint trx_rseg_create_rsegs(ulint n_rsegs)
+{
+	trx_rseg_t*	rseg;
+	ulint		id;
+	ulint		n_created = 0;
+	mtr_t		mtr;
+
+	n_rsegs = ut_min(n_rsegs, TRX_SYS_N_RSEGS);
 
+	while(UT_LIST_GET_LEN(trx_sys->rseg_list) < n_rsegs){
+		mtr_start(&mtr);
+		rseg = trx_rseg_create(TRX_SYS_SPACE, ULINT_MAX, &id, &mtr);
+		mtr_commit(&mtr);
+
+		if(rseg == NULL){ /*ûпеslot߱ռ䲻*/
+			fprintf(stderr, "InnoDB: Warning: could only create %lu of %lu rollback segments\n",
+				UT_LIST_GET_LEN(trx_sys->rseg_list), n_rsegs);
+			break;
+		}
 
+		n_created ++;
+	}
+
+	if(n_created > 0)
+		fprintf(stderr, "InnoDB: Created %lu new rollback segment(s), %lu in total\n",
+			n_created, UT_LIST_GET_LEN(trx_sys->rseg_list));
+
+	return UT_LIST_GET_LEN(trx_sys->rseg_list);
+}
@@ -72,6 +72,8 @@ void								trx_rseg_list_and_array_init(trx_sysf_t* sys_header, mtr_t* mtr);
 
 trx_rseg_t*							trx_rseg_create(ulint space, ulint max_size, ulint* id, mtr_t* mtr);
 
+ulint								trx_rseg_create_rsegs(ulint n_rsegs);
+
 #include "trx0rseg.inl"
 #endif
 
@@ -9,6 +9,8 @@
 #include "trx0purge.h"
 #include "log0log.h"
 #include "os0file.h"
+#include "read0read.h"
+#include "ut0mem.h"
 
 
 trx_sys_t*			trx_sys = NULL;
@@ -33,26 +35,53 @@ ibool trx_doublewrite_page_inside(ulint page_no)
 	return FALSE;
 }
 
+/*flush_typeӦdoublewrite slot,LRU batchblock1,flush list͵ҳˢblock2*/
+trx_doublewrite_slot_t* trx_doublewrite_get_slot(ulint flush_type)
+{
+	ut_ad(trx_doublewrite != NULL);
+
+	if(flush_type == BUF_FLUSH_LRU)
+		return &(trx_doublewrite->slots[TRX_DOUBLEWRITE_SLOT_LRU]);
+
+	return &(trx_doublewrite->slots[TRX_DOUBLEWRITE_SLOT_LIST]);
+}
+
 /*ݿʱʼdoublewrite*/
 static void trx_doublewrite_init(byte* doublewrite)
 {
+	trx_doublewrite_slot_t*	slot;
+	ulint					i;
+
 	trx_doublewrite = mem_alloc(sizeof(trx_doublewrite_t));
 
 	os_do_not_call_flush_at_each_write = TRUE;
 
-	mutex_create(&(trx_doublewrite->mutex));
-	mutex_set_level(&(trx_doublewrite->mutex), SYNC_DOUBLEWRITE);
-
-	trx_doublewrite->first_free = 0;
 	/*ȡĵһpage_no*/
 	trx_doublewrite->block1 = mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK1);
 	trx_doublewrite->block2 = mach_read_from_4(doublewrite + TRX_SYS_DOUBLEWRITE_BLOCK2);
-	/*ڳĶϷdoublewriteĿռ䣬buffer pool*/
-	trx_doublewrite->write_buf_unaligned =  ut_malloc((1 + 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) * UNIV_PAGE_SIZE);
-	/*ַ룬Է*/
-	trx_doublewrite->write_buf = ut_align(trx_doublewrite->write_buf_unaligned, UNIV_PAGE_SIZE);
 
-	trx_doublewrite->buf_block_arr = mem_alloc(2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * sizeof(void*));
+	for(i = 0; i < TRX_DOUBLEWRITE_N_SLOTS; i ++){
+		slot = &(trx_doublewrite->slots[i]);
+
+		/*ͬһʱһֻ߳һslotmutex*/
+		mutex_create(&(slot->mutex));
+		mutex_set_level(&(slot->mutex), SYNC_DOUBLEWRITE);
+
+		slot->page_no = (i == 0) ? trx_doublewrite->block1 : trx_doublewrite->block2;
+		slot->first_free = 0;
+		/*ڳĶϷdoublewriteĿռ䣬buffer pool*/
+		slot->write_buf_unaligned = ut_malloc((1 + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) * UNIV_PAGE_SIZE);
+		/*ַ룬Է*/
+		slot->write_buf = ut_align(slot->write_buf_unaligned, UNIV_PAGE_SIZE);
+		slot->buf_block_arr = mem_alloc(TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * sizeof(void*));
+
+		slot->n_pending = 0;
+		/*buf_pool->mutex֮ڻ,治ٻlatch*/
+		mutex_create(&(slot->pending_mutex));
+		mutex_set_level(&(slot->pending_mutex), SYNC_NO_ORDER_CHECK);
+		slot->write_done = os_event_create(NULL);
+		os_event_set(slot->write_done);
+	}
 }
 
 void trx_sys_create_doublewrite_buf()
@@ -158,6 +187,7 @@ start_again:
 void trx_sys_doublewrite_restore_corrupt_pages()
 {
 	byte*	buf;
+	byte*	unaligned_buf;
 	byte*	read_buf;
 	byte*	unaligned_read_buf;
 	ulint	block1;
@@ -172,6 +202,9 @@ void trx_sys_doublewrite_restore_corrupt_pages()
 	unaligned_read_buf = ut_malloc(2 * UNIV_PAGE_SIZE);
 	read_buf = ut_align(unaligned_read_buf, UNIV_PAGE_SIZE);
 
+	unaligned_buf = ut_malloc((1 + 2 * TRX_SYS_DOUBLEWRITE_BLOCK_SIZE) * UNIV_PAGE_SIZE);
+	buf = ut_align(unaligned_buf, UNIV_PAGE_SIZE);
+
 	fil_io(OS_FILE_READ, TRUE, TRX_SYS_SPACE, TRX_SYS_PAGE_NO, 0, UNIV_PAGE_SIZE, read_buf, NULL);
 
 	doublewrite = read_buf + TRX_SYS_DOUBLEWRITE;
@@ -191,12 +224,19 @@ void trx_sys_doublewrite_restore_corrupt_pages()
 		buf + TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * UNIV_PAGE_SIZE, NULL);
 
 	page = buf;
-	/*doublewriteд洢pageӦıռǷdoublewriteҳͬд뵽ռ*/
+	/*doublewriteд洢pageӦıռǷdoublewriteҳͬд뵽ռС
+	doublewriteеҳҲҪͨchecksumУ:ܷdoublewriteдĹ,ʱռҳûб*/
 	for(i = 0; i < TRX_SYS_DOUBLEWRITE_BLOCK_SIZE * 2; i++){
 		space_id = mach_read_from_4(page + FIL_PAGE_SPACE);
 		page_no = mach_read_from_4(page + FIL_PAGE_OFFSET);
 
-		if (!fil_check_adress_in_tablespace(space_id, page_no)) { /*(space_id, page_no)κεıռ䣬ܴݷ˴*/
+		if(buf_page_is_corrupted(page)){ /*doublewriteеҳдһҳ,ָ*/
+			fprintf(stderr,
+				"InnoDB: Warning: the %lu'th page in the doublewrite buffer is corrupt,\n"
+				"InnoDB: space id %lu page number %lu. Ignoring it.\n",
+				i, space_id, page_no);
+		}
+		else if (!fil_check_adress_in_tablespace(space_id, page_no)) { /*(space_id, page_no)κεıռ䣬ܴݷ˴*/
 			fprintf(stderr,
 				"InnoDB: Warning: an inconsistent page in the doublewrite buffer\n"
 				"InnoDB: space id %lu page number %lu, %lu'th page in dblwr buf.\n",
@@ -212,12 +252,6 @@ void trx_sys_doublewrite_restore_corrupt_pages()
 					"InnoDB: Warning: database page corruption or a failed\n"
 					"InnoDB: file read of page %lu.\n", page_no);
 				fprintf(stderr, "InnoDB: Trying to recover it from the doublewrite buffer.\n");
-				/*doublewriteӦҳҲpage޷ָ*/
-				if (buf_page_is_corrupted(page)){
-					fprintf(stderr, "InnoDB: Also the page in the doublewrite buffer is corrupt.\n"
-						"InnoDB: Cannot continue operation.\n");
-					exit(1);
-				}
 				/*doublewriteеpageд뵽ӦռУ滻ԭҳ*/
 				fil_io(OS_FILE_WRITE, TRUE, space_id, page_no, 0, UNIV_PAGE_SIZE, page, NULL);
 
@@ -231,6 +265,7 @@ void trx_sys_doublewrite_restore_corrupt_pages()
 	fil_flush_file_spaces(FIL_TABLESPACE);
 
 leave_func:
+	ut_free(unaligned_buf);
 	ut_free(unaligned_read_buf);
 }
 
@@ -360,6 +395,76 @@ void trx_sys_print_mysql_master_log_pos(void)
 	mtr_commit(&mtr);
 }
 
+/*active_ids˱仯,Ŀ,Ѿread viewӰ*/
+UNIV_INLINE void trx_sys_invalidate_view_snap()
+{
+	if(trx_sys->view_snap != NULL){
+		read_view_snap_release(trx_sys->view_snap);
+		trx_sys->view_snap = NULL;
+	}
+}
+
+/*TRX_ACTIVE״̬ʱ,id˳trx_sys->active_ids*/
+void trx_sys_add_active_id(dulint id)
+{
+	dulint*	ids;
+	ulint	i;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	if(trx_sys->n_active_ids == trx_sys->active_ids_size){ /*,һ*/
+		ids = ut_malloc(2 * trx_sys->active_ids_size * sizeof(dulint));
+		ut_memcpy(ids, trx_sys->active_ids, trx_sys->n_active_ids * sizeof(dulint));
+		ut_free(trx_sys->active_ids);
+
+		trx_sys->active_ids = ids;
+		trx_sys->active_ids_size *= 2;
+	}
+
+	/*id,һֱ׷ĩβ*/
+	ids = trx_sys->active_ids;
+	for(i = trx_sys->n_active_ids; i > 0 && ut_dulint_cmp(ids[i - 1], id) > 0; i--)
+		ids[i] = ids[i - 1];
+
+	ids[i] = id;
+	trx_sys->n_active_ids ++;
+
+	trx_sys_invalidate_view_snap();
+}
+
+/*뿪TRX_ACTIVE״̬ʱ,idtrx_sys->active_idsɾ*/
+void trx_sys_remove_active_id(dulint id)
+{
+	dulint*	ids;
+	ulint	low;
+	ulint	high;
+	ulint	mid;
+	int		cmp;
+
+	ut_ad(mutex_own(&kernel_mutex));
+
+	ids = trx_sys->active_ids;
+	low = 0;
+	high = trx_sys->n_active_ids;
+	for(;;){
+		ut_a(low < high);
+
+		mid = (low + high) / 2;
+		cmp = ut_dulint_cmp(id, ids[mid]);
+		if(cmp == 0)
+			break;
+		else if(cmp < 0)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	ut_memmove(ids + mid, ids + mid + 1, (trx_sys->n_active_ids - mid - 1) * sizeof(dulint));
+	trx_sys->n_active_ids --;
+
+	trx_sys_invalidate_view_snap();
+}
+
 /*trx_sysҵһеrollback segmentslotλ*/
 ulint trx_sysf_rseg_find_free(mtr_t* mtr)
 {
@@ -416,7 +521,7 @@ static void trx_sysf_create(mtr_t* mtr)
 void trx_sys_init_at_db_start()
 {
 	trx_sysf_t*	sys_header;
-	mtr_t*		mtr;
+	mtr_t		mtr;
 
 	mtr_start(&mtr);
 
@@ -424,6 +529,16 @@ void trx_sys_init_at_db_start()
 	mutex_enter(&kernel_mutex);
 
 	trx_sys = mem_alloc(sizeof(trx_sys_t));
+	trx_sys->rseg_history_len = 0;
+	/*ڸrsegmutex֮ڻ,治ٻlatch*/
+	mutex_create(&(trx_sys->rseg_history_mutex));
+	mutex_set_level(&(trx_sys->rseg_history_mutex), SYNC_NO_ORDER_CHECK);
+
+	trx_sys->active_ids_size = TRX_SYS_ACTIVE_IDS_INIT_SIZE;
+	trx_sys->active_ids = ut_malloc(trx_sys->active_ids_size * sizeof(dulint));
+	trx_sys->n_active_ids = 0;
+	trx_sys->view_snap = NULL;
+	UT_LIST_INIT(trx_sys->no_list);
 	sys_header = trx_sysf_get(&mtr);
 	/*ʼrseg object list*/
 	trx_rseg_list_and_array_init(sys_header, &mtr);
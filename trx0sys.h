@@ -17,6 +17,9 @@
 #include "read0types.h"
 
 /***********************MACRO********************************************/
+/*trx_sys->active_idsĳʼ*/
+#define TRX_SYS_ACTIVE_IDS_INIT_SIZE	1024
+
 /*Ĭϵrollback segment idֵ*/
 #define TRX_SYS_SYSTEM_RSEG_ID			0
 
@@ -59,16 +62,32 @@
 
 #define TRX_SYS_TRX_ID_WRITE_MARGIN	256
 
-struct trx_doublewrite_struct
+/*doublewriteslot,ÿslotռһdoublewrite block,LRU batchflush list batchʹòͬslot,*/
+#define TRX_DOUBLEWRITE_N_SLOTS		2
+#define TRX_DOUBLEWRITE_SLOT_LRU	0
+#define TRX_DOUBLEWRITE_SLOT_LIST	1
+
+struct trx_doublewrite_slot_struct
 {
 	mutex_t		mutex;
-	ulint		block1;			/*һdoublewirte blockʼҳpage_no*/
-	ulint		block2;			/*ڶdoublewirte blockʼҳpage_no*/
+	ulint		page_no;		/*slotϵͳռжӦʼҳ*/
 	ulint		first_free;		/*write bufferĵһλãpage_sizeΪλƫ*/
 	byte*		write_buf;
 	byte*		write_buf_unaligned;
 
 	buf_block_t** buf_block_arr;
+
+	ulint		n_pending;		/*Ѿύ첽дûɵҳ*/
+	mutex_t		pending_mutex;	/*ûԭӲʱn_pending*/
+	os_event_t	write_done;		/*n_pendingΪ0ʱset*/
+};
+
+struct trx_doublewrite_struct
+{
+	ulint		block1;			/*һdoublewirte blockʼҳpage_no*/
+	ulint		block2;			/*ڶdoublewirte blockʼҳpage_no*/
+
+	trx_doublewrite_slot_t slots[TRX_DOUBLEWRITE_N_SLOTS];
 };
 
 struct trx_sys_struct
@@ -82,6 +101,15 @@ struct trx_sys_struct
 
 	trx_rseg_t*					latest_rseg;
 	trx_rseg_t*					rseg_array[TRX_SYS_N_RSEGS];
+
+	ulint						rseg_history_len;	/*rseg history listлδpurgeundo log*/
+	mutex_t						rseg_history_mutex;	/*ûԭӲʱrseg_history_len*/
+
+	dulint*						active_ids;			/*TRX_ACTIVE״̬id,С*/
+	ulint						n_active_ids;
+	ulint						active_ids_size;	/*active_ids*/
+	read_view_snap_t*			view_snap;			/*active_idsһεĿ,active_ids仯ʱΪNULL*/
+	UT_LIST_BASE_NODE_T(trx_t)	no_list;			/*Ѿtrx->noTRX_ACTIVE״̬,noС*/
 };
 
 /****************ȫֱ***********/
@@ -100,12 +128,18 @@ void						trx_sys_doublewrite_restore_corrupt_pages();
 
 ibool						trx_doublewrite_page_inside(ulint page_no);
 
+trx_doublewrite_slot_t*		trx_doublewrite_get_slot(ulint flush_type);
+
 UNIV_INLINE ibool			trx_sys_hdr_page(ulint space, ulint page_no);
 
 void						trx_sys_init_at_db_start();
 
 void						trx_sys_create();
 
+void						trx_sys_add_active_id(dulint id);
+
+void						trx_sys_remove_active_id(dulint id);
+
 ulint						trx_sysf_rseg_find_free(mtr_t* mtr);
 
 UNIV_INLINE trx_rseg_t*		trx_sys_get_nth_rseg(trx_sys_t* sys, ulint n);
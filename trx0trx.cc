@@ -92,6 +92,7 @@ trx_t* trx_create(sess_t* sess)
 
 	trx->has_dict_foreign_key_check_lock = FALSE;
 	trx->has_search_latch = FALSE;
+	trx->search_latch = NULL;
 	trx->search_latch_timeout = BTR_SEA_TIMEOUT;
 
 	trx->declared_to_be_inside_innodb = FALSE;
@@ -150,7 +151,7 @@ trx_t* trx_allocate_for_background()
 void trx_search_latch_release_if_reserved(trx_t* trx)
 {
 	if(trx->has_search_latch){
-		rw_lock_s_unlock(&btr_search_latch);
+		rw_lock_s_unlock(trx->search_latch);
 		trx->has_search_latch = FALSE;
 	}
 }
@@ -311,7 +312,7 @@ void trx_lists_init_at_db_start()
 				}
 				else{
 					trx->conc_state = TRX_ACTIVE;
-					trx_no = ut_dulnt_max;
+					trx->no = ut_dulint_max;
 				}
 
 				trx->rseg = rseg;
@@ -333,6 +334,15 @@ void trx_lists_init_at_db_start()
 		}
 		rseg = UT_LIST_GET_NEXT(rseg_list, rseg);
 	}
+
+	/*ָactiveҲҪtrx_sys->active_ids,trx_listidӴС,βʼ*/
+	trx = UT_LIST_GET_LAST(trx_sys->trx_list);
+	while(trx != NULL){
+		if(trx->conc_state == TRX_ACTIVE)
+			trx_sys_add_active_id(trx->id);
+
+		trx = UT_LIST_GET_PREV(trx_list, trx);
+	}
 }
 
 /*Ϊһroll segmentѯʽѯtrx_sys->rseg_list,һηroll segmentһnodeʼ
@@ -365,7 +375,7 @@ ibool trx_start_low(trx_t* trx, ulint rseg_id)
 	
 	/*PURGE trxֱӼͿ*/
 	if(trx->type == TRX_PURGE){
-		trx->id = ut_ulint_zero;
+		trx->id = ut_dulint_zero;
 		trx->conc_state = TRX_ACTIVE;
 		trx->start_time = time(NULL);
 
@@ -378,12 +388,13 @@ ibool trx_start_low(trx_t* trx, ulint rseg_id)
 		rseg_id = trx_assign_rseg();
 	rseg = trx_sys_get_nth_rseg(trx_sys, rseg_id);
 
-	trx_id = trx_sys_get_new_trx_id();
+	trx->id = trx_sys_get_new_trx_id();
 	trx->no = ut_dulint_max;
 	trx->rseg = rseg;
 
 	trx->conc_state = TRX_ACTIVE;
 	trx->start_time = time(NULL);
+	trx_sys_add_active_id(trx->id);
 
 	/*뵽trx_systrx_listͷ*/
 	UT_LIST_ADD_FIRST(trx_list, trx_sys->trx_list, trx);
@@ -416,7 +427,7 @@ void trx_commit_off_kernel(trx_t* trx)
 	ut_ad(mutex_own(&kernel_mutex));
 
 	rseg = trx->rseg;
-	if(trx->insert_undo != NULL && trx->update_undo != NULL){ /*޸˼¼pageflush log*/
+	if(trx->insert_undo != NULL || trx->update_undo != NULL){ /*޸˼¼pageflush log*/
 		mutex_exit(&kernel_mutex);
 
 		mtr_start(&mtr);
@@ -433,6 +444,8 @@ void trx_commit_off_kernel(trx_t* trx)
 		if(undo != NULL){
 			mutex_enter(&kernel_mutex);
 			trx->no = trx_sys_get_new_trx_no();
+			/*trx noǵ,ֱӼno_listĩβ*/
+			UT_LIST_ADD_LAST(no_list, trx_sys->no_list, trx);
 			mutex_exit(&kernel_mutex);
 
 			update_hdr_page = trx_undo_set_state_at_finish(trx, undo, &mtr);
@@ -440,7 +453,7 @@ void trx_commit_off_kernel(trx_t* trx)
 			trx_undo_update_cleanup(trx, update_hdr_page, &mtr);
 		}
 
-		mutex_exit(&(reg->mutex));
+		mutex_exit(&(rseg->mutex));
 
 		/*ϲmysql binlog޸*/
 		if (trx->mysql_log_file_name) {
@@ -465,6 +478,9 @@ void trx_commit_off_kernel(trx_t* trx)
 	ut_ad(mutex_own(&kernel_mutex));
 
 	trx->conc_state = TRX_COMMITTED_IN_MEMORY;
+	trx_sys_remove_active_id(trx->id);
+	if(ut_dulint_cmp(trx->no, ut_dulint_max) != 0)
+		UT_LIST_REMOVE(no_list, trx_sys->no_list, trx);
 
 	/*ͷűе*/
 	lock_release_off_kernel(trx);
@@ -528,6 +544,8 @@ read_view_t* trx_assign_read_view(trx_t* trx)
 		trx->read_view = read_view_open_now(trx, trx->read_view_heap);
 
 	mutex_exit(&kernel_mutex);
+
+	return trx->read_view;
 }
 
 /*ύһ񣬲صTRX_SIG_COMMITɾ*/
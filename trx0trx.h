@@ -16,6 +16,7 @@ Created 3/26/1996 Heikki Tuuri
 #include "que0types.h"
 #include "mem0mem.h"
 #include "read0types.h"
+#include "sync0rw.h"
 
 extern ulint	trx_n_mysql_transactions;
 
@@ -351,6 +352,9 @@ struct trx_struct
 					/* TRUE if the trx currently holds
 					an s-lock on dict_foreign_... */
     ibool           has_search_latch; /* TRUE if this trx has latched the search system latch in S-mode */
+	rw_lock_t*		search_latch;	/* the adaptive hash index partition
+					latch held when has_search_latch
+					is TRUE */
 	ulint			search_latch_timeout;
 					/* If we notice that someone is
 					waiting for our S-lock on the search
@@ -380,6 +384,9 @@ struct trx_struct
                                         of a duplicate key error */
 	UT_LIST_NODE_T(trx_t) trx_list;	/* list of transactions */
 	UT_LIST_NODE_T(trx_t) mysql_trx_list;	/* list of transactions created for MySQL */
+	UT_LIST_NODE_T(trx_t) no_list;	/* list of active transactions which
+					already have a serialization number,
+					see trx_sys->no_list */
 
 	mutex_t			undo_mutex;	/* mutex protecting the fields in this
 					section (down to undo_no_arr), EXCEPT
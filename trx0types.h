@@ -8,12 +8,15 @@
 typedef struct trx_struct				trx_t;
 typedef struct trx_sys_struct			trx_sys_t;
 typedef struct trx_doublewrite_struct	trx_doublewrite_t;
+typedef struct trx_doublewrite_slot_struct	trx_doublewrite_slot_t;
 typedef struct trx_sig_struct			trx_sig_t;
 typedef struct trx_rseg_struct			trx_rseg_t;
 typedef struct trx_undo_struct			trx_undo_t;
 typedef struct trx_undo_arr_struct		trx_undo_arr_t;
 typedef struct trx_undo_inf_struct		trx_undo_inf_t;
 typedef struct trx_purge_struct			trx_purge_t;
+typedef struct trx_purge_rec_struct		trx_purge_rec_t;
+typedef struct trx_purge_rseg_struct		trx_purge_rseg_t;
 typedef struct roll_node_struct			roll_node_t;
 typedef struct commit_node_struct		commit_node_t;
 
@@ -3,7 +3,7 @@
 
 #include "univ.h"
 
-UNIV_INTERNvoid ut_crc32_init();
+UNIV_INTERN void ut_crc32_init();
 
 typedef ib_uint32_t (*ib_ut_crc32_t)(const byte* ptr, ulint len);
 
@@ -70,76 +70,60 @@ UNIV_INTERN void ib_bh_free(ib_bh_t* ib_bh)
 {
 	ut_free(ib_bh);
 }
-/*õǶֲҷӶlogN,ֻѭĸӶȡĸӶȡcompareib_bh_setֵֵӶ*/
+/*һԪ,һλÿʼϵ,elemĸڵ,ӶlogN*/
 UNIV_INTERN void* ib_bh_push(ib_bh_t* ib_bh, const void* elem)
 {
-	void* ptr;
+	void*	ptr;
+	ulint	i;
 
 	if(ib_bh_is_full(ib_bh))
 		return NULL;
-	else if(ib_bh_is_empty(ib_bh)){
-		ib_bh->n_elems ++;
-		return ib_bh_set(ib_bh, 0, ptr);
-	}
-	else{
-		ulint i;
-		i = ib_bh->n_elems;
-		++ib_bh->n_elems;
 
-		for(ptr = ib_bh_get(ib_bh, i >> 1); i > 0 && ib_bh->compare(ptr, elem) > 0; i >>= 1, ptr = ib_bh_get(ib_bh, i >> 1)){
-			ib_bh_set(ib_bh, i, ptr);
-		}
-		/*ѭӦõͬ´:
-		ptr = ib_bh_get(ib_bh, i >> 1);
-		while(i > 0 && ib_bh->compare(ptr, elem) > 0){
-			ib_bh_set(ib_bh, i, ptr);
-			i >>= 1;
-			ptr = ib_bh_get(ib_bh, i >> 1);
-		}
-		*/
-		ptr = ib_bh_set(ib_bh, i, elem);
+	i = ib_bh->n_elems ++;
+	while(i > 0){
+		ptr = ib_bh_get(ib_bh, (i - 1) >> 1);
+		if(ib_bh->compare(ptr, elem) <= 0)
+			break;
+
+		ib_bh_set(ib_bh, i, ptr);
+		i = (i - 1) >> 1;
 	}
+
+	return ib_bh_set(ib_bh, i, elem);
 }
 
+/*ɾѶ(С)Ԫ,һԪطŵѶµ,ÿκͽСӽڵ㽻*/
 UNIV_INTERN void ib_bh_pop(ib_bh_t* ib_bh)
 {
-	byte* ptr;
-	byte* last;
-	ulint parent = 0;
+	byte*	ptr;
+	byte*	last;
+	ulint	parent;
+	ulint	child;
+	ulint	n;
 
 	if(ib_bh_is_empty(ib_bh))
 		return;
-	else if(ib_bh_size(ib_bh) == 1){
-		--ib_bh->n_elems;
-		return;
-	}
 
-	last = (byte *)ib_bh_last(ib_bh);
-	ptr = (byte*)ib_bh_get(ib_bh, 1);
+	last = (byte*)ib_bh_last(ib_bh);
+	n = ib_bh_size(ib_bh) - 1; /*ȥlast֮ʣµԪظ*/
 
-	/*LASTλãСֵŵheapǰ,Ƚ1±λ0λãȻʣС1һ*/
-	while(ptr < last){
-		if(ib_bh->compare(ptr + ib_bh->sizeof_elem, ptr) < 0)
+	parent = 0;
+	for(child = 1; child < n; child = (parent << 1) + 1){
+		ptr = (byte*)ib_bh_get(ib_bh, child);
+		if(child + 1 < n && ib_bh->compare(ptr + ib_bh->sizeof_elem, ptr) < 0){
 			ptr += ib_bh->sizeof_elem;
+			child ++;
+		}
 
 		if(ib_bh->compare(last, ptr) <= 0)
 			break;
 
 		ib_bh_set(ib_bh, parent, ptr);
-
-		parent = (ptr - (byte*)ib_bh_first(ib_bh)) / ib_bh->sizeof_elem;
-
-		if((parent << 1) >= ib_bh_size(ib_bh))
-			break;
-		/*һ*/
-		ptr = (byte *)ib_bh_get(ib_bh, parent << 1);
+		parent = child;
 	}
 
-	--ib_bh->n_elems;
-	ib_bh_set(ib_bh, parent, last);
-}
-
-
-
-
+	if(parent < n)
+		ib_bh_set(ib_bh, parent, last);
 
+	ib_bh->n_elems = n;
+}
@@ -3,7 +3,7 @@
 UNIV_INTERN ib_list_t* ib_list_create()
 {
 	ib_list_t* list;
-	list = static_cast<ib_list_t*>mem_alloc(sizeof(ib_list_t));
+	list = static_cast<ib_list_t*>(mem_alloc(sizeof(ib_list_t)));
 	list->first = NULL;
 	list->last = NULL;
 	list->is_heap_list = FALSE;
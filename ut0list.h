@@ -4,6 +4,8 @@
 #include "univ.h"
 #include "mem0mem.h"
 
+struct ib_list_node_t;
+
 /*listṹ*/
 struct ib_list_t
 {
@@ -84,8 +84,6 @@ UNIV_INTERN ib_rbt_node_t* rbt_remove_node(ib_rbt_t* tree, const ib_rbt_node_t*
 
 UNIV_INTERN const ib_rbt_node_t* rbt_insert(ib_rbt_t* tree, const void* key, const void* value);
 
-UNIV_INTERN CONST ib_rbt_node_t* rbt_insert(ib_rbt_t* tree, const void* key, const void* value);
-
 UNIV_INTERN const ib_rbt_node_t* rbt_first(const ib_rbt_t* tree);
 
 UNIV_INTERN const ib_rbt_node_t* rbt_last(const ib_rbt_t* tree);
@@ -105,7 +103,7 @@ UNIV_INTERN int rbt_search_cmp(const ib_rbt_t* tree, ib_rbt_bound_t* parent, con
 
 UNIV_INTERN void rbt_clear(ib_rbt_t* tree);
 
-UNIV_INTERN ulint rbt_merge_uniq(ib_rbt_t* dst, const ib_dst_t* src);
+UNIV_INTERN ulint rbt_merge_uniq(ib_rbt_t* dst, const ib_rbt_t* src);
 
 UNIV_INTERN ulint rbt_merge_uniq_destructive(ib_rbt_t* dst, ib_rbt_t* src);
 
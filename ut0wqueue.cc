@@ -1,35 +1,40 @@
 #include "ut0wqueue.h"
 
-UNIV_INTERN ib_queue_create()
+UNIV_INTERN ib_wqueue_t* ib_wqueue_create()
 {
-	ib_wqueue_t* wq = static_cast<ib_wqueue_t*>(mem_alloc(sizeof(ib_wqueue_t)));
+	ib_wqueue_t* wq = (ib_wqueue_t*)mem_alloc(sizeof(ib_wqueue_t));
 
-	/*mutex, SYNC_WORK_QUEUEinnodbڲmutex*/
-	mutex_create(PFS_NOT_INSTRUMENTED, &wq->mutex, SYNC_WORK_QUEUE);
+	/*mutex*/
+	mutex_create(&(wq->mutex));
+	mutex_set_level(&(wq->mutex), SYNC_NO_ORDER_CHECK);
 	/*һib list*/
 	wq->items = ib_list_create();
 	/*һϵͳź*/
-	wq->event = os_event_create();
+	wq->event = os_event_create(NULL);
+
+	return wq;
 }
 
 UNIV_INTERN void ib_wqueue_free(ib_wqueue_t* wq)
 {
-	mutex_free(wq->mutex);
+	ut_a(ib_list_is_empty(wq->items));
+
+	mutex_free(&(wq->mutex));
 	ib_list_free(wq->items);
 	os_event_free(wq->event);
 
 	mem_free(wq);
 }
 
-UNIV_INTERN void ib_wqueue_add(ib_wqueue_t wq, void* item, mem_heap_t* heap)
+UNIV_INTERN void ib_wqueue_add(ib_wqueue_t* wq, void* item, mem_heap_t* heap)
 {
-	mutex_enter(&wq->mutex);
+	mutex_enter(&(wq->mutex));
 
 	ib_list_add_last(wq->items, item, heap);
 	/*źŸϢ߳*/
 	os_event_set(wq->event);
 
-	mutex_exit(&wq->mutex);
+	mutex_exit(&(wq->mutex));
 }
 
 UNIV_INTERN void* ib_wqueue_wait(ib_wqueue_t* wq)
@@ -39,57 +44,55 @@ UNIV_INTERN void* ib_wqueue_wait(ib_wqueue_t* wq)
 	for(;;){ /*ȡqueue״̬һϢݲ˳ѭ*/
 		os_event_wait(wq->event);
 
-		mutex_enter(&wq->mutex);
-		node = ib_list_get_first();
+		mutex_enter(&(wq->mutex));
+		node = ib_list_get_first(wq->items);
 		if(node != NULL){ /*ȡһϢ*/
-
 			ib_list_remove(wq->items, node);
-			if(!ib_list_get_first(wq->items)){
+			if(ib_list_get_first(wq->items) == NULL)
 				os_event_reset(wq->event); /*queueûϢˣõȴź*/
-			}
 			break;
 		}
-		mutex_exit(&wq->mutex);
+		mutex_exit(&(wq->mutex));
 	}
 
-	mutex_exit(&wq->mutex);
+	mutex_exit(&(wq->mutex));
 
 	return node->data;
 }
 
-void* ib_wqueue_timedwait(ib_wqueue_t*	wq,	ib_time_t wait_in_usecs)	
+void* ib_wqueue_timedwait(ib_wqueue_t* wq, ulint wait_in_usecs)
 {
 	ib_list_node_t*	node = NULL;
 
-	for (;;) {
-		ulint		error;
-		ib_int64_t	sig_count;
-
-		mutex_enter(&wq->mutex);
+	for(;;){
+		mutex_enter(&(wq->mutex));
 
 		node = ib_list_get_first(wq->items);
-		if (node){
+		if(node != NULL){
 			ib_list_remove(wq->items, node);
+			if(ib_list_get_first(wq->items) == NULL)
+				os_event_reset(wq->event);
 
-			mutex_exit(&wq->mutex);
+			mutex_exit(&(wq->mutex));
 			break;
 		}
-		/*ûȡϢ̣߳õȴź*/
-		sig_count = os_event_reset(wq->event);
+		mutex_exit(&(wq->mutex));
 
-		mutex_exit(&wq->mutex);
-		/*õȴʱ䣬źŵȴ*/
-		error = os_event_wait_time_low(wq->event, (ulint) wait_in_usecs, sig_count);
-
-		if (error == OS_SYNC_TIME_EXCEEDED) /*ȴʱ*/
+		/*õȴʱ䣬źŵȴ, addڳmutexʱset event,Բᶪʧź*/
+		if(os_event_wait_time(wq->event, wait_in_usecs) == OS_SYNC_TIME_EXCEEDED) /*ȴʱ*/
 			break;
 	}
 
-	return(node ? node->data : NULL);
+	return (node != NULL ? node->data : NULL);
 }
 
-ibool ib_wqueue_is_empty(const ib_wqueue_t* wq)
+ibool ib_wqueue_is_empty(ib_wqueue_t* wq)
 {
-	return ib_list_is_empty(wq->items);
-}
+	ibool is_empty;
 
+	mutex_enter(&(wq->mutex));
+	is_empty = ib_list_is_empty(wq->items);
+	mutex_exit(&(wq->mutex));
+
+	return is_empty;
+}
@@ -1,30 +1,32 @@
 #ifndef __IB_WORK_QUEUE_H
 #define __IB_WORK_QUEUE_H
 
+#include "univ.h"
 #include "ut0list.h"
 #include "mem0mem.h"
 #include "os0sync.h"
-#include "sync0types.h"
+#include "sync0sync.h"
 
+/*һ߶ߵϢ,queueΪʱȴ*/
 struct ib_wqueue_t
 {
-	ib_mutex_t	mutex; /**/
+	mutex_t		mutex; /**/
 	ib_list_t*	items; /*listΪqueue*/
-	os_event_t	event; /*ź*/
+	os_event_t	event; /*ź,queueǿʱΪset״̬*/
 };
 
 UNIV_INTERN ib_wqueue_t* ib_wqueue_create();
 
 UNIV_INTERN void ib_wqueue_free(ib_wqueue_t* wq);
 
+/*itemlistڵheapз,heapitemȡ֮ǰͷ*/
 UNIV_INTERN void ib_wqueue_add(ib_wqueue_t* wq, void* item, mem_heap_t* heap);
 
-ibool ib_wqueue_is_empty(const ib_wqueue_t* wq);
+ibool ib_wqueue_is_empty(ib_wqueue_t* wq);
 
 UNIV_INTERN void* ib_wqueue_wait(ib_wqueue_t* wq);
 
-void* ib_wqueue_timewait(ib_wqueue_t* wq, ib_time_t wait_in_usecs);
-
-
+/*ȴwait_in_usecs΢,ʱNULL*/
+void* ib_wqueue_timedwait(ib_wqueue_t* wq, ulint wait_in_usecs);
 
 #endif